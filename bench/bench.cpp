@@ -0,0 +1,206 @@
+#include "bench.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+
+// --- Allocation counting: every operator new of the process goes through these ---
+
+namespace {
+    std::atomic<uint64_t> g_Allocations{ 0 };
+    std::atomic<uint64_t> g_AllocatedBytes{ 0 };
+
+    void* CountedAlloc(size_t size) {
+        g_Allocations.fetch_add(1, std::memory_order_relaxed);
+        g_AllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+        return std::malloc(size ? size : 1);
+    }
+
+    void* CountedAlignedAlloc(size_t size, std::align_val_t alignment) {
+        g_Allocations.fetch_add(1, std::memory_order_relaxed);
+        g_AllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+        size_t align = static_cast<size_t>(alignment);
+#ifdef _WIN32
+        return _aligned_malloc(size ? size : 1, align);
+#else
+        return std::aligned_alloc(align, (std::max<size_t>(size, 1) + align - 1) / align * align);
+#endif
+    }
+
+    void AlignedFree(void* pointer) {
+#ifdef _WIN32
+        _aligned_free(pointer);
+#else
+        std::free(pointer);
+#endif
+    }
+}
+
+void* operator new(size_t size) {
+    if (void* pointer = CountedAlloc(size)) return pointer;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size) {
+    if (void* pointer = CountedAlloc(size)) return pointer;
+    throw std::bad_alloc();
+}
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return CountedAlloc(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return CountedAlloc(size); }
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, size_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { std::free(pointer); }
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    if (void* pointer = CountedAlignedAlloc(size, alignment)) return pointer;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size, std::align_val_t alignment) {
+    if (void* pointer = CountedAlignedAlloc(size, alignment)) return pointer;
+    throw std::bad_alloc();
+}
+void operator delete(void* pointer, std::align_val_t) noexcept { AlignedFree(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { AlignedFree(pointer); }
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept { AlignedFree(pointer); }
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept { AlignedFree(pointer); }
+
+namespace bench {
+
+AllocationCounts GetAllocationCounts() {
+    AllocationCounts counts;
+    counts.allocations = g_Allocations.load(std::memory_order_relaxed);
+    counts.bytes = g_AllocatedBytes.load(std::memory_order_relaxed);
+    return counts;
+}
+
+std::string FormatNs(double ns) {
+    char text[32];
+    if (ns < 1e3) std::snprintf(text, sizeof(text), "%.1f ns", ns);
+    else if (ns < 1e6) std::snprintf(text, sizeof(text), "%.2f us", ns / 1e3);
+    else if (ns < 1e9) std::snprintf(text, sizeof(text), "%.2f ms", ns / 1e6);
+    else std::snprintf(text, sizeof(text), "%.2f s", ns / 1e9);
+    return text;
+}
+
+bool Runner::IsSelected(const std::string& name) const {
+    return m_Settings.filter.empty() || name.find(m_Settings.filter) != std::string::npos;
+}
+
+void Runner::Record(const std::string& name, uint64_t iterations, std::vector<double>& samples,
+                    const AllocationCounts& before, const AllocationCounts& after, double itemsPerOp) {
+    Result result;
+    result.name = name;
+    result.iterations = iterations;
+    result.itemsPerOp = itemsPerOp;
+    if (!samples.empty()) {
+        std::sort(samples.begin(), samples.end());
+        auto percentile = [&](double p) { return samples[std::min(samples.size() - 1, static_cast<size_t>(p * (samples.size() - 1) + 0.5))]; };
+        double total = 0.0;
+        for (double sample : samples) total += sample;
+        result.meanNs = total / samples.size();
+        double variance = 0.0;
+        for (double sample : samples) variance += (sample - result.meanNs) * (sample - result.meanNs);
+        result.stddevNs = std::sqrt(variance / samples.size());
+        result.minNs = samples.front();
+        result.medianNs = percentile(0.5);
+        result.p95Ns = percentile(0.95);
+
+        double ops = static_cast<double>(iterations) * samples.size();
+        result.allocationsPerOp = (after.allocations - before.allocations) / ops;
+        result.bytesPerOp = (after.bytes - before.bytes) / ops;
+    }
+    m_Results.push_back(result);
+
+    std::printf("%-42s %11s  +-%5.1f%%  min %11s  p95 %11s  %8.1f allocs/op %10.0f B/op",
+                name.c_str(), FormatNs(result.medianNs).c_str(),
+                result.medianNs > 0.0 ? 100.0 * result.stddevNs / result.medianNs : 0.0,
+                FormatNs(result.minNs).c_str(), FormatNs(result.p95Ns).c_str(),
+                result.allocationsPerOp, result.bytesPerOp);
+    if (itemsPerOp > 0.0 && result.medianNs > 0.0) std::printf("  %9.2f M items/s", itemsPerOp / result.medianNs * 1e3);
+    std::printf("\n");
+    std::fflush(stdout);
+}
+
+void Runner::Skip(const std::string& name, const char* reason) {
+    if (!IsSelected(name)) return;
+    std::printf("%-42s skipped: %s\n", name.c_str(), reason);
+}
+
+bool Runner::WriteJson(const std::string& path) const {
+    std::ofstream json(path);
+    if (!json) return false;
+
+    json << "{\n  \"settings\": {\"warmup\": " << m_Settings.warmup << ", \"repetitions\": " << m_Settings.repetitions
+         << ", \"min_repetition_ms\": " << m_Settings.minRepetitionMs << "},\n  \"results\": [\n";
+    for (size_t i = 0; i < m_Results.size(); ++i) {
+        const Result& result = m_Results[i];
+        json << "    {\"name\": \"" << result.name << "\", \"iterations\": " << result.iterations
+             << ", \"median_ns\": " << result.medianNs << ", \"mean_ns\": " << result.meanNs
+             << ", \"min_ns\": " << result.minNs << ", \"p95_ns\": " << result.p95Ns
+             << ", \"stddev_ns\": " << result.stddevNs << ", \"allocs_per_op\": " << result.allocationsPerOp
+             << ", \"bytes_per_op\": " << result.bytesPerOp << ", \"items_per_op\": " << result.itemsPerOp
+             << (i + 1 < m_Results.size() ? "},\n" : "}\n");
+    }
+    json << "  ]\n}\n";
+    return static_cast<bool>(json);
+}
+
+namespace {
+    // Reads "key": number from one result line of a file written by WriteJson
+    bool ReadNumber(const std::string& line, const char* key, double& value) {
+        std::string pattern = std::string("\"") + key + "\": ";
+        size_t at = line.find(pattern);
+        if (at == std::string::npos) return false;
+        value = std::strtod(line.c_str() + at + pattern.size(), nullptr);
+        return true;
+    }
+}
+
+int Runner::Compare(const std::string& baselinePath, double thresholdPercent) const {
+    std::ifstream json(baselinePath);
+    if (!json) return -1;
+
+    struct Baseline {
+        std::string name;
+        double medianNs = 0.0, allocationsPerOp = 0.0;
+    };
+    std::vector<Baseline> baseline;
+    std::string line;
+    while (std::getline(json, line)) {
+        const char* key = "\"name\": \"";
+        size_t at = line.find(key);
+        if (at == std::string::npos) continue;
+        at += std::strlen(key);
+        Baseline entry;
+        entry.name = line.substr(at, line.find('"', at) - at);
+        if (!ReadNumber(line, "median_ns", entry.medianNs)) continue;
+        ReadNumber(line, "allocs_per_op", entry.allocationsPerOp);
+        baseline.push_back(entry);
+    }
+
+    std::printf("\nComparison with %s (threshold %.1f%%)\n", baselinePath.c_str(), thresholdPercent);
+    int regressions = 0;
+    for (const Result& result : m_Results) {
+        auto match = std::find_if(baseline.begin(), baseline.end(), [&](const Baseline& entry) { return entry.name == result.name; });
+        if (match == baseline.end()) {
+            std::printf("%-42s %11s  (not in baseline)\n", result.name.c_str(), FormatNs(result.medianNs).c_str());
+            continue;
+        }
+        double delta = match->medianNs > 0.0 ? 100.0 * (result.medianNs - match->medianNs) / match->medianNs : 0.0;
+        // Allocation counts are deterministic: any extra allocation per op is a regression
+        bool slower = delta > thresholdPercent;
+        bool allocates = result.allocationsPerOp > match->allocationsPerOp + 0.5;
+        const char* status = (slower || allocates) ? "REGRESSION" : delta < -thresholdPercent ? "faster" : "ok";
+        if (slower || allocates) regressions++;
+        std::printf("%-42s %11s -> %11s  %+7.1f%%  %s%s\n", result.name.c_str(), FormatNs(match->medianNs).c_str(),
+                    FormatNs(result.medianNs).c_str(), delta, status,
+                    allocates ? " (more allocations)" : "");
+    }
+    return regressions;
+}
+
+}
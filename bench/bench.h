@@ -0,0 +1,115 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Micro-benchmark harness for rampage_bench.
+//
+// Runner::Run(name, op) times one operation in isolation: the iteration count is doubled until
+// a repetition lasts at least the minimum time, then the op runs for the warmup repetitions and
+// the measured ones. Each result keeps the per-op time of every repetition (summarized as min,
+// median, mean, p95 and standard deviation) and the heap allocations made while measuring,
+// counted by the global operator new that bench.cpp replaces.
+//
+// Results are written as JSON (one result object per line) and a previous JSON file can be used
+// as the baseline: ops whose median got slower than the threshold, or that allocate more, are
+// reported as regressions.
+
+namespace bench {
+    struct Settings {
+        int warmup = 2;               // repetitions run before measuring
+        int repetitions = 10;         // measured repetitions
+        double minRepetitionMs = 20.0; // calibration target for one repetition
+        std::string filter;           // substring of the names to run (empty = all)
+    };
+
+    struct Result {
+        std::string name;
+        uint64_t iterations = 0; // ops per repetition
+        double minNs = 0.0, medianNs = 0.0, meanNs = 0.0, p95Ns = 0.0, stddevNs = 0.0; // per op
+        double allocationsPerOp = 0.0;
+        double bytesPerOp = 0.0;
+        double itemsPerOp = 0.0; // items processed by one op, for throughput (0 = not reported)
+    };
+
+    struct AllocationCounts {
+        uint64_t allocations = 0;
+        uint64_t bytes = 0;
+    };
+    // Heap allocations made by the whole process (all threads) so far
+    AllocationCounts GetAllocationCounts();
+
+    // Keeps the compiler from discarding a result the benchmark does not otherwise use
+    template <typename T>
+    inline void DoNotOptimize(const T& value) {
+#if defined(__GNUC__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static const void* volatile sink;
+        sink = &value;
+#endif
+    }
+
+    class Runner {
+    public:
+        explicit Runner(const Settings& settings) : m_Settings(settings) {}
+
+        // Whether a benchmark runs with the current filter; lets groups skip expensive setup
+        bool IsSelected(const std::string& name) const;
+
+        template <typename Fn>
+        void Run(const std::string& name, Fn&& op, double itemsPerOp = 0.0) {
+            if (!IsSelected(name)) return;
+
+            uint64_t iterations = 1;
+            const double minNs = m_Settings.minRepetitionMs * 1e6;
+            while (TimeRepetition(op, iterations) < minNs && iterations < (1ull << 30)) iterations *= 2;
+            for (int i = 0; i < m_Settings.warmup; ++i) TimeRepetition(op, iterations);
+
+            std::vector<double> samples;
+            samples.reserve(m_Settings.repetitions);
+            AllocationCounts before = GetAllocationCounts();
+            for (int i = 0; i < m_Settings.repetitions; ++i) {
+                samples.push_back(TimeRepetition(op, iterations) / static_cast<double>(iterations));
+            }
+            AllocationCounts after = GetAllocationCounts();
+            Record(name, iterations, samples, before, after, itemsPerOp);
+        }
+
+        // Notes a benchmark that could not run (missing GL context, asset, ...)
+        void Skip(const std::string& name, const char* reason);
+
+        const std::vector<Result>& GetResults() const { return m_Results; }
+        bool WriteJson(const std::string& path) const;
+        // Prints the comparison with a baseline JSON file; returns the number of regressions,
+        // or -1 if the baseline can't be read
+        int Compare(const std::string& baselinePath, double thresholdPercent) const;
+
+    private:
+        template <typename Fn>
+        static double TimeRepetition(Fn& op, uint64_t iterations) {
+            auto start = std::chrono::steady_clock::now();
+            for (uint64_t i = 0; i < iterations; ++i) op();
+            return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        void Record(const std::string& name, uint64_t iterations, std::vector<double>& samples,
+                    const AllocationCounts& before, const AllocationCounts& after, double itemsPerOp);
+
+        Settings m_Settings;
+        std::vector<Result> m_Results;
+    };
+
+    // Human readable duration ("812 ns", "3.40 us", "12.5 ms")
+    std::string FormatNs(double ns);
+}
+
+// Benchmark groups, one file each
+void RunTransformBenchmarks(bench::Runner& runner, size_t transformCount);
+void RunTextureBenchmarks(bench::Runner& runner);
+// The groups below need a current GL context
+void RunMeshBenchmarks(bench::Runner& runner);
+void RunPickingBenchmarks(bench::Runner& runner);
+void RunRenderStateBenchmarks(bench::Runner& runner);
@@ -0,0 +1,58 @@
+// Mesh::LoadFromOBJ on synthetic OBJ files of increasing size: a grid of quads with positions,
+// texture coordinates and normals, written to the temp directory first. One op loads one file
+// into a fresh Mesh (parsing, GL upload and the picking BVH); items are faces.
+#include "bench.h"
+#include "mesh.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+    // side x side quads
+    bool WriteGridObj(const std::string& path, int side) {
+        std::ofstream obj(path);
+        if (!obj) return false;
+        for (int z = 0; z <= side; ++z) {
+            for (int x = 0; x <= side; ++x) {
+                obj << "v " << x << " 0 " << z << "\n";
+                obj << "vt " << (float)x / side << " " << (float)z / side << "\n";
+                obj << "vn 0 1 0\n";
+            }
+        }
+        for (int z = 0; z < side; ++z) {
+            for (int x = 0; x < side; ++x) {
+                int a = z * (side + 1) + x + 1; // OBJ indices are 1-based
+                int b = a + 1, c = a + side + 1, d = c + 1;
+                obj << "f " << a << "/" << a << "/" << a << " " << c << "/" << c << "/" << c << " "
+                    << d << "/" << d << "/" << d << " " << b << "/" << b << "/" << b << "\n";
+            }
+        }
+        return static_cast<bool>(obj);
+    }
+}
+
+void RunMeshBenchmarks(bench::Runner& runner) {
+    struct Size { const char* label; int side; };
+    const Size sizes[] = { { "1k_faces", 32 }, { "10k_faces", 100 }, { "100k_faces", 316 } };
+
+    std::error_code error;
+    std::filesystem::path directory = std::filesystem::temp_directory_path(error) / "rampage_bench";
+    std::filesystem::create_directories(directory, error);
+
+    for (const Size& size : sizes) {
+        std::string name = std::string("mesh/LoadFromOBJ/") + size.label;
+        if (!runner.IsSelected(name)) continue;
+        std::string path = (directory / (std::string("grid_") + size.label + ".obj")).string();
+        if (!WriteGridObj(path, size.side)) {
+            runner.Skip(name, "could not write the synthetic OBJ");
+            continue;
+        }
+        runner.Run(name, [&] {
+            Mesh mesh;
+            bench::DoNotOptimize(mesh.LoadFromOBJ(path));
+        }, static_cast<double>(size.side) * size.side);
+        std::remove(path.c_str());
+    }
+    std::filesystem::remove(directory, error); // only if empty
+}
@@ -0,0 +1,119 @@
+// Editor picking (what EngineUI::PickObject runs): SpatialIndex::Pick against generated stress
+// scenes, with rays from around the scene towards random points inside it. One op is one pick.
+// Before timing, every ray is checked against a brute-force pick (each triangle of each entity
+// the ray's bounds test lets through); a mismatch skips the benchmark instead of timing it.
+#include "bench.h"
+#include "arena.h"
+#include "components.h"
+#include "material.h"
+#include "mesh.h"
+#include "spatial_index.h"
+#include "stress_scene.h"
+#include "texture.h"
+#include "transform_system.h"
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+    // Nearest world distance at which the ray hits any triangle of any mesh entity, no BVH involved
+    float BruteForcePick(const glm::vec3& origin, const glm::vec3& direction, World& world,
+                         TransformSystem& transforms, Pool<Mesh>& meshes) {
+        const float kNoHit = std::numeric_limits<float>::max();
+        float best = kNoHit;
+        Ray ray(origin, direction);
+        world.Each<TransformComponent, MeshRenderer>([&](Entity, TransformComponent& transform, MeshRenderer& renderer) {
+            const Mesh* mesh = meshes.Get(renderer.mesh);
+            if (!mesh) return;
+            const glm::mat4& worldMatrix = transforms.GetWorldMatrix(transform.handle);
+            if (IntersectAABB(ray, mesh->GetBounds().Transformed(worldMatrix), best) >= best) return;
+
+            glm::mat4 worldToLocal = glm::inverse(worldMatrix);
+            glm::vec3 localOrigin = glm::vec3(worldToLocal * glm::vec4(origin, 1.0f));
+            glm::vec3 localDirection = glm::vec3(worldToLocal * glm::vec4(direction, 0.0f));
+            const std::vector<Vertex>& vertices = mesh->GetVertices();
+            const std::vector<unsigned int>& indices = mesh->GetIndices();
+            for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+                glm::vec3 v0 = vertices[indices[i]].Position;
+                glm::vec3 e1 = vertices[indices[i + 1]].Position - v0;
+                glm::vec3 e2 = vertices[indices[i + 2]].Position - v0;
+                glm::vec3 pvec = glm::cross(localDirection, e2);
+                float det = glm::dot(e1, pvec);
+                if (std::fabs(det) <= 1e-20f) continue;
+                float invDet = 1.0f / det;
+                glm::vec3 tvec = localOrigin - v0;
+                float u = glm::dot(tvec, pvec) * invDet;
+                if (u < 0.0f || u > 1.0f) continue;
+                glm::vec3 qvec = glm::cross(tvec, e1);
+                float v = glm::dot(localDirection, qvec) * invDet;
+                if (v < 0.0f || u + v > 1.0f) continue;
+                float t = glm::dot(e2, qvec) * invDet;
+                if (t > 0.0f && t < best) best = t;
+            }
+        });
+        return best;
+    }
+}
+
+void RunPickingBenchmarks(bench::Runner& runner) {
+    const int objectCounts[] = { 1000, 10000 };
+    for (int objects : objectCounts) {
+        std::string name = "picking/Pick/" + std::to_string(objects / 1000) + "k_objects";
+        if (!runner.IsSelected(name)) continue;
+
+        Pool<Mesh> meshes;
+        Pool<Texture> textures;
+        Pool<Material> materials;
+        TransformSystem transforms(nullptr);
+        Arena arena;
+        World world(&arena);
+        StressSceneOptions options;
+        options.objects = objects;
+        options.layout = StressLayout::Random;
+        StressScene::Result scene = StressScene::Generate(options, world, transforms, meshes, textures, materials);
+        transforms.Update();
+        SpatialIndex index;
+        index.Update(world, transforms, meshes);
+
+        // Fixed rays, so every run picks the same objects
+        struct Ray { glm::vec3 origin, direction; };
+        std::vector<Ray> rays;
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+        for (int i = 0; i < 256; ++i) {
+            glm::vec3 origin = glm::normalize(glm::vec3(unit(rng), unit(rng), unit(rng)) + glm::vec3(0.0f, 0.0f, 1e-3f)) * scene.radius * 1.6f;
+            glm::vec3 target = glm::vec3(unit(rng), unit(rng), unit(rng)) * scene.radius * 0.5f;
+            rays.push_back({ origin, glm::normalize(target - origin) });
+        }
+
+        int mismatches = 0;
+        for (const Ray& ray : rays) {
+            PickResult picked = index.Pick(ray.origin, ray.direction, world, transforms, meshes);
+            float expected = BruteForcePick(ray.origin, ray.direction, world, transforms, meshes);
+            bool expectedHit = expected != std::numeric_limits<float>::max();
+            if (picked.entity.IsValid() != expectedHit ||
+                (expectedHit && std::fabs(picked.distance - expected) > 1e-4f * expected)) {
+                ++mismatches;
+            }
+        }
+        if (mismatches > 0) {
+            std::string reason = std::to_string(mismatches) + " of " + std::to_string(rays.size()) + " picks differ from brute force";
+            runner.Skip(name, reason.c_str());
+        }
+
+        size_t next = 0;
+        if (mismatches == 0) {
+            runner.Run(name, [&] {
+                const Ray& ray = rays[next++ % rays.size()];
+                bench::DoNotOptimize(index.Pick(ray.origin, ray.direction, world, transforms, meshes));
+            });
+        }
+
+        world.Clear();
+        materials.Clear();
+        textures.Clear();
+        meshes.Clear();
+    }
+}
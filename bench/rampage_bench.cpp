@@ -0,0 +1,159 @@
+// rampage_bench: micro-benchmarks of the engine's hot paths (see bench.h for the harness).
+//
+//   rampage_bench [--filter TEXT] [--repetitions N] [--warmup N] [--min-time MS]
+//                 [--transforms N] [--json FILE] [--compare BASELINE.json] [--threshold PERCENT]
+//                 [--no-gl] [--headless]
+//
+// A typical regression check: run once on the base build with --json base.json, then on the
+// change with --compare base.json; the exit code is 1 when something regressed.
+// Build with build_bench.bat and run from the repository root. Mesh, picking, shader and
+// material benchmarks need a GL context (a hidden GLFW window, or --headless for EGL/OSMesa
+// without a display); without one they are skipped.
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include "bench.h"
+#include "log.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+    struct Options {
+        bench::Settings settings;
+        size_t transformCount = 1000000;
+        std::string jsonPath;
+        std::string comparePath;
+        double thresholdPercent = 10.0;
+        bool gl = true;
+        bool headless = false;
+    };
+
+    void PrintUsage() {
+        std::printf("Usage: rampage_bench [--filter TEXT] [--repetitions N] [--warmup N] [--min-time MS]\n"
+                    "                     [--transforms N] [--json FILE] [--compare BASELINE.json] [--threshold PERCENT]\n"
+                    "                     [--no-gl] [--headless]\n");
+    }
+
+    bool ParseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            const char* arg = argv[i];
+            const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+            if (std::strcmp(arg, "--no-gl") == 0) {
+                options.gl = false;
+            } else if (std::strcmp(arg, "--headless") == 0) {
+                options.headless = true;
+            } else if (!value) {
+                return false;
+            } else if (std::strcmp(arg, "--filter") == 0) {
+                options.settings.filter = value;
+                ++i;
+            } else if (std::strcmp(arg, "--repetitions") == 0) {
+                options.settings.repetitions = std::max(1, std::atoi(value));
+                ++i;
+            } else if (std::strcmp(arg, "--warmup") == 0) {
+                options.settings.warmup = std::max(0, std::atoi(value));
+                ++i;
+            } else if (std::strcmp(arg, "--min-time") == 0) {
+                options.settings.minRepetitionMs = std::max(0.0, std::atof(value));
+                ++i;
+            } else if (std::strcmp(arg, "--transforms") == 0) {
+                options.transformCount = static_cast<size_t>(std::max(64ll, std::atoll(value)));
+                ++i;
+            } else if (std::strcmp(arg, "--json") == 0) {
+                options.jsonPath = value;
+                ++i;
+            } else if (std::strcmp(arg, "--compare") == 0) {
+                options.comparePath = value;
+                ++i;
+            } else if (std::strcmp(arg, "--threshold") == 0) {
+                options.thresholdPercent = std::max(0.0, std::atof(value));
+                ++i;
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Hidden window, or GLFW's null platform with EGL/OSMesa like the engine's --headless mode
+    GLFWwindow* CreateContext(bool headless) {
+        if (headless) glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+        if (!glfwInit()) return nullptr;
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        GLFWwindow* window = nullptr;
+        if (headless) {
+            const int contextApis[] = { GLFW_EGL_CONTEXT_API, GLFW_OSMESA_CONTEXT_API };
+            for (int api : contextApis) {
+                glfwWindowHint(GLFW_CONTEXT_CREATION_API, api);
+                if ((window = glfwCreateWindow(64, 64, "rampage_bench", nullptr, nullptr))) break;
+            }
+        } else {
+            window = glfwCreateWindow(64, 64, "rampage_bench", nullptr, nullptr);
+        }
+        if (!window) return nullptr;
+        glfwMakeContextCurrent(window);
+        glfwSwapInterval(0);
+        if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+            glfwDestroyWindow(window);
+            return nullptr;
+        }
+        return window;
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        PrintUsage();
+        return 2;
+    }
+
+    // Warnings (missing uniforms, ...) would be logged on every iteration of some ops
+    Logger::Init(nullptr);
+    Logger::SetMinLevel(LogLevel::Error);
+
+    bench::Runner runner(options.settings);
+    std::printf("rampage_bench: %d warmup + %d repetitions, >= %.1f ms each\n\n",
+                options.settings.warmup, options.settings.repetitions, options.settings.minRepetitionMs);
+
+    RunTransformBenchmarks(runner, options.transformCount);
+    RunTextureBenchmarks(runner);
+
+    GLFWwindow* window = options.gl ? CreateContext(options.headless) : nullptr;
+    if (window) {
+        std::printf("GL: %s (%s)\n", (const char*)glGetString(GL_RENDERER), (const char*)glGetString(GL_VERSION));
+        RunMeshBenchmarks(runner);
+        RunPickingBenchmarks(runner);
+        RunRenderStateBenchmarks(runner);
+        glfwDestroyWindow(window);
+    } else {
+        const char* reason = options.gl ? "no GL context" : "--no-gl";
+        runner.Skip("mesh/", reason);
+        runner.Skip("picking/", reason);
+        runner.Skip("shader/", reason);
+        runner.Skip("material/", reason);
+    }
+    if (options.gl) glfwTerminate();
+
+    int exitCode = 0;
+    if (!options.jsonPath.empty() && !runner.WriteJson(options.jsonPath)) {
+        std::printf("Could not write %s\n", options.jsonPath.c_str());
+        exitCode = 2;
+    }
+    if (!options.comparePath.empty()) {
+        int regressions = runner.Compare(options.comparePath, options.thresholdPercent);
+        if (regressions < 0) {
+            std::printf("Could not read the baseline %s\n", options.comparePath.c_str());
+            exitCode = 2;
+        } else if (regressions > 0) {
+            std::printf("%d regression(s)\n", regressions);
+            if (exitCode == 0) exitCode = 1;
+        }
+    }
+
+    Logger::Shutdown();
+    return exitCode;
+}
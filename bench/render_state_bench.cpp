@@ -0,0 +1,98 @@
+// Shader::Set* and Material::Bind in isolation: the per-object uniform and texture work of the
+// scene pass, without drawing. The program is written to the temp directory with the uniforms
+// the scene shaders declare, so the numbers do not depend on the shaders/ folder.
+#include "bench.h"
+#include "material.h"
+#include "shader.h"
+#include "texture.h"
+#include "texture_generator.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+    const char* kVertexSource = R"(#version 330 core
+layout (location = 0) in vec3 aPos;
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+uniform mat3 normalMatrix;
+out vec3 normal;
+void main() {
+    normal = normalMatrix * vec3(0.0, 1.0, 0.0);
+    gl_Position = projection * view * model * vec4(aPos, 1.0);
+}
+)";
+
+    const char* kFragmentSource = R"(#version 330 core
+struct Material {
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+    float shininess;
+    bool hasDiffuseTexture;
+    bool hasSpecularTexture;
+    bool hasNormalTexture;
+};
+uniform Material material;
+uniform sampler2D diffuseMap;
+uniform vec3 viewPos;
+uniform float highlight;
+uniform int mode;
+in vec3 normal;
+out vec4 FragColor;
+void main() {
+    vec3 color = material.ambient + material.diffuse * max(normal.y, 0.0) + material.specular * pow(0.5, material.shininess);
+    if (material.hasDiffuseTexture || material.hasSpecularTexture || material.hasNormalTexture || mode > 0)
+        color *= texture(diffuseMap, vec2(0.5)).rgb;
+    FragColor = vec4(color + viewPos * highlight, 1.0);
+}
+)";
+
+    bool WriteText(const std::string& path, const char* text) {
+        std::ofstream file(path);
+        file << text;
+        return static_cast<bool>(file);
+    }
+}
+
+void RunRenderStateBenchmarks(bench::Runner& runner) {
+    std::error_code error;
+    std::filesystem::path directory = std::filesystem::temp_directory_path(error) / "rampage_bench";
+    std::filesystem::create_directories(directory, error);
+    std::string vertexPath = (directory / "bench.vert").string();
+    std::string fragmentPath = (directory / "bench.frag").string();
+    if (!WriteText(vertexPath, kVertexSource) || !WriteText(fragmentPath, kFragmentSource)) {
+        runner.Skip("shader/", "could not write the benchmark shaders");
+        return;
+    }
+    Shader shader(vertexPath, fragmentPath);
+    std::remove(vertexPath.c_str());
+    std::remove(fragmentPath.c_str());
+    std::filesystem::remove(directory, error);
+    if (!shader.IsValid()) {
+        runner.Skip("shader/", "benchmark program failed to build");
+        return;
+    }
+    shader.Use();
+
+    glm::mat4 matrix(1.0f);
+    glm::mat3 normalMatrix(1.0f);
+    glm::vec3 vector(0.5f);
+    runner.Run("shader/SetMat4", [&] { shader.SetMat4("model", matrix); });
+    runner.Run("shader/SetMat3", [&] { shader.SetMat3("normalMatrix", normalMatrix); });
+    runner.Run("shader/SetVec3", [&] { shader.SetVec3("viewPos", vector); });
+    runner.Run("shader/SetFloat", [&] { shader.SetFloat("highlight", 0.25f); });
+    runner.Run("shader/SetInt", [&] { shader.SetInt("mode", 1); });
+    // Names longer than the small-string buffer allocate on every call
+    runner.Run("shader/SetFloat_struct_member", [&] { shader.SetFloat("material.shininess", 32.0f); });
+
+    Texture texture;
+    texture.LoadFromData(TextureGenerator::GenerateColorTexture(64, 64, 200, 50, 50), 64, 64, 3);
+    Material untextured("BenchUntextured");
+    Material textured("BenchTextured");
+    textured.SetDiffuseTexture(&texture);
+    runner.Run("material/Bind_untextured", [&] { untextured.Bind(&shader); });
+    runner.Run("material/Bind_diffuse_texture", [&] { textured.Bind(&shader); });
+}
@@ -0,0 +1,18 @@
+// TextureGenerator benchmarks: procedural texel data at editor (256) and large (1024) sizes.
+// One op generates one texture; items are texels.
+#include "bench.h"
+#include "texture_generator.h"
+
+void RunTextureBenchmarks(bench::Runner& runner) {
+    const int sizes[] = { 256, 1024 };
+    for (int size : sizes) {
+        std::string suffix = "/" + std::to_string(size);
+        double texels = static_cast<double>(size) * size;
+        runner.Run("texture/GenerateCheckerboard" + suffix, [&] {
+            bench::DoNotOptimize(TextureGenerator::GenerateCheckerboard(size, size, 32));
+        }, texels);
+        runner.Run("texture/GenerateColorTexture" + suffix, [&] {
+            bench::DoNotOptimize(TextureGenerator::GenerateColorTexture(size, size, 200, 50, 50));
+        }, texels);
+    }
+}
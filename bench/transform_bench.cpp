@@ -0,0 +1,134 @@
+// Transform benchmarks: Transform::GetModelMatrix on its own, and world-matrix updates of a
+// whole scene (1M transforms by default).
+//
+// The scene updates compare the old layout (heap-allocated Transform per object, GetModelMatrix
+// per object) with TransformSystem::Update() single-threaded and on the JobSystem, and measure
+// incremental hierarchy propagation on animated rigs. One op is one frame.
+#include "bench.h"
+#include "transform_system.h"
+#include "job_system.h"
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+    std::vector<Transform> MakeTransforms(size_t count) {
+        std::mt19937 rng(1234);
+        std::uniform_real_distribution<float> pos(-500.0f, 500.0f);
+        std::uniform_real_distribution<float> rot(-180.0f, 180.0f);
+        std::uniform_real_distribution<float> scl(0.5f, 2.0f);
+
+        std::vector<Transform> transforms(count);
+        for (Transform& t : transforms) {
+            t.position = glm::vec3(pos(rng), pos(rng), pos(rng));
+            t.rotation = glm::vec3(rot(rng), rot(rng), rot(rng));
+            t.scale = glm::vec3(scl(rng));
+        }
+        return transforms;
+    }
+
+    // Baseline: one heap allocation per object, visited in scene order (not memory order)
+    void BenchScattered(bench::Runner& runner, const std::vector<Transform>& source) {
+        if (!runner.IsSelected("transform/update_scattered_objects")) return;
+        std::vector<std::unique_ptr<Transform>> objects;
+        objects.reserve(source.size());
+        for (const Transform& t : source) objects.emplace_back(new Transform(t));
+        std::shuffle(objects.begin(), objects.end(), std::mt19937(99));
+
+        std::vector<glm::mat4> out(source.size());
+        runner.Run("transform/update_scattered_objects", [&] {
+            for (size_t i = 0; i < objects.size(); ++i) {
+                objects[i]->rotation.y += 1.0f;
+                out[i] = objects[i]->GetModelMatrix();
+            }
+            bench::DoNotOptimize(out.back());
+        }, static_cast<double>(source.size()));
+    }
+
+    void BenchSystem(bench::Runner& runner, const char* name, const std::vector<Transform>& source, JobSystem* jobs) {
+        if (!runner.IsSelected(name)) return;
+        TransformSystem system(jobs);
+        system.Reserve(source.size());
+        std::vector<TransformHandle> handles;
+        handles.reserve(source.size());
+        for (const Transform& t : source) handles.push_back(system.Create(t));
+        system.Update();
+
+        runner.Run(name, [&] {
+            // Touch every transform so the whole set is dirty each frame
+            for (TransformHandle h : handles) {
+                glm::vec3 r = system.GetRotation(h);
+                r.y += 1.0f;
+                system.SetRotation(h, r);
+            }
+            system.Update();
+        }, static_cast<double>(source.size()));
+    }
+
+    // Animated rigs: 64-bone skeletons (each bone parented to an earlier bone),
+    // a quarter of the rigs animated per frame. Only their subtrees are propagated.
+    void BenchRigs(bench::Runner& runner, size_t count, JobSystem* jobs) {
+        const char* name = "transform/update_rigs_hierarchy";
+        if (!runner.IsSelected(name)) return;
+        const size_t kBonesPerRig = 64;
+        size_t rigCount = count / kBonesPerRig;
+
+        TransformSystem system(jobs);
+        system.Reserve(rigCount * kBonesPerRig);
+        std::vector<TransformHandle> bones;
+        bones.reserve(rigCount * kBonesPerRig);
+        std::mt19937 rng(42);
+        for (size_t r = 0; r < rigCount; ++r) {
+            size_t rigStart = bones.size();
+            Transform root;
+            root.position = glm::vec3(static_cast<float>(r % 1000), 0.0f, static_cast<float>(r / 1000));
+            bones.push_back(system.Create(root));
+            for (size_t b = 1; b < kBonesPerRig; ++b) {
+                Transform bone;
+                bone.position = glm::vec3(0.0f, 0.25f, 0.0f);
+                TransformHandle parent = bones[rigStart + rng() % b];
+                bones.push_back(system.Create(bone, parent));
+            }
+        }
+        system.Update();
+
+        int frame = 0;
+        auto animate = [&] {
+            for (size_t r = frame++ % 4; r < rigCount; r += 4) {
+                for (size_t b = 0; b < kBonesPerRig; b += 2) {
+                    TransformHandle h = bones[r * kBonesPerRig + b];
+                    glm::vec3 rot = system.GetRotation(h);
+                    rot.z += 2.0f;
+                    system.SetRotation(h, rot);
+                }
+            }
+            system.Update();
+        };
+        animate(); // one frame to learn how many transforms a frame updates
+        runner.Run(name, animate, static_cast<double>(system.GetLastUpdatedCount()));
+    }
+}
+
+void RunTransformBenchmarks(bench::Runner& runner, size_t transformCount) {
+    // Single matrices, 1024 per op: the cost of the math without the scene around it
+    std::vector<Transform> batch = MakeTransforms(1024);
+    std::vector<glm::mat4> matrices(batch.size());
+    runner.Run("transform/GetModelMatrix", [&] {
+        for (size_t i = 0; i < batch.size(); ++i) matrices[i] = batch[i].GetModelMatrix();
+        bench::DoNotOptimize(matrices.back());
+    }, static_cast<double>(batch.size()));
+
+    const char* updateNames[] = { "transform/update_scattered_objects", "transform/update_system_1_thread",
+                                  "transform/update_system_jobs", "transform/update_rigs_hierarchy" };
+    if (std::none_of(std::begin(updateNames), std::end(updateNames), [&](const char* name) { return runner.IsSelected(name); })) return;
+    std::vector<Transform> source = MakeTransforms(transformCount);
+    BenchScattered(runner, source);
+    BenchSystem(runner, "transform/update_system_1_thread", source, nullptr);
+
+    JobSystem jobs;
+    BenchSystem(runner, "transform/update_system_jobs", source, &jobs);
+    BenchRigs(runner, transformCount, &jobs);
+}
@@ -23,6 +23,28 @@ src/engineUI.cpp ^
 src/texture.cpp ^
 src/material.cpp ^
 src/texture_generator.cpp ^
+src/frame_stats.cpp ^
+src/job_system.cpp ^
+src/transform_system.cpp ^
+src/ecs.cpp ^
+src/system_scheduler.cpp ^
+src/arena.cpp ^
+src/bvh.cpp ^
+src/spatial_index.cpp ^
+src/gpu_picker.cpp ^
+src/debug_draw.cpp ^
+src/log.cpp ^
+src/name_index.cpp ^
+src/dynamic_resolution.cpp ^
+src/image_writer.cpp ^
+src/frame_capture.cpp ^
+src/profiler.cpp ^
+src/gl_trace.cpp ^
+src/stress_scene.cpp ^
+src/benchmark.cpp ^
+src/input_recorder.cpp ^
+src/shader_cache.cpp ^
+src/shader_watcher.cpp ^
 src/glad.c ^
 tinyobjloader-release/tiny_obj_loader.cc ^
 imgui/imgui.cpp ^
@@ -0,0 +1,49 @@
+@echo off
+echo Building Rampage Engine benchmarks...
+
+g++ -std=c++17 -O2 ^
+-Iinclude ^
+-Isrc ^
+-Ibench ^
+-Itinyobjloader-release ^
+-Iglad/include ^
+-Iglm ^
+-Llib ^
+bench/rampage_bench.cpp ^
+bench/bench.cpp ^
+bench/transform_bench.cpp ^
+bench/texture_bench.cpp ^
+bench/mesh_bench.cpp ^
+bench/picking_bench.cpp ^
+bench/render_state_bench.cpp ^
+src/transform_system.cpp ^
+src/job_system.cpp ^
+src/profiler.cpp ^
+src/log.cpp ^
+src/texture_generator.cpp ^
+src/texture.cpp ^
+src/shader.cpp ^
+src/shader_cache.cpp ^
+src/material.cpp ^
+src/mesh.cpp ^
+src/bvh.cpp ^
+src/ecs.cpp ^
+src/arena.cpp ^
+src/spatial_index.cpp ^
+src/stress_scene.cpp ^
+src/frame_stats.cpp ^
+src/glad.c ^
+-lglfw3 ^
+-lopengl32 ^
+-lgdi32 ^
+-luser32 ^
+-lkernel32 ^
+-o build/rampage_bench.exe
+
+if %ERRORLEVEL% EQU 0 (
+    echo Build successful!
+    build/rampage_bench.exe %*
+) else (
+    echo Build failed!
+    pause
+)
@@ -1,8 +1,7 @@
 #version 330 core
+in vec4 vColor;
 out vec4 FragColor;
 
-uniform vec3 color;
-
 void main() {
-    FragColor = vec4(color, 1.0);
-} 
\ No newline at end of file
+    FragColor = vColor;
+}
@@ -1,10 +1,13 @@
 #version 330 core
 layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec4 aColor;
 
-uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
 
+out vec4 vColor;
+
 void main() {
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
-} 
\ No newline at end of file
+    vColor = aColor;
+    gl_Position = projection * view * vec4(aPos, 1.0);
+}
@@ -1,5 +1,6 @@
 #version 330 core 
-out vec4 FragColor; 
+layout(location = 0) out vec4 FragColor; 
+layout(location = 1) out uint ObjectId; // framebuffer ID attachment (GPU picking)
  
 in vec2 TexCoords;
 in vec3 Normal;
@@ -27,6 +28,8 @@ struct Light {
 uniform Material material;
 uniform Light light;
 uniform vec3 viewPos;
+uniform uint objectId;   // entity index + 1, 0 = none
+uniform float highlight; // hover highlight amount (0 = off)
 
 // Texture samplers
 uniform sampler2D material.diffuse;
@@ -34,6 +37,8 @@ uniform sampler2D material.specular;
 uniform sampler2D material.normal;
 
 void main() {
+    ObjectId = objectId;
+
     // NEW: Simple highlighting - check material color first
     if (material.diffuse.r > 0.9 && material.diffuse.g > 0.9 && material.diffuse.b < 0.1) {
         // This is our yellow highlight - output bright yellow directly
@@ -78,5 +83,7 @@ void main() {
     // Combine all components
     vec3 result = ambient + diffuse + specular;
     
+    result = mix(result, vec3(1.0, 1.0, 0.6), highlight);
+
     FragColor = vec4(result, 1.0);
 }
@@ -6,6 +6,7 @@ layout(location = 2) in vec3 aNormal;
 uniform mat4 model; 
 uniform mat4 view; 
 uniform mat4 projection; 
+uniform mat3 normalMatrix; // inverse-transpose of model, computed per object on the CPU
  
 out vec2 TexCoords; 
 out vec3 Normal; 
@@ -13,7 +14,7 @@ out vec3 FragPos;
  
 void main() { 
     FragPos = vec3(model * vec4(aPos, 1.0)); 
-    Normal = mat3(transpose(inverse(model))) * aNormal; 
+    Normal = normalMatrix * aNormal; 
     TexCoords = aTexCoords; 
  
     gl_Position = projection * view * vec4(FragPos, 1.0); 
@@ -0,0 +1,62 @@
+#include "arena.h"
+
+namespace {
+    const size_t kBlockAlignment = 64;
+}
+
+Arena::Arena(size_t blockSize)
+    : m_BlockSize(blockSize) {
+}
+
+Arena::~Arena() {
+    Release();
+}
+
+void* Arena::Allocate(size_t size, size_t alignment) {
+    if (!m_Blocks.empty()) {
+        Block& block = m_Blocks[m_Current];
+        size_t aligned = (m_Offset + alignment - 1) & ~(alignment - 1);
+        if (aligned + size <= block.size) {
+            m_Offset = aligned + size;
+            m_BytesUsed += size;
+            return block.memory + aligned;
+        }
+    }
+
+    // Move on to the next retained block if it is big enough, otherwise insert a new one there
+    size_t next = m_Blocks.empty() ? 0 : m_Current + 1;
+    size_t needed = size + alignment;
+    if (next >= m_Blocks.size() || m_Blocks[next].size < needed) {
+        Block block;
+        block.size = needed > m_BlockSize ? needed : m_BlockSize;
+        block.memory = static_cast<uint8_t*>(::operator new(block.size, std::align_val_t(kBlockAlignment)));
+        m_Blocks.insert(m_Blocks.begin() + next, block);
+    }
+
+    m_Current = next;
+    uint8_t* base = m_Blocks[m_Current].memory;
+    size_t aligned = (reinterpret_cast<uintptr_t>(base) % alignment) ? alignment - reinterpret_cast<uintptr_t>(base) % alignment : 0;
+    m_Offset = aligned + size;
+    m_BytesUsed += size;
+    return base + aligned;
+}
+
+void Arena::Reset() {
+    m_Current = 0;
+    m_Offset = 0;
+    m_BytesUsed = 0;
+}
+
+void Arena::Release() {
+    for (Block& block : m_Blocks) {
+        ::operator delete(block.memory, std::align_val_t(kBlockAlignment));
+    }
+    m_Blocks.clear();
+    Reset();
+}
+
+size_t Arena::GetBytesReserved() const {
+    size_t total = 0;
+    for (const Block& block : m_Blocks) total += block.size;
+    return total;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Bump allocator for memory that lives exactly as long as a scene.
+// Allocations are never freed one by one: Reset() rewinds to the first block in O(1)
+// and keeps the blocks for the next load, Release() returns them to the system.
+// Only trivially destructible objects may be placed here (nothing runs their destructors).
+class Arena {
+public:
+    static constexpr size_t kDefaultBlockSize = 1 << 20; // 1 MB
+
+    explicit Arena(size_t blockSize = kDefaultBlockSize);
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    template <typename T, typename... Args>
+    T* New(Args&&... args) {
+        static_assert(std::is_trivially_destructible<T>::value, "Arena objects are never destroyed");
+        return new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    void Reset();
+    void Release();
+
+    size_t GetBytesUsed() const { return m_BytesUsed; }
+    size_t GetBytesReserved() const;
+
+private:
+    struct Block {
+        uint8_t* memory;
+        size_t size;
+    };
+
+    std::vector<Block> m_Blocks;
+    size_t m_BlockSize;
+    size_t m_Current = 0; // index of the block being filled
+    size_t m_Offset = 0;  // bytes used in the current block
+    size_t m_BytesUsed = 0;
+};
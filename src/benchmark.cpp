@@ -0,0 +1,90 @@
+#include "benchmark.h"
+#include "camera.h"
+#include "frame_stats.h"
+#include <cmath>
+#include <fstream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#ifndef PSAPI_VERSION
+#define PSAPI_VERSION 2 // K32GetProcessMemoryInfo from kernel32, no psapi.lib
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+#endif
+
+void Benchmark::ApplyCameraPath(Camera& camera, float t, float startYaw, float pitch, float distance) {
+    const float kTwoPi = 6.28318530718f;
+    float dolly = 1.0f - 0.35f * std::sin(t * kTwoPi * 2.0f);   // two in-out passes
+    float pitchSweep = pitch + 15.0f * std::sin(t * kTwoPi);     // above, then closer to the horizon
+    camera.SetOrbit(startYaw + 360.0f * t, pitchSweep, distance * dolly);
+}
+
+uint64_t Benchmark::GetProcessMemoryBytes(uint64_t* peakBytes) {
+    uint64_t current = 0, peak = 0;
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        current = counters.WorkingSetSize;
+        peak = counters.PeakWorkingSetSize;
+    }
+#else
+    if (FILE* statm = std::fopen("/proc/self/statm", "r")) {
+        unsigned long long size = 0, resident = 0;
+        if (std::fscanf(statm, "%llu %llu", &size, &resident) == 2)
+            current = resident * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+        std::fclose(statm);
+    }
+    if (FILE* status = std::fopen("/proc/self/status", "r")) {
+        char line[256];
+        while (std::fgets(line, sizeof(line), status)) {
+            unsigned long long kilobytes = 0;
+            if (std::sscanf(line, "VmHWM: %llu kB", &kilobytes) == 1) {
+                peak = kilobytes * 1024;
+                break;
+            }
+        }
+        std::fclose(status);
+    }
+#endif
+    if (peakBytes) *peakBytes = peak;
+    return current;
+}
+
+bool Benchmark::WriteSummary(const std::string& path, const FrameStats& stats, const RunInfo& info) {
+    std::ofstream summary(path);
+    if (!summary) return false;
+
+    StatSummary frameMs = stats.Summarize(FrameMetric::CpuMs);
+    StatSummary gpuSceneMs = stats.Summarize(FrameMetric::GpuSceneMs);
+    StatSummary gpuGizmosMs = stats.Summarize(FrameMetric::GpuGizmosMs);
+    StatSummary gpuUiMs = stats.Summarize(FrameMetric::GpuUiMs);
+    StatSummary drawCalls = stats.Summarize(FrameMetric::DrawCalls);
+    StatSummary triangles = stats.Summarize(FrameMetric::Triangles);
+    StatSummary stateChanges = stats.Summarize(FrameMetric::StateChanges);
+
+    // The frame time is wall time on the CPU; when the GPU passes take most of it the run is
+    // limited by the GPU, and shaving CPU work would not make it faster
+    double gpuMs = gpuSceneMs.average + gpuGizmosMs.average + gpuUiMs.average;
+    double gpuShare = frameMs.average > 0.0 ? gpuMs / frameMs.average : 0.0;
+    uint64_t peakBytes = 0;
+    uint64_t residentBytes = GetProcessMemoryBytes(&peakBytes);
+
+    summary << "scene " << info.scene << "\nentities " << info.entities
+            << "\nframes " << frameMs.samples << "\nsize " << info.width << "x" << info.height
+            << "\navg_ms " << frameMs.average << "\np50_ms " << frameMs.p50 << "\np95_ms " << frameMs.p95
+            << "\np99_ms " << frameMs.p99 << "\nmax_ms " << frameMs.max
+            << "\ngpu_scene_avg_ms " << gpuSceneMs.average << "\ngpu_scene_p95_ms " << gpuSceneMs.p95
+            << "\ngpu_gizmos_avg_ms " << gpuGizmosMs.average << "\ngpu_ui_avg_ms " << gpuUiMs.average
+            << "\ngpu_share " << gpuShare << "\nbound " << (gpuShare > 0.75 ? "gpu" : "cpu")
+            << "\ndraw_calls_avg " << drawCalls.average << "\ntriangles_avg " << triangles.average
+            << "\nstate_changes_avg " << stateChanges.average
+            << "\nmesh_kb " << info.meshBytes / 1024 << "\ntexture_kb " << info.textureBytes / 1024
+            << "\nresident_kb " << residentBytes / 1024 << "\npeak_resident_kb " << peakBytes / 1024 << "\n";
+    return static_cast<bool>(summary);
+}
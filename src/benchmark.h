@@ -0,0 +1,31 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class Camera;
+class FrameStats;
+
+// Scripted benchmark runs (--benchmark windowed, --headless offscreen): the camera path both
+// modes fly and the summary file that runs are compared against a baseline with.
+class Benchmark {
+public:
+    struct RunInfo {
+        std::string scene; // StressScene::Describe(), or "default" for the built-in scene
+        int width = 0;
+        int height = 0;
+        size_t entities = 0;
+        uint64_t meshBytes = 0;    // vertex and index data
+        uint64_t textureBytes = 0; // texel data, without mipmaps
+    };
+
+    // Camera at t in [0, 1]: one orbit around the focus point while dollying in and out and
+    // sweeping the pitch, so close, far and grazing views all take part in every run
+    static void ApplyCameraPath(Camera& camera, float t, float startYaw, float pitch, float distance);
+
+    // Resident memory of the process and, optionally, its peak; 0 where unsupported
+    static uint64_t GetProcessMemoryBytes(uint64_t* peakBytes = nullptr);
+
+    // "key value" lines: frame time percentiles, CPU/GPU split, render counters and memory
+    static bool WriteSummary(const std::string& path, const FrameStats& stats, const RunInfo& info);
+};
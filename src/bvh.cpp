@@ -0,0 +1,370 @@
+#include "bvh.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RAMPAGE_BVH_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+    const int kBinCount = 16;
+    const float kTraversalCost = 1.0f; // relative to one primitive test
+    const float kDetEpsilon = 1e-20f;
+
+    struct Bin {
+        AABB bounds;
+        uint32_t count = 0;
+    };
+}
+
+// ------------------------------------------------------------------------------------
+// AABB / ray helpers
+// ------------------------------------------------------------------------------------
+
+AABB AABB::Transformed(const glm::mat4& m) const {
+    if (IsEmpty()) return *this;
+
+    AABB result;
+    result.min = result.max = glm::vec3(m[3]);
+    for (int col = 0; col < 3; ++col) {
+        for (int row = 0; row < 3; ++row) {
+            float a = m[col][row] * min[col];
+            float b = m[col][row] * max[col];
+            result.min[row] += std::min(a, b);
+            result.max[row] += std::max(a, b);
+        }
+    }
+    return result;
+}
+
+float IntersectAABB(const Ray& ray, const AABB& box, float tMax) {
+    float tx1 = (box.min.x - ray.origin.x) * ray.invDirection.x;
+    float tx2 = (box.max.x - ray.origin.x) * ray.invDirection.x;
+    float tNear = std::min(tx1, tx2);
+    float tFar = std::max(tx1, tx2);
+
+    float ty1 = (box.min.y - ray.origin.y) * ray.invDirection.y;
+    float ty2 = (box.max.y - ray.origin.y) * ray.invDirection.y;
+    tNear = std::max(tNear, std::min(ty1, ty2));
+    tFar = std::min(tFar, std::max(ty1, ty2));
+
+    float tz1 = (box.min.z - ray.origin.z) * ray.invDirection.z;
+    float tz2 = (box.max.z - ray.origin.z) * ray.invDirection.z;
+    tNear = std::max(tNear, std::min(tz1, tz2));
+    tFar = std::min(tFar, std::max(tz1, tz2));
+
+    tNear = std::max(tNear, 0.0f);
+    return (tFar >= tNear && tNear < tMax) ? tNear : tMax;
+}
+
+// Gribb/Hartmann plane extraction: each plane is row 3 +/- row 0..2 of the matrix
+Frustum Frustum::FromMatrix(const glm::mat4& m) {
+    glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+    glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+    glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+    glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+    Frustum frustum;
+    frustum.planes[0] = row3 + row0; // left
+    frustum.planes[1] = row3 - row0; // right
+    frustum.planes[2] = row3 + row1; // bottom
+    frustum.planes[3] = row3 - row1; // top
+    frustum.planes[4] = row3 + row2; // near
+    frustum.planes[5] = row3 - row2; // far
+    return frustum;
+}
+
+Frustum::Containment Frustum::Classify(const AABB& box) const {
+    glm::vec3 center = box.Center();
+    glm::vec3 extent = (box.max - box.min) * 0.5f;
+    Containment result = Containment::Inside;
+    for (const glm::vec4& plane : planes) {
+        // Signed distance of the center against the box's projected radius on the plane normal
+        float distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+        float radius = std::fabs(plane.x) * extent.x + std::fabs(plane.y) * extent.y + std::fabs(plane.z) * extent.z;
+        if (distance < -radius) return Containment::Outside;
+        if (distance < radius) result = Containment::Intersects;
+    }
+    return result;
+}
+
+// ------------------------------------------------------------------------------------
+// Binned SAH builder
+// ------------------------------------------------------------------------------------
+
+uint32_t BuildBvh(const std::vector<AABB>& primBounds, uint32_t maxLeafSize,
+                  std::vector<BvhNode>& nodes, std::vector<uint32_t>& order) {
+    nodes.clear();
+    order.resize(primBounds.size());
+    std::iota(order.begin(), order.end(), 0u);
+    if (primBounds.empty()) return 0;
+    if (maxLeafSize == 0) maxLeafSize = 1;
+
+    std::vector<glm::vec3> centroids(primBounds.size());
+    for (size_t i = 0; i < primBounds.size(); ++i) centroids[i] = primBounds[i].Center();
+
+    nodes.reserve(primBounds.size() * 2);
+    nodes.emplace_back();
+    nodes[0].first = 0;
+    nodes[0].count = static_cast<uint32_t>(primBounds.size());
+
+    // (node, depth) pairs; the root is at depth 1
+    std::vector<std::pair<uint32_t, uint32_t>> stack;
+    stack.emplace_back(0, 1);
+    uint32_t maxDepth = 0;
+
+    while (!stack.empty()) {
+        uint32_t nodeIndex = stack.back().first;
+        uint32_t depth = stack.back().second;
+        stack.pop_back();
+        maxDepth = std::max(maxDepth, depth);
+
+        uint32_t first = nodes[nodeIndex].first;
+        uint32_t count = nodes[nodeIndex].count;
+
+        AABB bounds, centroidBounds;
+        for (uint32_t i = first; i < first + count; ++i) {
+            bounds.Grow(primBounds[order[i]]);
+            centroidBounds.Grow(centroids[order[i]]);
+        }
+        nodes[nodeIndex].bounds = bounds;
+        if (count == 1) continue;
+
+        // Evaluate kBinCount - 1 split planes on every axis
+        int bestAxis = -1;
+        int bestSplit = 0;
+        float bestCost = 1e30f;
+        glm::vec3 extent = centroidBounds.max - centroidBounds.min;
+        for (int axis = 0; axis < 3; ++axis) {
+            if (extent[axis] <= 0.0f) continue;
+            float scale = kBinCount / extent[axis];
+
+            Bin bins[kBinCount];
+            for (uint32_t i = first; i < first + count; ++i) {
+                int b = std::min(kBinCount - 1, static_cast<int>((centroids[order[i]][axis] - centroidBounds.min[axis]) * scale));
+                bins[b].count++;
+                bins[b].bounds.Grow(primBounds[order[i]]);
+            }
+
+            float leftArea[kBinCount - 1];
+            uint32_t leftCount[kBinCount - 1];
+            AABB running;
+            uint32_t runningCount = 0;
+            for (int b = 0; b < kBinCount - 1; ++b) {
+                running.Grow(bins[b].bounds);
+                runningCount += bins[b].count;
+                leftArea[b] = running.IsEmpty() ? 0.0f : running.SurfaceArea();
+                leftCount[b] = runningCount;
+            }
+
+            running = AABB();
+            runningCount = 0;
+            for (int b = kBinCount - 1; b > 0; --b) {
+                running.Grow(bins[b].bounds);
+                runningCount += bins[b].count;
+                if (leftCount[b - 1] == 0 || runningCount == 0) continue;
+                float cost = leftArea[b - 1] * leftCount[b - 1] + running.SurfaceArea() * runningCount;
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestSplit = b;
+                }
+            }
+        }
+
+        float area = bounds.SurfaceArea();
+        float leafCost = static_cast<float>(count);
+        float splitCost = area > 0.0f ? kTraversalCost + bestCost / area : 1e30f;
+        if (count <= maxLeafSize && (bestAxis < 0 || splitCost >= leafCost)) continue;
+
+        uint32_t mid;
+        if (bestAxis >= 0) {
+            float scale = kBinCount / extent[bestAxis];
+            float minC = centroidBounds.min[bestAxis];
+            uint32_t* begin = order.data() + first;
+            uint32_t* split = std::partition(begin, begin + count, [&](uint32_t prim) {
+                int b = std::min(kBinCount - 1, static_cast<int>((centroids[prim][bestAxis] - minC) * scale));
+                return b < bestSplit;
+            });
+            mid = static_cast<uint32_t>(split - order.data());
+        } else {
+            // All centroids coincide: any split is as good as another, halve the range
+            mid = first + count / 2;
+        }
+
+        uint32_t left = static_cast<uint32_t>(nodes.size());
+        nodes.emplace_back();
+        nodes.emplace_back();
+        nodes[left].first = first;
+        nodes[left].count = mid - first;
+        nodes[left + 1].first = mid;
+        nodes[left + 1].count = first + count - mid;
+        nodes[nodeIndex].first = left;
+        nodes[nodeIndex].count = 0;
+
+        stack.emplace_back(left + 1, depth + 1);
+        stack.emplace_back(left, depth + 1);
+    }
+    return maxDepth;
+}
+
+// ------------------------------------------------------------------------------------
+// TriangleBVH
+// ------------------------------------------------------------------------------------
+
+void TriangleBVH::Clear() {
+    m_Nodes.clear();
+    m_Packets.clear();
+    m_TriangleCount = 0;
+    m_Depth = 0;
+}
+
+void TriangleBVH::Build(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices) {
+    Clear();
+    m_TriangleCount = indices.size() / 3;
+    if (m_TriangleCount == 0) return;
+
+    std::vector<AABB> triBounds(m_TriangleCount);
+    for (size_t t = 0; t < m_TriangleCount; ++t) {
+        triBounds[t].Grow(positions[indices[t * 3 + 0]]);
+        triBounds[t].Grow(positions[indices[t * 3 + 1]]);
+        triBounds[t].Grow(positions[indices[t * 3 + 2]]);
+    }
+
+    std::vector<uint32_t> order;
+    m_Depth = BuildBvh(triBounds, 4, m_Nodes, order);
+
+    // Pack every leaf into one 4-wide packet; unused lanes stay degenerate (zero edges never hit)
+    for (BvhNode& node : m_Nodes) {
+        if (!node.IsLeaf()) continue;
+
+        TrianglePacket packet = {};
+        for (uint32_t lane = 0; lane < node.count; ++lane) {
+            uint32_t tri = order[node.first + lane];
+            const glm::vec3& v0 = positions[indices[tri * 3 + 0]];
+            glm::vec3 e1 = positions[indices[tri * 3 + 1]] - v0;
+            glm::vec3 e2 = positions[indices[tri * 3 + 2]] - v0;
+            packet.v0x[lane] = v0.x; packet.v0y[lane] = v0.y; packet.v0z[lane] = v0.z;
+            packet.e1x[lane] = e1.x; packet.e1y[lane] = e1.y; packet.e1z[lane] = e1.z;
+            packet.e2x[lane] = e2.x; packet.e2y[lane] = e2.y; packet.e2z[lane] = e2.z;
+            packet.triangle[lane] = tri;
+        }
+
+        node.first = static_cast<uint32_t>(m_Packets.size());
+        m_Packets.push_back(packet);
+    }
+}
+
+bool TriangleBVH::Raycast(const glm::vec3& origin, const glm::vec3& direction, float tMax, RayHit& hit) const {
+    if (m_Nodes.empty()) return false;
+
+    Ray ray(origin, direction);
+    float best = tMax;
+    bool found = false;
+
+#ifdef RAMPAGE_BVH_SSE
+    const __m128 ox = _mm_set1_ps(origin.x), oy = _mm_set1_ps(origin.y), oz = _mm_set1_ps(origin.z);
+    const __m128 dx = _mm_set1_ps(direction.x), dy = _mm_set1_ps(direction.y), dz = _mm_set1_ps(direction.z);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 epsilon = _mm_set1_ps(kDetEpsilon);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+#endif
+
+    BvhTraversalStack stack(m_Depth);
+    if (IntersectAABB(ray, m_Nodes[0].bounds, best) < best) stack.Push(0);
+
+    while (!stack.IsEmpty()) {
+        const BvhNode& node = m_Nodes[stack.Pop()];
+
+        if (node.IsLeaf()) {
+            const TrianglePacket& p = m_Packets[node.first];
+#ifdef RAMPAGE_BVH_SSE
+            __m128 e1x = _mm_load_ps(p.e1x), e1y = _mm_load_ps(p.e1y), e1z = _mm_load_ps(p.e1z);
+            __m128 e2x = _mm_load_ps(p.e2x), e2y = _mm_load_ps(p.e2y), e2z = _mm_load_ps(p.e2z);
+
+            // pvec = d x e2, det = e1 . pvec
+            __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+            __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+            __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+            __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+            __m128 invDet = _mm_div_ps(one, det);
+
+            __m128 tx = _mm_sub_ps(ox, _mm_load_ps(p.v0x));
+            __m128 ty = _mm_sub_ps(oy, _mm_load_ps(p.v0y));
+            __m128 tz = _mm_sub_ps(oz, _mm_load_ps(p.v0z));
+            __m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, px), _mm_mul_ps(ty, py)), _mm_mul_ps(tz, pz)), invDet);
+
+            // qvec = tvec x e1
+            __m128 qx = _mm_sub_ps(_mm_mul_ps(ty, e1z), _mm_mul_ps(tz, e1y));
+            __m128 qy = _mm_sub_ps(_mm_mul_ps(tz, e1x), _mm_mul_ps(tx, e1z));
+            __m128 qz = _mm_sub_ps(_mm_mul_ps(tx, e1y), _mm_mul_ps(ty, e1x));
+            __m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), invDet);
+            __m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), invDet);
+
+            __m128 mask = _mm_cmpgt_ps(_mm_and_ps(det, absMask), epsilon);
+            mask = _mm_and_ps(mask, _mm_cmpge_ps(u, zero));
+            mask = _mm_and_ps(mask, _mm_cmpge_ps(v, zero));
+            mask = _mm_and_ps(mask, _mm_cmple_ps(_mm_add_ps(u, v), one));
+            mask = _mm_and_ps(mask, _mm_cmpgt_ps(t, zero));
+            mask = _mm_and_ps(mask, _mm_cmplt_ps(t, _mm_set1_ps(best)));
+
+            int bits = _mm_movemask_ps(mask);
+            if (bits) {
+                alignas(16) float ts[4], us[4], vs[4];
+                _mm_store_ps(ts, t);
+                _mm_store_ps(us, u);
+                _mm_store_ps(vs, v);
+                for (int lane = 0; lane < 4; ++lane) {
+                    if ((bits & (1 << lane)) && ts[lane] < best) {
+                        best = ts[lane];
+                        hit.t = ts[lane];
+                        hit.u = us[lane];
+                        hit.v = vs[lane];
+                        hit.triangle = p.triangle[lane];
+                        found = true;
+                    }
+                }
+            }
+#else
+            for (uint32_t lane = 0; lane < node.count; ++lane) {
+                glm::vec3 e1(p.e1x[lane], p.e1y[lane], p.e1z[lane]);
+                glm::vec3 e2(p.e2x[lane], p.e2y[lane], p.e2z[lane]);
+                glm::vec3 pvec = glm::cross(direction, e2);
+                float det = glm::dot(e1, pvec);
+                if (std::fabs(det) <= kDetEpsilon) continue;
+                float invDet = 1.0f / det;
+                glm::vec3 tvec = origin - glm::vec3(p.v0x[lane], p.v0y[lane], p.v0z[lane]);
+                float u = glm::dot(tvec, pvec) * invDet;
+                if (u < 0.0f || u > 1.0f) continue;
+                glm::vec3 qvec = glm::cross(tvec, e1);
+                float v = glm::dot(direction, qvec) * invDet;
+                if (v < 0.0f || u + v > 1.0f) continue;
+                float t = glm::dot(e2, qvec) * invDet;
+                if (t > 0.0f && t < best) {
+                    best = t;
+                    hit.t = t;
+                    hit.u = u;
+                    hit.v = v;
+                    hit.triangle = p.triangle[lane];
+                    found = true;
+                }
+            }
+#endif
+            continue;
+        }
+
+        // Visit the nearer child first; skip children beyond the closest hit so far
+        uint32_t a = node.first, b = node.first + 1;
+        float ta = IntersectAABB(ray, m_Nodes[a].bounds, best);
+        float tb = IntersectAABB(ray, m_Nodes[b].bounds, best);
+        if (ta > tb) { std::swap(ta, tb); std::swap(a, b); }
+        if (tb < best) stack.Push(b);
+        if (ta < best) stack.Push(a);
+    }
+
+    return found;
+}
@@ -0,0 +1,130 @@
+#pragma once
+#include <cassert>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+// Axis-aligned bounding box. Default constructed boxes are empty (min > max).
+struct AABB {
+    glm::vec3 min = glm::vec3(1e30f);
+    glm::vec3 max = glm::vec3(-1e30f);
+
+    bool IsEmpty() const { return min.x > max.x; }
+    void Grow(const glm::vec3& p) { min = glm::min(min, p); max = glm::max(max, p); }
+    void Grow(const AABB& b) { min = glm::min(min, b.min); max = glm::max(max, b.max); }
+    glm::vec3 Center() const { return (min + max) * 0.5f; }
+    float SurfaceArea() const {
+        glm::vec3 e = max - min;
+        return 2.0f * (e.x * e.y + e.y * e.z + e.z * e.x);
+    }
+
+    // Bounds of this box after an affine transform (Arvo's method, no corner loop)
+    AABB Transformed(const glm::mat4& m) const;
+};
+
+// Ray with precomputed reciprocal direction for slab tests
+struct Ray {
+    glm::vec3 origin;
+    glm::vec3 direction;
+    glm::vec3 invDirection;
+
+    Ray(const glm::vec3& o, const glm::vec3& d)
+        : origin(o), direction(d), invDirection(1.0f / d.x, 1.0f / d.y, 1.0f / d.z) {}
+};
+
+// Six planes (ax + by + cz + d >= 0 inside) extracted from a view-projection matrix
+struct Frustum {
+    glm::vec4 planes[6];
+
+    static Frustum FromMatrix(const glm::mat4& viewProjection);
+
+    enum class Containment { Outside, Intersects, Inside };
+    Containment Classify(const AABB& box) const;
+};
+
+// Entry distance of the ray into the box, or a value >= tMax if it misses
+float IntersectAABB(const Ray& ray, const AABB& box, float tMax);
+
+// Binary BVH node. Leaves have count > 0 and reference primitives [first, first+count);
+// inner nodes have count == 0 and their children at first and first + 1.
+// Children always come after their parent, so a reverse walk is a valid bottom-up order.
+struct BvhNode {
+    AABB bounds;
+    uint32_t first = 0;
+    uint32_t count = 0;
+
+    bool IsLeaf() const { return count > 0; }
+};
+
+// Binned SAH build over arbitrary primitive bounds. Fills nodes (root at 0) and
+// order, the primitive indices in leaf order. Returns the depth of the tree (the
+// number of nodes on its longest root-to-leaf path, 0 when empty).
+uint32_t BuildBvh(const std::vector<AABB>& primBounds, uint32_t maxLeafSize,
+                  std::vector<BvhNode>& nodes, std::vector<uint32_t>& order);
+
+// Stack for a depth-first walk that pops one node and pushes at most both its children:
+// a tree of depth D never holds more than D entries. Lives on the stack for the usual
+// depths and only goes to the heap for degenerate trees.
+class BvhTraversalStack {
+public:
+    explicit BvhTraversalStack(uint32_t depth) {
+        if (depth > kInlineSize) {
+            m_Heap.resize(depth);
+            m_Data = m_Heap.data();
+            m_Capacity = depth;
+        }
+    }
+
+    bool IsEmpty() const { return m_Size == 0; }
+    void Push(uint32_t node) {
+        assert(m_Size < m_Capacity);
+        m_Data[m_Size++] = node;
+    }
+    uint32_t Pop() { return m_Data[--m_Size]; }
+
+private:
+    static const uint32_t kInlineSize = 64;
+
+    uint32_t m_Inline[kInlineSize];
+    std::vector<uint32_t> m_Heap;
+    uint32_t* m_Data = m_Inline;
+    uint32_t m_Capacity = kInlineSize;
+    uint32_t m_Size = 0;
+};
+
+struct RayHit {
+    float t = 0.0f;          // distance along the ray, in units of the ray direction
+    uint32_t triangle = 0;   // index of the triangle (indices[3*triangle ...])
+    float u = 0.0f, v = 0.0f; // barycentrics of the hit
+};
+
+// Triangle BVH for precise ray queries against one mesh (built once, cached with the mesh).
+// Leaves hold at most four triangles stored as one SoA packet (v0, edge1, edge2), so a
+// leaf is tested with a single 4-wide SSE Moller-Trumbore (scalar fallback elsewhere).
+class TriangleBVH {
+public:
+    void Build(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices);
+    void Clear();
+
+    bool IsBuilt() const { return !m_Nodes.empty(); }
+    const AABB& GetBounds() const { return m_Nodes.empty() ? m_EmptyBounds : m_Nodes[0].bounds; }
+    size_t GetTriangleCount() const { return m_TriangleCount; }
+    size_t GetNodeCount() const { return m_Nodes.size(); }
+
+    // Closest hit with t in (0, tMax). The direction does not need to be normalized.
+    bool Raycast(const glm::vec3& origin, const glm::vec3& direction, float tMax, RayHit& hit) const;
+
+private:
+    struct alignas(16) TrianglePacket {
+        float v0x[4], v0y[4], v0z[4];
+        float e1x[4], e1y[4], e1z[4];
+        float e2x[4], e2y[4], e2z[4];
+        uint32_t triangle[4];
+    };
+
+    std::vector<BvhNode> m_Nodes; // leaf "first" indexes m_Packets
+    std::vector<TrianglePacket> m_Packets;
+    size_t m_TriangleCount = 0;
+    uint32_t m_Depth = 0; // sizes the traversal stack
+    AABB m_EmptyBounds;
+};
@@ -7,6 +7,8 @@ void Camera::ProcessMouseMovement(float deltaX, float deltaY) {
     m_Yaw += deltaX * 0.25f;
     m_Pitch -= deltaY * 0.25f;
     m_Pitch = glm::clamp(m_Pitch, -89.0f, 89.0f);
+    m_ViewDirty = m_ViewProjectionDirty = true;
+    ++m_Version;
 }
 
 void Camera::ProcessMousePan(float deltaX, float deltaY) {
@@ -17,14 +19,42 @@ void Camera::ProcessMousePan(float deltaX, float deltaY) {
     glm::vec3 pan = (-right * deltaX + up * deltaY) * 0.01f;
 
     m_FocusPoint += pan;
+    m_ViewDirty = m_ViewProjectionDirty = true;
+    ++m_Version;
 }
 
 void Camera::ProcessMouseScroll(float deltaScroll) {
     m_Distance -= deltaScroll * 0.5f;
     if (m_Distance < 1.0f) m_Distance = 1.0f;
+    m_ViewDirty = m_ViewProjectionDirty = true;
+    ++m_Version;
 }
 
-glm::mat4 Camera::GetViewMatrix() const {
+void Camera::SetOrbit(float yawDegrees, float pitchDegrees, float distance) {
+    m_Yaw = yawDegrees;
+    m_Pitch = glm::clamp(pitchDegrees, -89.0f, 89.0f);
+    m_Distance = distance < 1.0f ? 1.0f : distance;
+    m_ViewDirty = m_ViewProjectionDirty = true;
+    ++m_Version;
+}
+
+void Camera::SetPerspective(float fovYDegrees, float nearPlane, float farPlane) {
+    m_FovY = fovYDegrees;
+    m_Near = nearPlane;
+    m_Far = farPlane;
+    m_ProjectionDirty = m_ViewProjectionDirty = true;
+    ++m_Version;
+}
+
+void Camera::SetAspect(float aspect) {
+    if (!(aspect > 0.0f) || aspect == m_Aspect) return;
+    m_Aspect = aspect;
+    m_ProjectionDirty = m_ViewProjectionDirty = true;
+    ++m_Version;
+}
+
+// The view is a rigid transform: its inverse is the transposed rotation and the camera position
+void Camera::UpdateView() const {
     float yawRad = glm::radians(m_Yaw);
     float pitchRad = glm::radians(m_Pitch);
 
@@ -34,17 +64,75 @@ glm::mat4 Camera::GetViewMatrix() const {
         glm::cos(pitchRad) * glm::cos(yawRad)
     };
 
-    glm::vec3 position = m_FocusPoint - direction * m_Distance;
-    return glm::lookAt(position, m_FocusPoint, glm::vec3(0, 1, 0));
+    m_Position = m_FocusPoint - direction * m_Distance;
+    m_View = glm::lookAt(m_Position, m_FocusPoint, glm::vec3(0, 1, 0));
+
+    m_InverseView = glm::mat4(1.0f);
+    for (int axis = 0; axis < 3; ++axis) {
+        m_InverseView[axis] = glm::vec4(m_View[0][axis], m_View[1][axis], m_View[2][axis], 0.0f);
+    }
+    m_InverseView[3] = glm::vec4(m_Position, 1.0f);
+    m_ViewDirty = false;
+}
+
+// glm::perspective only fills the diagonal and the (z, w) block, so the inverse is closed form:
+//   P = | a 0 0 0 |     P^-1 = | 1/a  0    0    0  |
+//       | 0 b 0 0 |            |  0  1/b   0    0  |
+//       | 0 0 c d |            |  0   0    0   -1  |
+//       | 0 0 -1 0 |           |  0   0   1/d  c/d |
+void Camera::UpdateProjection() const {
+    m_Projection = glm::perspective(glm::radians(m_FovY), m_Aspect, m_Near, m_Far);
+
+    float a = m_Projection[0][0];
+    float b = m_Projection[1][1];
+    float c = m_Projection[2][2];
+    float d = m_Projection[3][2];
+    m_InverseProjection = glm::mat4(0.0f);
+    m_InverseProjection[0][0] = 1.0f / a;
+    m_InverseProjection[1][1] = 1.0f / b;
+    m_InverseProjection[3][2] = -1.0f;
+    m_InverseProjection[2][3] = 1.0f / d;
+    m_InverseProjection[3][3] = c / d;
+    m_ProjectionDirty = false;
+}
+
+const glm::mat4& Camera::GetViewMatrix() const {
+    if (m_ViewDirty) UpdateView();
+    return m_View;
+}
+
+const glm::mat4& Camera::GetProjectionMatrix() const {
+    if (m_ProjectionDirty) UpdateProjection();
+    return m_Projection;
+}
+
+const glm::mat4& Camera::GetViewProjectionMatrix() const {
+    if (m_ViewProjectionDirty) {
+        m_ViewProjection = GetProjectionMatrix() * GetViewMatrix();
+        m_ViewProjectionDirty = false;
+    }
+    return m_ViewProjection;
+}
+
+const glm::mat4& Camera::GetInverseViewMatrix() const {
+    if (m_ViewDirty) UpdateView();
+    return m_InverseView;
+}
+
+const glm::mat4& Camera::GetInverseProjectionMatrix() const {
+    if (m_ProjectionDirty) UpdateProjection();
+    return m_InverseProjection;
 }
 
 glm::vec3 Camera::GetCameraPosition() const {
-    float yawRad = glm::radians(m_Yaw);
-    float pitchRad = glm::radians(m_Pitch);
-    glm::vec3 direction = {
-        glm::cos(pitchRad) * glm::sin(yawRad),
-        glm::sin(pitchRad),
-        glm::cos(pitchRad) * glm::cos(yawRad)
-    };
-    return m_FocusPoint - direction * m_Distance;
-}
\ No newline at end of file
+    if (m_ViewDirty) UpdateView();
+    return m_Position;
+}
+
+// Unprojecting a point on the near plane and dropping w reduces to scaling x and y by the
+// inverse projection diagonal; only the rotation part of the inverse view is needed after that
+glm::vec3 Camera::GetRayDirection(const glm::vec2& ndc) const {
+    const glm::mat4& inverseProjection = GetInverseProjectionMatrix();
+    glm::vec3 eye(ndc.x * inverseProjection[0][0], ndc.y * inverseProjection[1][1], -1.0f);
+    return glm::normalize(glm::mat3(GetInverseViewMatrix()) * eye);
+}
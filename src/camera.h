@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
@@ -12,12 +13,56 @@ public:
     void ProcessMouseMovement(float deltaX, float deltaY);
     void ProcessMousePan(float deltaX, float deltaY);
     void ProcessMouseScroll(float deltaScroll);
-    
-    glm::mat4 GetViewMatrix() const;
+
+    // Places the camera directly on its orbit around the focus point (scripted camera paths)
+    void SetOrbit(float yawDegrees, float pitchDegrees, float distance);
+    float GetYaw() const { return m_Yaw; }
+    float GetPitch() const { return m_Pitch; }
+    float GetDistance() const { return m_Distance; }
+
+    // Projection owned by the camera, so the renderer and the editor rays can't drift apart
+    void SetPerspective(float fovYDegrees, float nearPlane, float farPlane);
+    void SetAspect(float aspect); // ignored for degenerate sizes (minimized window)
+    float GetAspect() const { return m_Aspect; }
+    float GetNearPlane() const { return m_Near; }
+    float GetFarPlane() const { return m_Far; }
+    // Bumped whenever the view or the projection changes (render-on-demand compares it)
+    uint64_t GetVersion() const { return m_Version; }
+
+    // Cached matrices, rebuilt lazily only after the camera or the projection changed.
+    // The inverses are closed form (rigid view, diagonal perspective), never glm::inverse.
+    const glm::mat4& GetViewMatrix() const;
+    const glm::mat4& GetProjectionMatrix() const;
+    const glm::mat4& GetViewProjectionMatrix() const;
+    const glm::mat4& GetInverseViewMatrix() const;
+    const glm::mat4& GetInverseProjectionMatrix() const;
     glm::vec3 GetCameraPosition() const;
 
+    // World-space direction of the ray through a point in NDC (-1..1); the ray starts at the camera
+    glm::vec3 GetRayDirection(const glm::vec2& ndc) const;
+
 private:
+    void UpdateView() const;
+    void UpdateProjection() const;
+
     float m_Yaw, m_Pitch;
     float m_Distance;
     glm::vec3 m_FocusPoint;
-};
\ No newline at end of file
+
+    float m_FovY = 45.0f;
+    float m_Aspect = 16.0f / 9.0f;
+    float m_Near = 0.1f;
+    float m_Far = 100.0f;
+    uint64_t m_Version = 0;
+
+    // Lazily rebuilt caches
+    mutable bool m_ViewDirty = true;
+    mutable bool m_ProjectionDirty = true;
+    mutable bool m_ViewProjectionDirty = true;
+    mutable glm::vec3 m_Position = glm::vec3(0.0f);
+    mutable glm::mat4 m_View = glm::mat4(1.0f);
+    mutable glm::mat4 m_InverseView = glm::mat4(1.0f);
+    mutable glm::mat4 m_Projection = glm::mat4(1.0f);
+    mutable glm::mat4 m_InverseProjection = glm::mat4(1.0f);
+    mutable glm::mat4 m_ViewProjection = glm::mat4(1.0f);
+};
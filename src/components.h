@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstring>
+#include "transform_system.h"
+#include "pool.h"
+
+class Mesh;
+class Material;
+
+// Engine components stored in the ECS World (see ecs.h).
+// Components are plain, trivially destructible data so a scene's chunks can be
+// thrown away with its arena; behaviour lives in systems and in main.cpp.
+
+struct NameComponent {
+    char value[64] = "Entity";
+
+    NameComponent() = default;
+    explicit NameComponent(const char* name) { Set(name); }
+
+    void Set(const char* name) {
+        strncpy(value, name, sizeof(value) - 1);
+        value[sizeof(value) - 1] = '\0';
+    }
+};
+
+// Local/world transform lives in the TransformSystem; the entity only keeps the handle.
+// The transform's user data holds the owning Entity (Entity::ToUint64) so the
+// hierarchy can be walked back to entities.
+struct TransformComponent {
+    TransformHandle handle;
+};
+
+// Meshes and materials live in Pool<Mesh>/Pool<Material>; a stale handle just skips the draw
+struct MeshRenderer {
+    Handle<Mesh> mesh;         // Shared mesh
+    Handle<Material> material; // Each entity can have its own material
+};
+
+// More components will be added later, components such as:
+// Rigidbody, Collider, Light, Camera, etc.
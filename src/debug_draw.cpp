@@ -0,0 +1,200 @@
+#include "debug_draw.h"
+#include "shader.h"
+#include "frame_stats.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <glm/gtc/constants.hpp>
+
+namespace {
+    const size_t kInitialCapacity = 1 << 16; // vertices (1 MB)
+    const size_t kFramesPerRing = 3;         // orphaning happens at most every few frames
+
+    // Box corners are indexed by bits (x, y, z); each edge flips one bit
+    const int kBoxEdges[12][2] = {
+        { 0, 1 }, { 2, 3 }, { 4, 5 }, { 6, 7 }, // along x
+        { 0, 2 }, { 1, 3 }, { 4, 6 }, { 5, 7 }, // along y
+        { 0, 4 }, { 1, 5 }, { 2, 6 }, { 3, 7 }  // along z
+    };
+}
+
+DebugDraw::DebugDraw() {
+    glGenVertexArrays(1, &m_VAO);
+    glGenBuffers(1, &m_VBO);
+
+    glBindVertexArray(m_VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), (void*)offsetof(Vertex, color));
+    glBindVertexArray(0);
+
+    Reserve(kInitialCapacity);
+    m_Vertices[0].reserve(kInitialCapacity);
+}
+
+void DebugDraw::Release() {
+    if (m_VBO) glDeleteBuffers(1, &m_VBO);
+    if (m_VAO) glDeleteVertexArrays(1, &m_VAO);
+    m_VBO = m_VAO = 0;
+}
+
+// (Re)allocates the ring storage; also used to orphan it when the ring wraps
+void DebugDraw::Reserve(size_t vertexCount) {
+    m_Capacity = vertexCount;
+    m_Head = 0;
+    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+    glBufferData(GL_ARRAY_BUFFER, m_Capacity * sizeof(Vertex), nullptr, GL_STREAM_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+DebugDraw::Vertex* DebugDraw::Append(Mode mode, size_t count) {
+    std::vector<Vertex>& vertices = m_Vertices[static_cast<int>(mode)];
+    size_t first = vertices.size();
+    vertices.resize(first + count);
+    return vertices.data() + first;
+}
+
+void DebugDraw::Line(const glm::vec3& a, const glm::vec3& b, uint32_t color, Mode mode) {
+    Vertex* v = Append(mode, 2);
+    v[0] = { a, color };
+    v[1] = { b, color };
+}
+
+void DebugDraw::BoxEdges(const glm::vec3 corners[8], uint32_t color, Mode mode) {
+    Vertex* v = Append(mode, 24);
+    for (int e = 0; e < 12; ++e) {
+        v[e * 2] = { corners[kBoxEdges[e][0]], color };
+        v[e * 2 + 1] = { corners[kBoxEdges[e][1]], color };
+    }
+}
+
+void DebugDraw::Box(const AABB& box, uint32_t color, Mode mode) {
+    glm::vec3 corners[8];
+    for (int i = 0; i < 8; ++i) {
+        corners[i] = glm::vec3((i & 1) ? box.max.x : box.min.x,
+                               (i & 2) ? box.max.y : box.min.y,
+                               (i & 4) ? box.max.z : box.min.z);
+    }
+    BoxEdges(corners, color, mode);
+}
+
+void DebugDraw::Box(const glm::mat4& matrix, uint32_t color, Mode mode) {
+    glm::vec3 corners[8];
+    for (int i = 0; i < 8; ++i) {
+        glm::vec4 p((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : -1.0f, 1.0f);
+        corners[i] = glm::vec3(matrix * p);
+    }
+    BoxEdges(corners, color, mode);
+}
+
+void DebugDraw::Sphere(const glm::vec3& center, float radius, uint32_t color, Mode mode, int segments) {
+    segments = std::max(segments, 3);
+    Vertex* v = Append(mode, size_t(segments) * 6);
+    float step = glm::two_pi<float>() / segments;
+    for (int i = 0; i < segments; ++i) {
+        float c0 = std::cos(i * step) * radius, s0 = std::sin(i * step) * radius;
+        float c1 = std::cos((i + 1) * step) * radius, s1 = std::sin((i + 1) * step) * radius;
+        *v++ = { center + glm::vec3(c0, s0, 0.0f), color };
+        *v++ = { center + glm::vec3(c1, s1, 0.0f), color };
+        *v++ = { center + glm::vec3(c0, 0.0f, s0), color };
+        *v++ = { center + glm::vec3(c1, 0.0f, s1), color };
+        *v++ = { center + glm::vec3(0.0f, c0, s0), color };
+        *v++ = { center + glm::vec3(0.0f, c1, s1), color };
+    }
+}
+
+void DebugDraw::Arrow(const glm::vec3& from, const glm::vec3& to, uint32_t color, Mode mode, float headSize) {
+    glm::vec3 axis = to - from;
+    float length = glm::length(axis);
+    if (length <= 0.0f) return;
+    axis /= length;
+
+    // Any vector not parallel to the axis gives the head's side directions
+    glm::vec3 helper = std::abs(axis.y) < 0.99f ? glm::vec3(0, 1, 0) : glm::vec3(1, 0, 0);
+    glm::vec3 side = glm::normalize(glm::cross(axis, helper)) * headSize;
+    glm::vec3 up = glm::cross(axis, side);
+    glm::vec3 base = to - axis * (headSize * 2.0f);
+
+    Vertex* v = Append(mode, 10);
+    *v++ = { from, color };
+    *v++ = { to, color };
+    const glm::vec3 offsets[4] = { side, -side, up, -up };
+    for (const glm::vec3& offset : offsets) {
+        *v++ = { to, color };
+        *v++ = { base + offset, color };
+    }
+}
+
+void DebugDraw::Frustum(const glm::mat4& viewProjection, uint32_t color, Mode mode) {
+    // The frustum is the NDC cube mapped back to world space (with the perspective divide)
+    glm::mat4 inverse = glm::inverse(viewProjection);
+    glm::vec3 corners[8];
+    for (int i = 0; i < 8; ++i) {
+        glm::vec4 p = inverse * glm::vec4((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : -1.0f, 1.0f);
+        corners[i] = glm::vec3(p) / p.w;
+    }
+    BoxEdges(corners, color, mode);
+}
+
+void DebugDraw::Clear() {
+    m_Vertices[0].clear();
+    m_Vertices[1].clear();
+}
+
+void DebugDraw::Flush(const Shader& shader, const glm::mat4& view, const glm::mat4& projection) {
+    size_t total = GetVertexCount();
+    if (total == 0) return;
+
+    // Grow (to a power of two) so the ring holds a few frames like this one, otherwise orphan on wrap
+    if (total * kFramesPerRing > m_Capacity) {
+        size_t capacity = m_Capacity;
+        while (capacity < total * kFramesPerRing) capacity *= 2;
+        Reserve(capacity);
+    } else if (m_Head + total > m_Capacity) {
+        Reserve(m_Capacity);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+    void* mapped = glMapBufferRange(GL_ARRAY_BUFFER, m_Head * sizeof(Vertex), total * sizeof(Vertex),
+                                    GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+    if (!mapped) {
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        Clear();
+        return;
+    }
+    // Both queues go into one contiguous range: depth tested first, overlay right after
+    size_t depthCount = m_Vertices[0].size();
+    std::memcpy(mapped, m_Vertices[0].data(), depthCount * sizeof(Vertex));
+    std::memcpy(static_cast<Vertex*>(mapped) + depthCount, m_Vertices[1].data(), m_Vertices[1].size() * sizeof(Vertex));
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    FrameStats::CountUpload(total * sizeof(Vertex));
+
+    shader.Use();
+    shader.SetMat4("view", view);
+    shader.SetMat4("projection", projection);
+
+    // Lines only feed the color attachment; keep the object-id attachment (if any) untouched
+    glColorMaski(1, GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    glBindVertexArray(m_VAO);
+    GLint first = static_cast<GLint>(m_Head);
+    if (depthCount > 0) {
+        glEnable(GL_DEPTH_TEST);
+        glDrawArrays(GL_LINES, first, static_cast<GLsizei>(depthCount));
+        FrameStats::CountDraw(0);
+    }
+    if (!m_Vertices[1].empty()) {
+        glDisable(GL_DEPTH_TEST);
+        glDrawArrays(GL_LINES, first + static_cast<GLint>(depthCount), static_cast<GLsizei>(m_Vertices[1].size()));
+        FrameStats::CountDraw(0);
+        glEnable(GL_DEPTH_TEST);
+    }
+    glBindVertexArray(0);
+    FrameStats::CountStateChange();
+    glColorMaski(1, GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+    m_Head += total;
+    Clear();
+}
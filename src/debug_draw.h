@@ -0,0 +1,71 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "bvh.h"
+
+class Shader;
+
+// Packed RGBA8 color for debug vertices (byte order matches GL_UNSIGNED_BYTE x4 on little endian)
+constexpr uint32_t DebugColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255) {
+    return uint32_t(r) | (uint32_t(g) << 8) | (uint32_t(b) << 16) | (uint32_t(a) << 24);
+}
+
+// Debug lines for gizmos, bounds, frusta... Shapes are accumulated as line vertices during
+// the frame and Flush() draws them all with at most two draw calls (depth tested first,
+// then overlay), streaming them through a single ring-buffer VBO:
+//  - each frame's vertices are appended after the previous frame's with an unsynchronized
+//    map, so writing never waits on the GPU;
+//  - when the ring is full the buffer is orphaned (glBufferData(nullptr)) and writing starts
+//    over at offset 0; the driver keeps the old storage alive until the GPU is done with it.
+class DebugDraw {
+public:
+    enum class Mode { DepthTested = 0, Overlay = 1 };
+
+    DebugDraw();
+    ~DebugDraw() { Release(); }
+    DebugDraw(const DebugDraw&) = delete;
+    DebugDraw& operator=(const DebugDraw&) = delete;
+
+    // Deletes the GL objects; call while the context is still current (the destructor then does nothing)
+    void Release();
+
+    void Line(const glm::vec3& a, const glm::vec3& b, uint32_t color, Mode mode = Mode::DepthTested);
+    void Box(const AABB& box, uint32_t color, Mode mode = Mode::DepthTested);
+    // Unit cube [-1, 1]^3 transformed by matrix (oriented boxes)
+    void Box(const glm::mat4& matrix, uint32_t color, Mode mode = Mode::DepthTested);
+    // Three great circles
+    void Sphere(const glm::vec3& center, float radius, uint32_t color, Mode mode = Mode::DepthTested, int segments = 24);
+    void Arrow(const glm::vec3& from, const glm::vec3& to, uint32_t color, Mode mode = Mode::DepthTested, float headSize = 0.1f);
+    // Frustum of a view-projection matrix (corners unprojected from the NDC cube)
+    void Frustum(const glm::mat4& viewProjection, uint32_t color, Mode mode = Mode::DepthTested);
+
+    // Draws everything queued since the last flush into the bound framebuffer, then clears the queues.
+    // Only color attachment 0 is written (object ids under the lines are kept).
+    void Flush(const Shader& shader, const glm::mat4& view, const glm::mat4& projection);
+    void Clear();
+
+    size_t GetVertexCount() const { return m_Vertices[0].size() + m_Vertices[1].size(); }
+    size_t GetCapacity() const { return m_Capacity; } // ring size in vertices
+
+private:
+    struct Vertex {
+        glm::vec3 position;
+        uint32_t color;
+    };
+
+    // Reserves count vertices at the end of a queue and returns where to write them
+    Vertex* Append(Mode mode, size_t count);
+    // The 12 edges of a box given its corners indexed by bits (x, y, z)
+    void BoxEdges(const glm::vec3 corners[8], uint32_t color, Mode mode);
+    void Reserve(size_t vertexCount);
+
+    std::vector<Vertex> m_Vertices[2]; // per Mode
+    GLuint m_VAO = 0;
+    GLuint m_VBO = 0;
+    size_t m_Capacity = 0; // in vertices
+    size_t m_Head = 0;     // next free vertex in the ring
+};
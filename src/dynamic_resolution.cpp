@@ -0,0 +1,50 @@
+#include "dynamic_resolution.h"
+#include <algorithm>
+#include <cmath>
+
+void DynamicResolution::SetEnabled(bool enabled) {
+    if (enabled == m_Enabled) return;
+    m_Enabled = enabled;
+    m_Scale = m_MaxScale;
+    m_SmoothedMs = 0.0;
+    m_FramesSinceChange = 0;
+}
+
+void DynamicResolution::SetScaleRange(float minScale, float maxScale) {
+    m_MinScale = std::max(0.05f, std::min(minScale, 1.0f));
+    m_MaxScale = std::max(m_MinScale, std::min(maxScale, 1.0f));
+    m_Scale = std::max(m_MinScale, std::min(m_Scale, m_MaxScale));
+}
+
+float DynamicResolution::Update(double gpuMs) {
+    if (!m_Enabled) {
+        m_Scale = m_MaxScale;
+        return m_Scale;
+    }
+    if (gpuMs <= 0.0) return m_Scale;
+
+    // Only frames rendered after the last change describe the current scale
+    if (++m_FramesSinceChange <= kSettleFrames) {
+        m_SmoothedMs = gpuMs;
+        return m_Scale;
+    }
+    m_SmoothedMs = m_SmoothedMs * 0.75 + gpuMs * 0.25;
+
+    // Over budget: shrink. Well under budget (below 80%): grow, a bounded step at a time.
+    double target = static_cast<double>(m_TargetMs);
+    bool over = m_SmoothedMs > target * 1.05;
+    bool under = m_SmoothedMs < target * 0.8 && m_Scale < m_MaxScale;
+    if (!over && !under) return m_Scale;
+
+    float wanted = m_Scale * static_cast<float>(std::sqrt(target / m_SmoothedMs));
+    if (under) wanted = std::min(wanted, m_Scale + kMaxStepUp);
+    wanted = std::floor(wanted / kStep + 0.5f) * kStep;
+    if (over && wanted >= m_Scale) wanted = m_Scale - kStep; // rounding must not stall a needed drop
+    wanted = std::max(m_MinScale, std::min(wanted, m_MaxScale));
+
+    if (wanted != m_Scale) {
+        m_Scale = wanted;
+        m_FramesSinceChange = 0;
+    }
+    return m_Scale;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+// DynamicResolution picks the viewport's render scale (fraction of the framebuffer size per
+// axis) from the measured GPU time of the scene pass, so the viewport holds a frame-time
+// budget while the camera moves instead of dropping frames.
+//
+// Pixel cost grows with scale^2, so a correction of sqrt(target / measured) is applied.
+// Measurements are smoothed, and after every change the controller waits a few frames:
+// GPU timer results lag by a frame or two and would otherwise still describe the old scale.
+// Downscaling reacts quickly; upscaling only when there is clear headroom (hysteresis).
+class DynamicResolution {
+public:
+    void SetEnabled(bool enabled);
+    bool IsEnabled() const { return m_Enabled; }
+    void SetTargetMs(float targetMs) { m_TargetMs = targetMs > 0.1f ? targetMs : 0.1f; }
+    float GetTargetMs() const { return m_TargetMs; }
+    void SetScaleRange(float minScale, float maxScale);
+
+    // Feed the GPU time (ms) of a frame rendered at the current scale; returns the scale
+    // to render the next frame at. Non-positive times (no query resolved yet) are ignored.
+    float Update(double gpuMs);
+    float GetScale() const { return m_Scale; }
+
+private:
+    static const int kSettleFrames = 4;       // > GPU timer read-back latency
+    static constexpr float kStep = 1.0f / 32.0f; // scales are quantized to avoid churn
+    static constexpr float kMaxStepUp = 0.1f;
+
+    bool m_Enabled = false;
+    float m_TargetMs = 8.0f;
+    float m_MinScale = 0.5f;
+    float m_MaxScale = 1.0f;
+    float m_Scale = 1.0f;
+    double m_SmoothedMs = 0.0;
+    int m_FramesSinceChange = 0;
+};
@@ -0,0 +1,383 @@
+#include "ecs.h"
+#include "arena.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+
+// ------------------------------------------------------------------------------------
+// Component registry
+// ------------------------------------------------------------------------------------
+
+namespace {
+    std::mutex& RegistryMutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    // Fixed storage so lookups never race with a registration growing the table
+    struct ComponentRegistry {
+        ComponentInfo infos[kMaxComponents];
+        uint32_t count = 0;
+    };
+
+    ComponentRegistry& Registry() {
+        static ComponentRegistry registry;
+        return registry;
+    }
+
+    size_t AlignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    const size_t kChunkAlignment = 64;
+    const size_t kMinChangeLog = 4096; // entries kept before the log may be dropped
+
+    void MoveComponent(const ComponentInfo& info, void* dst, void* src) {
+        if (info.moveConstruct) {
+            info.moveConstruct(dst, src);
+            if (info.destroy) info.destroy(src);
+        } else {
+            std::memcpy(dst, src, info.size);
+        }
+    }
+}
+
+namespace ecs_detail {
+    ComponentId RegisterComponent(const ComponentInfo& info) {
+        std::lock_guard<std::mutex> lock(RegistryMutex());
+        ComponentRegistry& registry = Registry();
+        if (registry.count >= kMaxComponents) {
+            std::cerr << "ECS: too many component types (max " << kMaxComponents << "), failed to register "
+                      << info.name << std::endl;
+            std::abort();
+        }
+        registry.infos[registry.count] = info;
+        return registry.count++;
+    }
+
+    const ComponentInfo& GetComponentInfo(ComponentId id) {
+        // An id is only handed out after its entry is written
+        return Registry().infos[id];
+    }
+}
+
+// ------------------------------------------------------------------------------------
+// Archetype
+// ------------------------------------------------------------------------------------
+
+Archetype::Archetype(World* world, ComponentMask mask)
+    : m_World(world)
+    , m_Mask(mask)
+{
+    size_t bytesPerEntity = sizeof(Entity);
+    size_t padding = 0;
+    for (ComponentId id = 0; id < kMaxComponents; ++id) {
+        if (!Has(id)) continue;
+        const ComponentInfo& info = ecs_detail::GetComponentInfo(id);
+        m_ComponentIds.push_back(id);
+        if (info.destroy) m_HasDestructors = true;
+        bytesPerEntity += info.size;
+        padding += info.alignment;
+    }
+
+    // Fit as many entities as possible into one chunk, but always at least one
+    size_t usable = World::kChunkSize > padding ? World::kChunkSize - padding : 0;
+    m_Capacity = static_cast<uint32_t>(std::max<size_t>(1, usable / bytesPerEntity));
+
+    size_t offset = sizeof(Entity) * m_Capacity;
+    for (ComponentId id : m_ComponentIds) {
+        const ComponentInfo& info = ecs_detail::GetComponentInfo(id);
+        offset = AlignUp(offset, info.alignment);
+        m_Offsets[id] = offset;
+        m_Sizes[id] = info.size;
+        offset += info.size * m_Capacity;
+    }
+    m_ChunkBytes = AlignUp(std::max(offset, World::kChunkSize), kChunkAlignment);
+}
+
+Archetype::~Archetype() {
+    Clear();
+}
+
+void Archetype::Clear() {
+    // Arena chunks are reclaimed by the arena's Reset(): nothing to visit
+    if (!m_HasDestructors && m_World->HasArena()) {
+        m_Chunks.clear();
+        return;
+    }
+    for (Chunk& chunk : m_Chunks) {
+        if (m_HasDestructors) {
+            for (ComponentId id : m_ComponentIds) {
+                const ComponentInfo& info = ecs_detail::GetComponentInfo(id);
+                if (!info.destroy) continue;
+                for (uint32_t row = 0; row < chunk.count; ++row) {
+                    info.destroy(GetComponent(chunk, id, row));
+                }
+            }
+        }
+        m_World->FreeChunkMemory(chunk.memory, m_ChunkBytes);
+    }
+    m_Chunks.clear();
+}
+
+size_t Archetype::GetEntityCount() const {
+    if (m_Chunks.empty()) return 0;
+    return (m_Chunks.size() - 1) * m_Capacity + m_Chunks.back().count;
+}
+
+void Archetype::AllocateRow(Entity entity, uint32_t& outChunk, uint32_t& outRow) {
+    // All chunks but the last are always full
+    if (m_Chunks.empty() || m_Chunks.back().count == m_Capacity) {
+        Chunk chunk;
+        chunk.memory = m_World->AllocateChunkMemory(m_ChunkBytes);
+        chunk.count = 0;
+        m_Chunks.push_back(chunk);
+    }
+
+    Chunk& chunk = m_Chunks.back();
+    outChunk = static_cast<uint32_t>(m_Chunks.size() - 1);
+    outRow = chunk.count++;
+    chunk.GetEntities()[outRow] = entity;
+}
+
+Entity Archetype::RemoveRow(uint32_t chunkIndex, uint32_t row) {
+    Chunk& last = m_Chunks.back();
+    uint32_t lastRow = last.count - 1;
+    Entity moved;
+
+    if (&m_Chunks[chunkIndex] != &last || row != lastRow) {
+        Chunk& hole = m_Chunks[chunkIndex];
+        for (ComponentId id : m_ComponentIds) {
+            MoveComponent(ecs_detail::GetComponentInfo(id), GetComponent(hole, id, row), GetComponent(last, id, lastRow));
+        }
+        moved = last.GetEntities()[lastRow];
+        hole.GetEntities()[row] = moved;
+    }
+
+    if (--last.count == 0) {
+        m_World->FreeChunkMemory(last.memory, m_ChunkBytes);
+        m_Chunks.pop_back();
+    }
+    return moved;
+}
+
+// ------------------------------------------------------------------------------------
+// World
+// ------------------------------------------------------------------------------------
+
+World::World(Arena* arena)
+    : m_Arena(arena)
+{
+    m_EmptyArchetype = GetOrCreateArchetype(0);
+}
+
+World::~World() {
+    // Archetypes hand their chunks back through FreeChunkMemory, so drop them first
+    m_Archetypes.clear();
+    m_ArchetypeByMask.clear();
+    for (uint8_t* memory : m_FreeChunks) ReleaseChunkMemory(memory);
+}
+
+uint8_t* World::AllocateChunkMemory(size_t bytes) {
+    if (bytes == kChunkSize && !m_FreeChunks.empty()) {
+        uint8_t* memory = m_FreeChunks.back();
+        m_FreeChunks.pop_back();
+        return memory;
+    }
+    if (m_Arena) return static_cast<uint8_t*>(m_Arena->Allocate(bytes, kChunkAlignment));
+    return static_cast<uint8_t*>(::operator new(bytes, std::align_val_t(kChunkAlignment)));
+}
+
+void World::FreeChunkMemory(uint8_t* memory, size_t bytes) {
+    // Standard-size chunks are recycled; oversized ones (huge components) go straight back
+    if (bytes == kChunkSize) {
+        m_FreeChunks.push_back(memory);
+    } else {
+        ReleaseChunkMemory(memory);
+    }
+}
+
+void World::ReleaseChunkMemory(uint8_t* memory) {
+    if (!m_Arena) ::operator delete(memory, std::align_val_t(kChunkAlignment));
+}
+
+void World::Clear() {
+    for (Archetype* archetype : m_Archetypes) {
+        archetype->Clear();
+    }
+
+    if (m_Arena) {
+        // The arena owner resets it after this; nothing here may point into it anymore
+        m_FreeChunks.clear();
+    }
+
+    // Records and the free list go as a whole (capacity kept); every handle issued so far
+    // carries a generation <= the ceiling, and recreated records start above it
+    m_Records.clear();
+    m_FreeIndices.clear();
+    m_GenerationBase = m_GenerationCeiling + 1;
+    m_GenerationCeiling = m_GenerationBase;
+    m_LiveCount = 0;
+    // The destroyed entities aren't logged one by one: the log restarts a position further
+    // on, so every reader, even one that was caught up, is behind it and rescans
+    DropChangeLog();
+    ++m_ChangeLogStart;
+    ++m_StructureVersion;
+}
+
+void World::Reserve(size_t entityCount) {
+    m_Records.reserve(entityCount);
+}
+
+Entity World::CreateEntity() {
+    return CreateEntityIn(m_EmptyArchetype);
+}
+
+Entity World::CreateEntityIn(Archetype* archetype) {
+    Entity entity;
+    if (!m_FreeIndices.empty()) {
+        entity.index = m_FreeIndices.back();
+        m_FreeIndices.pop_back();
+    } else {
+        entity.index = static_cast<uint32_t>(m_Records.size());
+        m_Records.emplace_back();
+        m_Records.back().generation = m_GenerationBase;
+    }
+
+    EntityRecord& record = m_Records[entity.index];
+    entity.generation = record.generation;
+    record.alive = true;
+    record.archetype = archetype;
+    archetype->AllocateRow(entity, record.chunk, record.row);
+    ++m_LiveCount;
+    ++m_StructureVersion;
+    LogChange(entity);
+    return entity;
+}
+
+void World::DestroyEntity(Entity entity) {
+    if (!IsAlive(entity)) return;
+
+    EntityRecord& record = m_Records[entity.index];
+    Archetype* archetype = record.archetype;
+    Chunk& chunk = archetype->GetChunks()[record.chunk];
+    if (archetype->HasDestructors()) {
+        for (ComponentId id : archetype->GetComponentIds()) {
+            const ComponentInfo& info = ecs_detail::GetComponentInfo(id);
+            if (info.destroy) info.destroy(archetype->GetComponent(chunk, id, record.row));
+        }
+    }
+
+    uint32_t chunkIndex = record.chunk;
+    uint32_t row = record.row;
+    Entity moved = archetype->RemoveRow(chunkIndex, row);
+    if (moved.IsValid()) FixMovedEntity(moved, chunkIndex, row);
+
+    record.alive = false;
+    record.archetype = nullptr;
+    m_GenerationCeiling = std::max(m_GenerationCeiling, ++record.generation);
+    m_FreeIndices.push_back(entity.index);
+    --m_LiveCount;
+    ++m_StructureVersion;
+    LogChange(entity);
+}
+
+bool World::IsAlive(Entity entity) const {
+    return entity.index < m_Records.size() &&
+           m_Records[entity.index].alive &&
+           m_Records[entity.index].generation == entity.generation;
+}
+
+Entity World::FindByIndex(uint32_t index) const {
+    Entity entity;
+    if (index < m_Records.size() && m_Records[index].alive) {
+        entity.index = index;
+        entity.generation = m_Records[index].generation;
+    }
+    return entity;
+}
+
+Archetype* World::GetOrCreateArchetype(ComponentMask mask) {
+    auto it = m_ArchetypeByMask.find(mask);
+    if (it != m_ArchetypeByMask.end()) return it->second.get();
+
+    std::unique_ptr<Archetype> archetype(new Archetype(this, mask));
+    Archetype* raw = archetype.get();
+    m_ArchetypeByMask.emplace(mask, std::move(archetype));
+    m_Archetypes.push_back(raw);
+    return raw;
+}
+
+Archetype* World::GetAddTarget(Archetype* from, ComponentId id) {
+    auto it = from->addEdges.find(id);
+    if (it != from->addEdges.end()) return it->second;
+
+    Archetype* to = GetOrCreateArchetype(from->GetMask() | (ComponentMask(1) << id));
+    from->addEdges[id] = to;
+    to->removeEdges[id] = from;
+    return to;
+}
+
+Archetype* World::GetRemoveTarget(Archetype* from, ComponentId id) {
+    auto it = from->removeEdges.find(id);
+    if (it != from->removeEdges.end()) return it->second;
+
+    Archetype* to = GetOrCreateArchetype(from->GetMask() & ~(ComponentMask(1) << id));
+    from->removeEdges[id] = to;
+    to->addEdges[id] = from;
+    return to;
+}
+
+void World::MoveEntity(Entity entity, Archetype* to) {
+    EntityRecord& record = m_Records[entity.index];
+    Archetype* from = record.archetype;
+    uint32_t fromChunkIndex = record.chunk;
+    uint32_t fromRow = record.row;
+
+    uint32_t toChunkIndex = 0;
+    uint32_t toRow = 0;
+    to->AllocateRow(entity, toChunkIndex, toRow);
+
+    // Move shared components across, destroy the ones the target doesn't have
+    Chunk& fromChunk = from->GetChunks()[fromChunkIndex];
+    Chunk& toChunk = to->GetChunks()[toChunkIndex];
+    for (ComponentId id : from->GetComponentIds()) {
+        const ComponentInfo& info = ecs_detail::GetComponentInfo(id);
+        void* src = from->GetComponent(fromChunk, id, fromRow);
+        if (to->Has(id)) {
+            MoveComponent(info, to->GetComponent(toChunk, id, toRow), src);
+        } else if (info.destroy) {
+            info.destroy(src);
+        }
+    }
+
+    Entity moved = from->RemoveRow(fromChunkIndex, fromRow);
+    if (moved.IsValid()) FixMovedEntity(moved, fromChunkIndex, fromRow);
+
+    record.archetype = to;
+    record.chunk = toChunkIndex;
+    record.row = toRow;
+    ++m_StructureVersion;
+    LogChange(entity);
+}
+
+void World::FixMovedEntity(Entity moved, uint32_t chunk, uint32_t row) {
+    EntityRecord& record = m_Records[moved.index];
+    record.chunk = chunk;
+    record.row = row;
+}
+
+// Readers behind a dropped log rescan once, which costs about as much as replaying it would
+// have: the log never holds many more entries than there are live entities
+void World::LogChange(Entity entity) {
+    if (m_ChangeLog.size() >= kMinChangeLog && m_ChangeLog.size() > m_LiveCount) DropChangeLog();
+    m_ChangeLog.push_back(entity);
+}
+
+void World::DropChangeLog() {
+    m_ChangeLogStart += m_ChangeLog.size();
+    m_ChangeLog.clear();
+}
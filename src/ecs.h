@@ -0,0 +1,390 @@
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "job_system.h"
+
+class Arena;
+class World;
+
+// ------------------------------------------------------------------------------------
+// Archetype/chunk based entity component system.
+//
+// Entities with the same set of components share an Archetype. An archetype stores its
+// entities in fixed-size Chunks (16 KB), and inside a chunk every component type has
+// its own contiguous array, so a query walks plain arrays chunk after chunk.
+// Chunks stay packed: removing an entity moves the archetype's last entity into the hole.
+//
+// Adding or removing a component moves the entity to another archetype; those moves
+// (and Create/Destroy) are structural changes and must happen on the main thread,
+// never from inside a query or a system running on the JobSystem.
+// ------------------------------------------------------------------------------------
+
+using ComponentId = uint32_t;
+using ComponentMask = uint64_t;
+static constexpr ComponentId kMaxComponents = 64;
+
+struct Entity {
+    static constexpr uint32_t kInvalidIndex = 0xFFFFFFFFu;
+
+    uint32_t index = kInvalidIndex;
+    uint32_t generation = 0;
+
+    bool IsValid() const { return index != kInvalidIndex; }
+    bool operator==(const Entity& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const Entity& other) const { return !(*this == other); }
+
+    // Packed form for places that store an opaque 64-bit id (e.g. TransformSystem user data)
+    uint64_t ToUint64() const { return (static_cast<uint64_t>(generation) << 32) | index; }
+    static Entity FromUint64(uint64_t value) {
+        Entity e;
+        e.index = static_cast<uint32_t>(value & 0xFFFFFFFFu);
+        e.generation = static_cast<uint32_t>(value >> 32);
+        return e;
+    }
+};
+
+// Type-erased operations the World needs to move components between chunks.
+// Left null for trivially copyable / destructible types, which are moved with memcpy
+// and never destroyed (so a scene made only of them unloads without touching its rows).
+struct ComponentInfo {
+    const char* name = "";
+    size_t size = 0;
+    size_t alignment = 1;
+    void (*moveConstruct)(void* dst, void* src) = nullptr;
+    void (*destroy)(void* ptr) = nullptr;
+};
+
+namespace ecs_detail {
+    ComponentId RegisterComponent(const ComponentInfo& info);
+    const ComponentInfo& GetComponentInfo(ComponentId id);
+
+    template <typename T>
+    ComponentInfo MakeComponentInfo(const char* name) {
+        ComponentInfo info;
+        info.name = name;
+        info.size = sizeof(T);
+        info.alignment = alignof(T);
+        if (!std::is_trivially_copyable<T>::value) {
+            info.moveConstruct = [](void* dst, void* src) { new (dst) T(std::move(*static_cast<T*>(src))); };
+        }
+        if (!std::is_trivially_destructible<T>::value) {
+            info.destroy = [](void* ptr) { static_cast<T*>(ptr)->~T(); };
+        }
+        return info;
+    }
+}
+
+// Unique id per component type, assigned on first use
+template <typename T>
+ComponentId GetComponentId() {
+    static const ComponentId id = ecs_detail::RegisterComponent(ecs_detail::MakeComponentInfo<T>(typeid(T).name()));
+    return id;
+}
+
+template <typename... Ts>
+ComponentMask MakeComponentMask() {
+    ComponentMask mask = 0;
+    using Expand = int[];
+    (void)Expand{ 0, (mask |= (ComponentMask(1) << GetComponentId<Ts>()), 0)... };
+    return mask;
+}
+
+struct Chunk {
+    uint8_t* memory = nullptr; // [Entity x capacity][component arrays...]
+    uint32_t count = 0;
+
+    Entity* GetEntities() const { return reinterpret_cast<Entity*>(memory); }
+};
+
+class Archetype {
+public:
+    Archetype(World* world, ComponentMask mask);
+    ~Archetype();
+
+    Archetype(const Archetype&) = delete;
+    Archetype& operator=(const Archetype&) = delete;
+
+    ComponentMask GetMask() const { return m_Mask; }
+    bool Has(ComponentId id) const { return (m_Mask >> id) & 1; }
+    uint32_t GetChunkCapacity() const { return m_Capacity; }
+    size_t GetEntityCount() const;
+    // True if any component needs its destructor run
+    bool HasDestructors() const { return m_HasDestructors; }
+
+    // Byte offset of a component array inside each chunk
+    size_t GetOffset(ComponentId id) const { return m_Offsets[id]; }
+    void* GetComponent(const Chunk& chunk, ComponentId id, uint32_t row) const {
+        return chunk.memory + m_Offsets[id] + row * m_Sizes[id];
+    }
+
+    std::vector<Chunk>& GetChunks() { return m_Chunks; }
+    const std::vector<ComponentId>& GetComponentIds() const { return m_ComponentIds; }
+
+    // Appends a row for the entity (components left unconstructed)
+    void AllocateRow(Entity entity, uint32_t& outChunk, uint32_t& outRow);
+    // Fills the hole at (chunk,row), whose components must already be destroyed, with the
+    // last entity. Returns that entity (invalid if the hole was the last row).
+    Entity RemoveRow(uint32_t chunk, uint32_t row);
+    // Destroys every row and hands the chunks back to the World
+    void Clear();
+
+    // Cached archetype graph edges for add/remove of a single component
+    std::unordered_map<ComponentId, Archetype*> addEdges;
+    std::unordered_map<ComponentId, Archetype*> removeEdges;
+
+private:
+    World* m_World;
+    ComponentMask m_Mask;
+    bool m_HasDestructors = false;
+    std::vector<ComponentId> m_ComponentIds;
+    size_t m_Offsets[kMaxComponents] = {};
+    size_t m_Sizes[kMaxComponents] = {};
+    size_t m_ChunkBytes = 0;
+    uint32_t m_Capacity = 0;
+    std::vector<Chunk> m_Chunks;
+};
+
+class World {
+public:
+    static constexpr size_t kChunkSize = 16 * 1024;
+
+    // With an arena, chunk memory comes from it and is never freed individually:
+    // unloading is Clear() followed by Arena::Reset(). Without one, chunks use the heap.
+    explicit World(Arena* arena = nullptr);
+    ~World();
+
+    World(const World&) = delete;
+    World& operator=(const World&) = delete;
+
+    Entity CreateEntity();
+    // Creates the entity directly in its final archetype (no per-Add moves); used for bulk loads
+    template <typename... Ts>
+    Entity Spawn(Ts... components);
+    void DestroyEntity(Entity entity);
+    bool IsAlive(Entity entity) const;
+    // Live handle currently occupying a raw index (e.g. one read back from the GPU ID buffer);
+    // invalid if the slot is free
+    Entity FindByIndex(uint32_t index) const;
+    size_t GetEntityCount() const { return m_LiveCount; }
+    // Bumped by every structural change (create/destroy/add/remove/clear), so caches
+    // built from queries can tell when to rebuild
+    uint64_t GetStructureVersion() const { return m_StructureVersion; }
+
+    // Structural change log, for caches that follow the World entity by entity instead of
+    // re-querying it: every entity created, destroyed or moved to another archetype (component
+    // added or removed) is appended, in order. Positions are absolute; a reader keeps the end
+    // it last read up to. The log is dropped by Clear() and whenever it outgrows the live entity
+    // count; a reader whose position is below GetChangeLogStart() missed entries and rescans.
+    uint64_t GetChangeLogStart() const { return m_ChangeLogStart; }
+    uint64_t GetChangeLogEnd() const { return m_ChangeLogStart + m_ChangeLog.size(); }
+    // The entity logged at position (in [start, end)); it may be dead by now
+    Entity GetLoggedChange(uint64_t position) const { return m_ChangeLog[position - m_ChangeLogStart]; }
+
+    // Reserve entity records up front (avoids regrowth when spawning millions)
+    void Reserve(size_t entityCount);
+
+    // Destroys every entity. Handles from before the call read as dead afterwards.
+    // Archetypes whose components are all trivially destructible are dropped without
+    // visiting their rows or chunks when the chunk memory comes from an arena, and the
+    // entity records are dropped as a whole: new records start at a generation above any
+    // handed out before (see m_GenerationBase), so stale handles can't match them. With an
+    // arena and trivially destructible components, the cost is per archetype, not per entity.
+    void Clear();
+    bool HasArena() const { return m_Arena != nullptr; }
+
+    // Chunk memory, used by archetypes
+    uint8_t* AllocateChunkMemory(size_t bytes);
+    void FreeChunkMemory(uint8_t* memory, size_t bytes);
+
+    template <typename T>
+    T& Add(Entity entity, T value = T());
+
+    template <typename T>
+    void Remove(Entity entity);
+
+    template <typename T>
+    bool Has(Entity entity) const;
+
+    // nullptr if the entity is dead or lacks the component
+    template <typename T>
+    T* Get(Entity entity);
+
+    // Calls fn(Entity, Ts&...) for every entity that has all of Ts, chunk by chunk
+    template <typename... Ts, typename Fn>
+    void Each(Fn&& fn);
+
+    // Calls fn(count, const Entity*, Ts*...) once per matching chunk
+    template <typename... Ts, typename Fn>
+    void EachChunk(Fn&& fn);
+
+    // Same as EachChunk, with the matching chunks spread over the job system
+    template <typename... Ts, typename Fn>
+    void ParallelEachChunk(JobSystem* jobs, Fn&& fn);
+
+private:
+    struct EntityRecord {
+        Archetype* archetype = nullptr;
+        uint32_t chunk = 0;
+        uint32_t row = 0;
+        uint32_t generation = 0;
+        bool alive = false;
+    };
+
+    Entity CreateEntityIn(Archetype* archetype);
+    Archetype* GetOrCreateArchetype(ComponentMask mask);
+    Archetype* GetAddTarget(Archetype* from, ComponentId id);
+    Archetype* GetRemoveTarget(Archetype* from, ComponentId id);
+    void MoveEntity(Entity entity, Archetype* to);
+    void FixMovedEntity(Entity moved, uint32_t chunk, uint32_t row);
+    void LogChange(Entity entity);
+    void DropChangeLog();
+
+    template <typename... Ts, typename Fn, size_t... I>
+    static void RunChunk(Chunk& chunk, const size_t* offsets, Fn& fn, std::index_sequence<I...>);
+
+    std::vector<EntityRecord> m_Records;
+    std::vector<uint32_t> m_FreeIndices;
+    uint32_t m_GenerationBase = 0;    // generation of records created from scratch
+    uint32_t m_GenerationCeiling = 0; // highest generation any handle may carry
+    size_t m_LiveCount = 0;
+    uint64_t m_StructureVersion = 0;
+    std::vector<Entity> m_ChangeLog;
+    uint64_t m_ChangeLogStart = 0; // absolute position of m_ChangeLog[0]
+
+    void ReleaseChunkMemory(uint8_t* memory);
+
+    Arena* m_Arena;
+    std::vector<uint8_t*> m_FreeChunks; // kChunkSize blocks ready for reuse
+
+    std::unordered_map<ComponentMask, std::unique_ptr<Archetype>> m_ArchetypeByMask;
+    std::vector<Archetype*> m_Archetypes; // creation order, for queries
+    Archetype* m_EmptyArchetype = nullptr;
+};
+
+// ------------------------------------------------------------------------------------
+// Template implementation
+// ------------------------------------------------------------------------------------
+
+template <typename... Ts>
+Entity World::Spawn(Ts... components) {
+    Entity entity = CreateEntityIn(GetOrCreateArchetype(MakeComponentMask<Ts...>()));
+    EntityRecord& record = m_Records[entity.index];
+    Chunk& chunk = record.archetype->GetChunks()[record.chunk];
+    using Expand = int[];
+    (void)Expand{ 0, (new (record.archetype->GetComponent(chunk, GetComponentId<Ts>(), record.row)) Ts(std::move(components)), 0)... };
+    return entity;
+}
+
+template <typename T>
+T& World::Add(Entity entity, T value) {
+    assert(IsAlive(entity));
+    ComponentId id = GetComponentId<T>();
+    EntityRecord& record = m_Records[entity.index];
+
+    if (!record.archetype->Has(id)) {
+        MoveEntity(entity, GetAddTarget(record.archetype, id));
+        Chunk& chunk = record.archetype->GetChunks()[record.chunk];
+        return *new (record.archetype->GetComponent(chunk, id, record.row)) T(std::move(value));
+    }
+
+    Chunk& chunk = record.archetype->GetChunks()[record.chunk];
+    T* existing = static_cast<T*>(record.archetype->GetComponent(chunk, id, record.row));
+    *existing = std::move(value);
+    return *existing;
+}
+
+template <typename T>
+void World::Remove(Entity entity) {
+    if (!IsAlive(entity)) return;
+    ComponentId id = GetComponentId<T>();
+    EntityRecord& record = m_Records[entity.index];
+    if (!record.archetype->Has(id)) return;
+    MoveEntity(entity, GetRemoveTarget(record.archetype, id));
+}
+
+template <typename T>
+bool World::Has(Entity entity) const {
+    return IsAlive(entity) && m_Records[entity.index].archetype->Has(GetComponentId<T>());
+}
+
+template <typename T>
+T* World::Get(Entity entity) {
+    if (!IsAlive(entity)) return nullptr;
+    ComponentId id = GetComponentId<T>();
+    EntityRecord& record = m_Records[entity.index];
+    if (!record.archetype->Has(id)) return nullptr;
+    Chunk& chunk = record.archetype->GetChunks()[record.chunk];
+    return static_cast<T*>(record.archetype->GetComponent(chunk, id, record.row));
+}
+
+template <typename... Ts, typename Fn, size_t... I>
+void World::RunChunk(Chunk& chunk, const size_t* offsets, Fn& fn, std::index_sequence<I...>) {
+    const Entity* entities = chunk.GetEntities();
+    std::tuple<Ts*...> columns(reinterpret_cast<Ts*>(chunk.memory + offsets[I])...);
+    for (uint32_t i = 0; i < chunk.count; ++i) {
+        fn(entities[i], std::get<I>(columns)[i]...);
+    }
+}
+
+template <typename... Ts, typename Fn>
+void World::Each(Fn&& fn) {
+    static_assert(sizeof...(Ts) > 0, "Each needs at least one component type");
+    ComponentMask mask = MakeComponentMask<Ts...>();
+    for (Archetype* archetype : m_Archetypes) {
+        if ((archetype->GetMask() & mask) != mask) continue;
+        const size_t offsets[] = { archetype->GetOffset(GetComponentId<Ts>())... };
+        for (Chunk& chunk : archetype->GetChunks()) {
+            RunChunk<Ts...>(chunk, offsets, fn, std::index_sequence_for<Ts...>{});
+        }
+    }
+}
+
+template <typename... Ts, typename Fn>
+void World::EachChunk(Fn&& fn) {
+    static_assert(sizeof...(Ts) > 0, "EachChunk needs at least one component type");
+    ComponentMask mask = MakeComponentMask<Ts...>();
+    for (Archetype* archetype : m_Archetypes) {
+        if ((archetype->GetMask() & mask) != mask) continue;
+        for (Chunk& chunk : archetype->GetChunks()) {
+            fn(static_cast<size_t>(chunk.count), static_cast<const Entity*>(chunk.GetEntities()),
+               reinterpret_cast<Ts*>(chunk.memory + archetype->GetOffset(GetComponentId<Ts>()))...);
+        }
+    }
+}
+
+template <typename... Ts, typename Fn>
+void World::ParallelEachChunk(JobSystem* jobs, Fn&& fn) {
+    if (!jobs) {
+        EachChunk<Ts...>(fn);
+        return;
+    }
+
+    struct ChunkRef { Archetype* archetype; Chunk* chunk; };
+    std::vector<ChunkRef> chunks;
+    ComponentMask mask = MakeComponentMask<Ts...>();
+    for (Archetype* archetype : m_Archetypes) {
+        if ((archetype->GetMask() & mask) != mask) continue;
+        for (Chunk& chunk : archetype->GetChunks()) {
+            chunks.push_back({ archetype, &chunk });
+        }
+    }
+
+    jobs->ParallelFor(chunks.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; ++c) {
+            Chunk& chunk = *chunks[c].chunk;
+            Archetype* archetype = chunks[c].archetype;
+            fn(static_cast<size_t>(chunk.count), static_cast<const Entity*>(chunk.GetEntities()),
+               reinterpret_cast<Ts*>(chunk.memory + archetype->GetOffset(GetComponentId<Ts>()))...);
+        }
+    });
+}
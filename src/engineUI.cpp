@@ -1,5 +1,7 @@
 #include "engineUI.h"
 #include "imgui.h"
+#include "frame_stats.h"
+#include "gl_trace.h"
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_opengl3.h"
 #include <iostream>
@@ -9,19 +11,43 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include "camera.h"
 #include "shader.h"
+#include "mesh.h"
+#include "debug_draw.h"
+#include "spatial_index.h"
+#include "log.h"
+#include "frame_capture.h"
+#include <ctime>
 
 void EngineUI::SetFramebuffer(Framebuffer* framebuffer) {
     m_Framebuffer = framebuffer;
 }
 
-// --- NEW: To link scene objects from main.cpp ---
-void EngineUI::SetSceneObjects(std::vector<GameObject*>* objects) {
-    m_SceneObjectsPtr = objects;
+EngineUI::EngineUI() {
+    // m_Selection starts empty.
 }
 
-EngineUI::EngineUI() {
-    // Constructor might initialize m_SelectedObjectPtr to nullptr if needed,
-    // but it's default initialized as a member.
+TransformHandle EngineUI::GetSelectedTransform() {
+    if (!HasSelection()) return TransformHandle();
+    TransformComponent* transform = m_World->Get<TransformComponent>(m_Selection.GetPrimary());
+    return transform ? transform->handle : TransformHandle();
+}
+
+const char* EngineUI::GetEntityName(Entity entity) {
+    NameComponent* name = m_World ? m_World->Get<NameComponent>(entity) : nullptr;
+    return name ? name->value : "<unnamed>";
+}
+
+Entity EngineUI::GetEntityOf(TransformHandle handle) const {
+    if (!m_Transforms || !m_Transforms->IsAlive(handle)) return Entity();
+    return Entity::FromUint64(m_Transforms->GetUserData(handle));
+}
+
+bool EngineUI::HasSelectedAncestor(TransformHandle handle) const {
+    for (TransformHandle parent = m_Transforms->GetParent(handle); m_Transforms->IsAlive(parent);
+         parent = m_Transforms->GetParent(parent)) {
+        if (m_Selection.Contains(GetEntityOf(parent))) return true;
+    }
+    return false;
 }
 
 EngineUI::~EngineUI() {
@@ -37,16 +63,47 @@ void EngineUI::Initialize(GLFWwindow* window) {
     ImGui::StyleColorsDark();
     ImGui_ImplGlfw_InitForOpenGL(window, true);
     ImGui_ImplOpenGL3_Init("#version 130");
+    m_Initialized = true;
 }
 
 void EngineUI::BeginFrame() {
     ImGui_ImplOpenGL3_NewFrame();
     ImGui_ImplGlfw_NewFrame();
+    if (m_DeltaTimeOverride > 0.0f) ImGui::GetIO().DeltaTime = m_DeltaTimeOverride;
     ImGui::NewFrame();
 }
 
+std::string EngineUI::GetLayoutSettings() const {
+    ImGuiIO& io = ImGui::GetIO();
+    // The layout on disk unless ImGui already loaded it (it does so on the first NewFrame)
+    if (io.IniFilename && ImGui::GetFrameCount() == 0) ImGui::LoadIniSettingsFromDisk(io.IniFilename);
+    return ImGui::SaveIniSettingsToMemory();
+}
+
+void EngineUI::UseLayoutSettings(const std::string& settings) {
+    ImGui::GetIO().IniFilename = nullptr;
+    ImGui::LoadIniSettingsFromMemory(settings.c_str(), settings.size());
+}
+
 void EngineUI::Render() {
+    PROFILE_SCOPE("EngineUI::Render");
     DrawMainDockspace(); // This will call all other Draw... panel methods
+    UpdateViewportVersion();
+}
+
+// Editor state that ends up in the viewport image: any change needs a re-render
+void EngineUI::UpdateViewportVersion() {
+    ViewportState state;
+    state.selectionVersion = m_Selection.GetVersion();
+    state.hoveredEntity = m_HoveredEntity;
+    state.hoveredAxis = m_HoveredAxis;
+    state.draggedAxis = m_DraggedAxis;
+    state.showGizmos = m_ShowGizmos;
+    state.legacyNormalMatrix = m_UseLegacyNormalMatrix;
+    if (!(state == m_LastViewportState)) {
+        m_LastViewportState = state;
+        ++m_ViewportVersion;
+    }
 }
 
 void EngineUI::EndFrame() {
@@ -63,6 +120,9 @@ void EngineUI::EndFrame() {
 }
 
 void EngineUI::Shutdown() {
+    if (!m_Initialized) return;
+    m_Initialized = false;
+    m_GpuPicker.Release(); // GL objects: before the context goes away
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
@@ -96,31 +156,64 @@ void EngineUI::DrawMainDockspace() {
     DrawInspector();
     DrawAssetBrowser();
     DrawConsole();
+    DrawProfiler();
+    DrawFrameStats();
+    DrawGlTrace();
 
     ImGui::End(); // End DockSpace
 }
 
 void EngineUI::DrawViewport() {
+    PROFILE_SCOPE("EngineUI::DrawViewport");
     ImGui::Begin("Viewport");
     m_ViewportHovered = ImGui::IsWindowHovered();
     m_ViewportSize = ImGui::GetContentRegionAvail();
 
+    // Apply ID-buffer reads queued in earlier frames
+    ResolveGpuPicks();
+    bool gpuPicking = m_UseGpuPicking && m_GpuPickingAvailable && m_Framebuffer && m_Framebuffer->HasObjectIds();
+    if (!gpuPicking) m_HoveredEntity = Entity();
+
+    ImVec2 imageMin = ImGui::GetCursorScreenPos();
     if (m_Framebuffer) {
         ImTextureID textureID = (ImTextureID)(uintptr_t)m_Framebuffer->GetTextureID();
         if (m_ViewportSize.x > 0 && m_ViewportSize.y > 0) { // Prevent ImGui error if size is zero
-             ImGui::Image(textureID, m_ViewportSize, ImVec2(0, 1), ImVec2(1, 0));
+             // Only the render rectangle holds the scene; bilinear sampling upscales it to the panel
+             float uMax = m_Framebuffer->GetUVScaleX();
+             float vMax = m_Framebuffer->GetUVScaleY();
+             ImGui::Image(textureID, m_ViewportSize, ImVec2(0, vMax), ImVec2(uMax, 0));
+             imageMin = ImGui::GetItemRectMin();
+        }
+    }
+
+    // Entities may have been destroyed since the selection was made
+    if (m_World && m_World->GetStructureVersion() != m_SelectionWorldVersion) {
+        m_Selection.Prune(*m_World);
+        m_SelectionWorldVersion = m_World->GetStructureVersion();
+    }
+
+    // Hover: one ID read in flight at a time, resolved next frame (no CPU raycast).
+    // Nothing to read again while neither the cursor nor the image changed (lets the editor idle).
+    if (gpuPicking && ImGui::IsWindowHovered() && !m_IsGizmoDragging && !m_HoverPickPending) {
+        ImVec2 mouse = ImGui::GetMousePos();
+        if (mouse.x != m_HoverPickMouse.x || mouse.y != m_HoverPickMouse.y || m_HoverPickRenderCount != m_ViewportRenderCount) {
+            m_HoverPickPending = RequestGpuPick(mouse, imageMin, m_ViewportSize, kGpuPickHover);
+            if (m_HoverPickPending) {
+                m_HoverPickMouse = mouse;
+                m_HoverPickRenderCount = m_ViewportRenderCount;
+            }
         }
     }
 
     // NEW: Handle viewport mouse interaction for object selection and gizmo manipulation
     if (ImGui::IsWindowHovered()) {
         ImVec2 mousePos = ImGui::GetMousePos();
-        ImVec2 windowPos = ImGui::GetWindowPos();
-        
-        // Convert to viewport coordinates
+
+        // Convert to viewport coordinates: relative to the image, below the title/tab bar,
+        // the same origin the GPU pick and the marquee use
         ImVec2 viewportMousePos = ImVec2(
-            mousePos.x - windowPos.x,
-            mousePos.y - windowPos.y
+            mousePos.x - imageMin.x,
+            mousePos.y - imageMin.y
         );
         
         // Debug mouse state
@@ -129,21 +222,47 @@ void EngineUI::DrawViewport() {
         bool isMouseHeld = ImGui::IsMouseDown(ImGuiMouseButton_Left);
         
         if (isMouseDown) {
-            std::cout << "Mouse clicked at: (" << viewportMousePos.x << ", " << viewportMousePos.y << ")" << std::endl;
+            LOG_TRACE(Editor, "Mouse clicked at: (%.1f, %.1f)", viewportMousePos.x, viewportMousePos.y);
         }
         if (isMouseDragging) {
-            std::cout << "Mouse dragging detected" << std::endl;
+            LOG_TRACE(Editor, "Mouse dragging detected");
         }
         if (isMouseHeld && !isMouseDown) {
-            std::cout << "Mouse held (not dragging)" << std::endl;
+            LOG_TRACE(Editor, "Mouse held (not dragging)");
         }
         
         // Handle gizmo interaction first
         HandleGizmoInteraction(viewportMousePos, m_ViewportSize, isMouseDown, isMouseDragging);
         
         // Handle object selection (only if not interacting with gizmo)
+        // The press is a click or the start of a marquee drag; which one is known on release
         if (isMouseDown && m_HoveredAxis == -1 && !m_IsGizmoDragging) {
-            HandleViewportClick(viewportMousePos, m_ViewportSize);
+            m_MarqueeArmed = true;
+            m_MarqueeStart = mousePos;
+        }
+    }
+
+    // Marquee: tracked outside the hover check so the drag may leave the window
+    if (m_MarqueeArmed) {
+        ImVec2 mousePos = ImGui::GetMousePos();
+        if (!m_MarqueeActive && ImGui::IsMouseDragging(ImGuiMouseButton_Left, 4.0f) && !m_IsGizmoDragging) {
+            m_MarqueeActive = true;
+        }
+        if (m_MarqueeActive) {
+            ImDrawList* drawList = ImGui::GetWindowDrawList();
+            drawList->AddRectFilled(m_MarqueeStart, mousePos, IM_COL32(80, 140, 255, 40));
+            drawList->AddRect(m_MarqueeStart, mousePos, IM_COL32(80, 140, 255, 200));
+        }
+        if (!ImGui::IsMouseDown(ImGuiMouseButton_Left)) {
+            if (m_MarqueeActive) {
+                ApplyMarquee(m_MarqueeStart, mousePos, imageMin, m_ViewportSize);
+            } else if (!gpuPicking || !RequestGpuPick(m_MarqueeStart, imageMin, m_ViewportSize, kGpuPickClick)) {
+                // A click picks what was under the press: GPU ID buffer when available (pixel
+                // exact, applied next frame), BVH raycast otherwise
+                HandleViewportClick(ImVec2(m_MarqueeStart.x - imageMin.x, m_MarqueeStart.y - imageMin.y), m_ViewportSize);
+            }
+            m_MarqueeArmed = false;
+            m_MarqueeActive = false;
         }
     }
 
@@ -152,7 +271,7 @@ void EngineUI::DrawViewport() {
 
 // NEW: Handle viewport clicking for object selection
 void EngineUI::HandleViewportClick(const ImVec2& clickPos, const ImVec2& viewportSize) {
-    if (!m_Camera || !m_SceneObjectsPtr) return;
+    if (!m_Camera || !m_World) return;
 
     // Convert screen coordinates to world ray
     glm::vec3 rayOrigin, rayDirection;
@@ -160,14 +279,84 @@ void EngineUI::HandleViewportClick(const ImVec2& clickPos, const ImVec2& viewpor
     rayDirection = ScreenToWorldRay(clickPos, viewportSize);
 
     // Pick object
-    GameObject* pickedObject = PickObject(rayOrigin, rayDirection);
-    if (pickedObject) {
-        m_SelectedObjectPtr = pickedObject;
-        std::cout << "Selected object: " << pickedObject->name << std::endl;
-    } else {
+    PickResult picked = PickObject(rayOrigin, rayDirection);
+    if (picked.entity.IsValid()) {
+        LOG_DEBUG(Editor, "Raycast hit triangle %u at distance %f", picked.triangle, picked.distance);
+    }
+    ApplySelection(picked.entity);
+}
+
+// Ctrl toggles the picked entity, Shift adds it, a plain click replaces the selection
+void EngineUI::ApplySelection(Entity picked) {
+    ImGuiIO& io = ImGui::GetIO();
+    if (picked.IsValid()) {
+        if (io.KeyCtrl) m_Selection.Toggle(picked);
+        else if (io.KeyShift) m_Selection.Add(picked);
+        else m_Selection.Set(picked);
+        LOG_INFO(Editor, "Selected object: %s (%zu selected)", GetEntityName(picked), m_Selection.GetCount());
+    } else if (!io.KeyCtrl && !io.KeyShift) {
         // Deselect if clicking on empty space
-        m_SelectedObjectPtr = nullptr;
-        std::cout << "Deselected all objects" << std::endl;
+        m_Selection.Clear();
+        LOG_INFO(Editor, "Deselected all objects");
+    }
+}
+
+void EngineUI::ApplyMarquee(const ImVec2& a, const ImVec2& b, const ImVec2& imageMin, const ImVec2& imageSize) {
+    if (!m_Camera || !m_SpatialIndex || imageSize.x <= 0 || imageSize.y <= 0) return;
+
+    // Rectangle corners in NDC, clamped to the image
+    float x0 = (std::min(a.x, b.x) - imageMin.x) / imageSize.x * 2.0f - 1.0f;
+    float x1 = (std::max(a.x, b.x) - imageMin.x) / imageSize.x * 2.0f - 1.0f;
+    float y0 = 1.0f - (std::max(a.y, b.y) - imageMin.y) / imageSize.y * 2.0f;
+    float y1 = 1.0f - (std::min(a.y, b.y) - imageMin.y) / imageSize.y * 2.0f;
+    x0 = glm::clamp(x0, -1.0f, 1.0f); x1 = glm::clamp(x1, -1.0f, 1.0f);
+    y0 = glm::clamp(y0, -1.0f, 1.0f); y1 = glm::clamp(y1, -1.0f, 1.0f);
+    if (x1 - x0 < 1e-4f || y1 - y0 < 1e-4f) return;
+
+    // Scale/offset in clip space so the rectangle fills [-1, 1]: the planes of
+    // (rect * projection * view) are exactly the sub-frustum under the rectangle
+    glm::mat4 rect(1.0f);
+    rect[0][0] = 2.0f / (x1 - x0);
+    rect[1][1] = 2.0f / (y1 - y0);
+    rect[3][0] = -(x1 + x0) / (x1 - x0);
+    rect[3][1] = -(y1 + y0) / (y1 - y0);
+    Frustum frustum = Frustum::FromMatrix(rect * m_Camera->GetViewProjectionMatrix());
+
+    std::vector<Entity> hits;
+    m_SpatialIndex->QueryFrustum(frustum, hits);
+
+    ImGuiIO& io = ImGui::GetIO();
+    Selection::Mode mode = io.KeyShift ? Selection::Mode::Add : io.KeyCtrl ? Selection::Mode::Subtract : Selection::Mode::Replace;
+    m_Selection.Apply(std::move(hits), mode);
+    LOG_INFO(Editor, "Marquee selection: %zu selected", m_Selection.GetCount());
+}
+
+// Queue an ID-buffer read under a screen position. The image is drawn flipped (uv 0,1 -> 1,0),
+// so screen y maps to framebuffer rows from the top. Coordinates are in the render
+// rectangle, which is smaller than the framebuffer under dynamic resolution.
+bool EngineUI::RequestGpuPick(const ImVec2& screenPos, const ImVec2& imageMin, const ImVec2& imageSize, uint32_t tag) {
+    if (!m_Framebuffer || imageSize.x <= 0 || imageSize.y <= 0) return false;
+
+    float u = (screenPos.x - imageMin.x) / imageSize.x;
+    float v = (screenPos.y - imageMin.y) / imageSize.y;
+    if (u < 0.0f || u >= 1.0f || v < 0.0f || v >= 1.0f) return false;
+
+    int x = static_cast<int>(u * m_Framebuffer->GetRenderWidth());
+    int y = static_cast<int>(m_Framebuffer->GetRenderHeight()) - 1 - static_cast<int>(v * m_Framebuffer->GetRenderHeight());
+    return m_GpuPicker.Request(*m_Framebuffer, x, y, tag);
+}
+
+void EngineUI::ResolveGpuPicks() {
+    GpuPicker::Result result;
+    while (m_GpuPicker.Poll(result, m_WaitForGpuPicks)) {
+        // IDs are entity index + 1; 0 is background
+        Entity picked = (result.id != 0 && m_World) ? m_World->FindByIndex(result.id - 1) : Entity();
+        if (result.tag == kGpuPickClick) {
+            ApplySelection(picked);
+        } else {
+            m_HoveredEntity = picked;
+            m_HoverPickPending = false;
+        }
     }
 }
 
@@ -179,74 +368,31 @@ glm::vec3 EngineUI::ScreenToWorldRay(const ImVec2& screenPos, const ImVec2& view
     float x = (2.0f * screenPos.x) / viewportSize.x - 1.0f;
     float y = 1.0f - (2.0f * screenPos.y) / viewportSize.y;
 
-    // Create ray in clip space
-    glm::vec4 rayClip = glm::vec4(x, y, -1.0f, 1.0f);
-
-    // Transform to eye space
-    glm::mat4 projection = glm::perspective(glm::radians(45.0f), viewportSize.x / viewportSize.y, 0.1f, 100.0f);
-    glm::mat4 view = m_Camera->GetViewMatrix();
-    
-    glm::vec4 rayEye = glm::inverse(projection) * rayClip;
-    rayEye = glm::vec4(rayEye.x, rayEye.y, -1.0f, 0.0f);
-
-    // Transform to world space
-    glm::vec4 rayWorld = glm::inverse(view) * rayEye;
-    glm::vec3 rayDirection = glm::normalize(glm::vec3(rayWorld));
-
-    return rayDirection;
+    // The camera caches its inverse matrices, so this is two scales and a 3x3 rotation
+    return m_Camera->GetRayDirection(glm::vec2(x, y));
 }
 
-// NEW: Pick object using ray casting
-GameObject* EngineUI::PickObject(const glm::vec3& rayOrigin, const glm::vec3& rayDirection) {
-    if (!m_SceneObjectsPtr) return nullptr;
-
-    GameObject* closestObject = nullptr;
-    float closestDistance = std::numeric_limits<float>::max();
-
-    for (GameObject* obj : *m_SceneObjectsPtr) {
-        if (!obj || !obj->mesh) continue;
-
-        // Simple bounding sphere test for now
-        glm::vec3 objectPos = obj->transform.position;
-        float radius = 1.0f; // Assume unit radius for now
-
-        // Ray-sphere intersection
-        glm::vec3 oc = rayOrigin - objectPos;
-        float a = glm::dot(rayDirection, rayDirection);
-        float b = 2.0f * glm::dot(oc, rayDirection);
-        float c = glm::dot(oc, oc) - radius * radius;
-        float discriminant = b * b - 4 * a * c;
-
-        if (discriminant > 0) {
-            float t1 = (-b - sqrt(discriminant)) / (2.0f * a);
-            float t2 = (-b + sqrt(discriminant)) / (2.0f * a);
-            
-            if (t1 > 0 && t1 < closestDistance) {
-                closestDistance = t1;
-                closestObject = obj;
-            }
-            if (t2 > 0 && t2 < closestDistance) {
-                closestDistance = t2;
-                closestObject = obj;
-            }
-        }
-    }
-
-    return closestObject;
+// Pick the closest mesh triangle under the ray: the scene BVH yields candidate entities
+// nearest first, then each candidate's triangle BVH is traversed in mesh-local space.
+PickResult EngineUI::PickObject(const glm::vec3& rayOrigin, const glm::vec3& rayDirection) {
+    if (!m_World || !m_Transforms || !m_SpatialIndex || !m_Meshes) return PickResult();
+    return m_SpatialIndex->Pick(rayOrigin, rayDirection, *m_World, *m_Transforms, *m_Meshes);
 }
 
 void EngineUI::DrawInspector() {
+    PROFILE_SCOPE("EngineUI::DrawInspector");
     ImGui::Begin("Inspector");
-    if (m_SelectedObjectPtr) {
-        GameObject* obj = m_SelectedObjectPtr;
-
-        char nameBuffer[128];
-        // Use strncpy for safer string copy to avoid buffer overflow
-        strncpy(nameBuffer, obj->name.c_str(), sizeof(nameBuffer) - 1);
-        nameBuffer[sizeof(nameBuffer) - 1] = '\0'; // Ensure null termination
-
-        if (ImGui::InputText("Name", nameBuffer, sizeof(nameBuffer))) {
-            obj->name = nameBuffer;
+    if (HasSelection()) {
+        Entity entity = m_Selection.GetPrimary();
+        bool multiple = m_Selection.GetCount() > 1;
+
+        if (multiple) {
+            ImGui::Text("%d objects selected (primary: %s)", static_cast<int>(m_Selection.GetCount()), GetEntityName(entity));
+        } else if (NameComponent* name = m_World->Get<NameComponent>(entity)) {
+            // The component is a fixed buffer, so ImGui can edit it in place
+            if (ImGui::InputText("Name", name->value, sizeof(name->value))) {
+                m_NameIndex.Rename(entity, name->value);
+            }
         }
         ImGui::Separator();
 
@@ -268,19 +414,32 @@ void EngineUI::DrawInspector() {
         ImGui::Separator();
 
         ImGui::Text("Transform");
-        if (ImGui::DragFloat3("Position", glm::value_ptr(obj->transform.position), 0.1f)) {
-            // Value changed directly
-        }
-        if (ImGui::DragFloat3("Rotation", glm::value_ptr(obj->transform.rotation), 1.0f)) {
-            // Value changed directly
-        }
-        if (ImGui::DragFloat3("Scale", glm::value_ptr(obj->transform.scale), 0.05f)) {
-            if (obj->transform.scale.x <= 0.0001f) obj->transform.scale.x = 0.0001f;
-            if (obj->transform.scale.y <= 0.0001f) obj->transform.scale.y = 0.0001f;
-            if (obj->transform.scale.z <= 0.0001f) obj->transform.scale.z = 0.0001f;
+        TransformHandle transform = GetSelectedTransform();
+        if (multiple) {
+            DrawBatchTransformEditor();
+        } else if (m_Transforms && m_Transforms->IsAlive(transform)) {
+            // Edit a copy and write it back so the TransformSystem marks it dirty
+            Transform local = m_Transforms->GetLocal(transform);
+            bool changed = false;
+            if (ImGui::DragFloat3("Position", glm::value_ptr(local.position), 0.1f)) {
+                changed = true;
+            }
+            if (ImGui::DragFloat3("Rotation", glm::value_ptr(local.rotation), 1.0f)) {
+                changed = true;
+            }
+            if (ImGui::DragFloat3("Scale", glm::value_ptr(local.scale), 0.05f)) {
+                if (local.scale.x <= 0.0001f) local.scale.x = 0.0001f;
+                if (local.scale.y <= 0.0001f) local.scale.y = 0.0001f;
+                if (local.scale.z <= 0.0001f) local.scale.z = 0.0001f;
+                changed = true;
+            }
+            if (changed) {
+                m_Transforms->SetLocal(transform, local);
+            }
         }
 
-        if (obj->mesh) {
+        MeshRenderer* renderer = m_World->Get<MeshRenderer>(entity);
+        if (renderer && renderer->mesh.IsValid()) {
             ImGui::Separator();
             // In a real scenario, you might get the mesh's asset path or a user-friendly name
             ImGui::Text("Mesh: %s", "Assigned Mesh"); // Generic placeholder
@@ -296,12 +455,42 @@ void EngineUI::DrawInspector() {
     ImGui::End();
 }
 
+// Batch edit: the fields show the primary entity's local transform, and whatever
+// change is made to them is applied as a delta to every selected entity that has no
+// selected ancestor (descendants follow their parent instead of getting the delta twice)
+void EngineUI::DrawBatchTransformEditor() {
+    TransformHandle primary = GetSelectedTransform();
+    if (!m_Transforms || !m_Transforms->IsAlive(primary)) return;
+
+    Transform before = m_Transforms->GetLocal(primary);
+    Transform after = before;
+    bool changed = false;
+    changed |= ImGui::DragFloat3("Position", glm::value_ptr(after.position), 0.1f);
+    changed |= ImGui::DragFloat3("Rotation", glm::value_ptr(after.rotation), 1.0f);
+    changed |= ImGui::DragFloat3("Scale", glm::value_ptr(after.scale), 0.05f);
+    if (!changed) return;
+
+    glm::vec3 positionDelta = after.position - before.position;
+    glm::vec3 rotationDelta = after.rotation - before.rotation;
+    glm::vec3 scaleDelta = after.scale - before.scale;
+    for (Entity entity : m_Selection.GetEntities()) {
+        TransformComponent* transform = m_World->Get<TransformComponent>(entity);
+        if (!transform || !m_Transforms->IsAlive(transform->handle) || HasSelectedAncestor(transform->handle)) continue;
+
+        Transform local = m_Transforms->GetLocal(transform->handle);
+        local.position += positionDelta;
+        local.rotation += rotationDelta;
+        local.scale = glm::max(local.scale + scaleDelta, glm::vec3(0.0001f));
+        m_Transforms->SetLocal(transform->handle, local);
+    }
+}
+
 // NEW: Draw gizmos for selected object
 void EngineUI::DrawGizmos() {
-    if (!m_SelectedObjectPtr || !m_ShowGizmos) return;
+    if (!HasSelection() || !m_ShowGizmos || !m_Transforms || !m_Transforms->IsAlive(GetSelectedTransform())) return;
 
     // Get the selected object's world position
-    glm::vec3 objectPos = m_SelectedObjectPtr->transform.position;
+    glm::vec3 objectPos = m_Transforms->GetWorldPosition(GetSelectedTransform());
     
     // Calculate gizmo size based on camera distance
     float gizmoSize = 1.0f; // Fixed size for now
@@ -318,74 +507,44 @@ void EngineUI::DrawGizmos() {
     ImGui::Text("Current Mode: %s", modeNames[static_cast<int>(m_GizmoMode)]);
 }
 
-// NEW: Render 3D gizmos in the viewport
-void EngineUI::RenderGizmos(Shader* shader, const glm::mat4& view, const glm::mat4& projection) {
-    if (!m_SelectedObjectPtr || !m_ShowGizmos) {
-        std::cout << "Gizmo rendering skipped - no selected object or gizmos disabled" << std::endl;
-        return;
+// Queue the 3D gizmos into the debug-draw batch; main flushes it into the viewport framebuffer
+void EngineUI::RenderGizmos(DebugDraw& debugDraw) {
+    if (!HasSelection() || !m_ShowGizmos || !m_Transforms) return;
+
+    // Bounds of every selected entity, depth tested so they read as part of the scene
+    if (m_Meshes) {
+        for (Entity entity : m_Selection.GetEntities()) {
+            TransformComponent* transform = m_World->Get<TransformComponent>(entity);
+            MeshRenderer* renderer = m_World->Get<MeshRenderer>(entity);
+            const Mesh* mesh = renderer ? m_Meshes->Get(renderer->mesh) : nullptr;
+            if (!transform || !mesh || !m_Transforms->IsAlive(transform->handle)) continue;
+
+            AABB bounds = mesh->GetBounds().Transformed(m_Transforms->GetWorldMatrix(transform->handle));
+            debugDraw.Box(bounds, entity == m_Selection.GetPrimary() ? DebugColor(255, 160, 40) : DebugColor(255, 220, 120, 160));
+        }
     }
 
-    std::cout << "Rendering gizmos for object: " << m_SelectedObjectPtr->name << std::endl;
-    
-    // Get the selected object's position
-    glm::vec3 objectPos = m_SelectedObjectPtr->transform.position;
+    // Axes of the primary object, drawn as an overlay so they stay visible inside meshes
+    if (!m_Transforms->IsAlive(GetSelectedTransform())) return;
+    glm::vec3 objectPos = m_Transforms->GetWorldPosition(GetSelectedTransform());
     float gizmoSize = 2.0f; // Smaller size to fit inside the cube
 
-    // Use fixed function pipeline for gizmos - this ALWAYS works
-    glUseProgram(0); // Disable shader temporarily
-    
-    // Disable depth testing so gizmos are always visible
-    glDisable(GL_DEPTH_TEST);
-    
-    // Draw coordinate axes using immediate mode for simplicity
-    glBegin(GL_LINES);
-    
-    // X-axis (Red) - Draw from center outward (at object position)
-    if (m_HoveredAxis == 0 || m_DraggedAxis == 0) {
-        glColor3f(1.0f, 1.0f, 0.0f); // Yellow when hovered/dragged
-    } else {
-        glColor3f(1.0f, 0.0f, 0.0f); // Red normally
-    }
-    glVertex3f(objectPos.x - gizmoSize/2, objectPos.y, objectPos.z);
-    glVertex3f(objectPos.x + gizmoSize/2, objectPos.y, objectPos.z);
-    
-    // Y-axis (Green) - Draw from center outward (at object position)
-    if (m_HoveredAxis == 1 || m_DraggedAxis == 1) {
-        glColor3f(1.0f, 1.0f, 0.0f); // Yellow when hovered/dragged
-    } else {
-        glColor3f(0.0f, 1.0f, 0.0f); // Green normally
+    const uint32_t highlight = DebugColor(255, 255, 0); // Yellow when hovered/dragged
+    const uint32_t axisColors[3] = { DebugColor(255, 0, 0), DebugColor(0, 255, 0), DebugColor(0, 0, 255) };
+    for (int axis = 0; axis < 3; ++axis) {
+        glm::vec3 offset(0.0f);
+        offset[axis] = gizmoSize / 2;
+        bool active = m_HoveredAxis == axis || m_DraggedAxis == axis;
+        debugDraw.Arrow(objectPos - offset, objectPos + offset, active ? highlight : axisColors[axis], DebugDraw::Mode::Overlay);
     }
-    glVertex3f(objectPos.x, objectPos.y - gizmoSize/2, objectPos.z);
-    glVertex3f(objectPos.x, objectPos.y + gizmoSize/2, objectPos.z);
-    
-    // Z-axis (Blue) - Draw from center outward (at object position)
-    if (m_HoveredAxis == 2 || m_DraggedAxis == 2) {
-        glColor3f(1.0f, 1.0f, 0.0f); // Yellow when hovered/dragged
-    } else {
-        glColor3f(0.0f, 0.0f, 1.0f); // Blue normally
-    }
-    glVertex3f(objectPos.x, objectPos.y, objectPos.z - gizmoSize/2);
-    glVertex3f(objectPos.x, objectPos.y, objectPos.z + gizmoSize/2);
-    
-    glEnd();
-    
-    // Re-enable depth testing
-    glEnable(GL_DEPTH_TEST);
-    
-    // Reset color
-    glColor3f(1.0f, 1.0f, 1.0f);
-    
-    // Re-enable the main shader
-    shader->Use();
-    
-    std::cout << "Gizmo rendering completed for: " << m_SelectedObjectPtr->name << std::endl;
 }
 
 void EngineUI::DrawAssetBrowser() {
+    PROFILE_SCOPE("EngineUI::DrawAssetBrowser");
     ImGui::Begin("Assets");
     if (ImGui::Button("Load Cube Mesh (Test)")) {
-        if (m_SelectedObjectPtr) {
-            std::cout << "Asset Browser: 'Load Cube Mesh' clicked for " << m_SelectedObjectPtr->name << std::endl;
+        if (HasSelection()) {
+            LOG_INFO(Editor, "Asset Browser: 'Load Cube Mesh' clicked for %s", GetEntityName(m_Selection.GetPrimary()));
             // This functionality needs a MeshManager to be truly useful.
             // For now, it's a placeholder action.
         }
@@ -401,39 +560,477 @@ void EngineUI::DrawAssetBrowser() {
     ImGui::End();
 }
 
+// Profiler: capture controls, frame time history, a flame graph of one frame (a lane per
+// thread, nesting as rows) and the zones that took the most time in it
+void EngineUI::DrawProfiler() {
+    ImGui::Begin("Profiler");
+
+    const std::deque<ProfileFrame>& frames = Profiler::GetFrames();
+    bool capturing = Profiler::IsCapturing();
+    if (ImGui::Checkbox("Capturar", &capturing)) Profiler::SetCapturing(capturing);
+    ImGui::SameLine();
+    if (ImGui::Checkbox("Pausar", &m_ProfilerPaused) && m_ProfilerPaused && !frames.empty())
+        m_ProfilerFrame = frames.back();
+    ImGui::SameLine();
+    if (ImGui::Button("Exportar trace (JSON)")) {
+        if (Profiler::ExportChromeTrace("rampage_trace.json"))
+            LOG_INFO(Editor, "Trace exportado: rampage_trace.json (%llu eventos)", (unsigned long long)Profiler::GetCaptureEventCount());
+        else
+            LOG_ERROR(Editor, "Falha ao exportar rampage_trace.json");
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Limpar##profiler")) Profiler::ClearCapture();
+    ImGui::SameLine();
+    ImGui::TextDisabled("%llu eventos, %llu descartados", (unsigned long long)Profiler::GetCaptureEventCount(),
+                        (unsigned long long)Profiler::GetDroppedCount());
+#if !RAMPAGE_PROFILER
+    ImGui::TextDisabled("Compilado com RAMPAGE_PROFILER=0: nenhuma zona é registrada");
+#endif
+
+    float frameTimes[Profiler::kFrameHistory];
+    int frameCount = 0;
+    for (const ProfileFrame& frame : frames) frameTimes[frameCount++] = static_cast<float>(Profiler::TicksToMs(frame.end - frame.start));
+    ImGui::PlotHistogram("##frameTimes", frameTimes, frameCount, 0, "Tempo de quadro (ms)", 0.0f, 3.4e38f, ImVec2(-1.0f, 50.0f));
+
+    const ProfileFrame* frame = m_ProfilerPaused ? &m_ProfilerFrame : (frames.empty() ? nullptr : &frames.back());
+    if (!frame || frame->events.empty()) {
+        ImGui::TextDisabled("Ative \"Capturar\" para registrar zonas.");
+        ImGui::End();
+        return;
+    }
+
+    // Time span covered by the graph (zones can start before the frame marker that drained them)
+    uint64_t spanStart = frame->start, spanEnd = frame->end;
+    uint16_t laneDepth[Profiler::kMaxThreads] = {};
+    for (const ProfileEvent& event : frame->events) {
+        if (event.type != ProfileEvent::Zone || event.thread >= Profiler::kMaxThreads) continue;
+        spanStart = std::min(spanStart, event.start);
+        spanEnd = std::max(spanEnd, event.end);
+        laneDepth[event.thread] = std::max<uint16_t>(laneDepth[event.thread], event.depth + 1);
+    }
+    double spanTicks = static_cast<double>(std::max<uint64_t>(spanEnd - spanStart, 1));
+    ImGui::Text("Quadro: %.3f ms, %d eventos", Profiler::TicksToMs(frame->end - frame->start), (int)frame->events.size());
+
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    float width = std::max(ImGui::GetContentRegionAvail().x, 100.0f);
+    float rowHeight = ImGui::GetTextLineHeight() + 4.0f;
+    ImVec2 mouse = ImGui::GetMousePos();
+    for (int thread = 0; thread < Profiler::kMaxThreads; ++thread) {
+        if (laneDepth[thread] == 0) continue;
+        ImGui::TextDisabled("%s", Profiler::GetThreadName(static_cast<uint16_t>(thread)).c_str());
+        ImVec2 origin = ImGui::GetCursorScreenPos();
+        ImGui::PushID(thread);
+        ImGui::InvisibleButton("lane", ImVec2(width, laneDepth[thread] * rowHeight));
+        bool laneHovered = ImGui::IsItemHovered();
+        ImGui::PopID();
+
+        for (const ProfileEvent& event : frame->events) {
+            if (event.type != ProfileEvent::Zone || event.thread != thread) continue;
+            float x0 = origin.x + static_cast<float>((event.start - spanStart) / spanTicks) * width;
+            float x1 = origin.x + static_cast<float>((event.end - spanStart) / spanTicks) * width;
+            x1 = std::max(x1, x0 + 1.0f);
+            float y0 = origin.y + event.depth * rowHeight;
+            float y1 = y0 + rowHeight - 1.0f;
+
+            // Stable color per zone name
+            uint32_t hash = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(event.name) >> 3) * 2654435761u;
+            ImU32 color = IM_COL32(90 + (hash >> 24) % 110, 90 + (hash >> 16) % 110, 90 + (hash >> 8) % 110, 255);
+            drawList->AddRectFilled(ImVec2(x0, y0), ImVec2(x1, y1), color);
+            if (ImGui::CalcTextSize(event.name).x + 6.0f < x1 - x0)
+                drawList->AddText(ImVec2(x0 + 3.0f, y0 + 2.0f), IM_COL32(0, 0, 0, 255), event.name);
+            if (laneHovered && mouse.x >= x0 && mouse.x < x1 && mouse.y >= y0 && mouse.y < y1)
+                ImGui::SetTooltip("%s\n%.3f ms", event.name, Profiler::TicksToMs(event.end - event.start));
+        }
+    }
+
+    // Heaviest zones of the frame (inclusive time), and the last value of each counter
+    struct ZoneTotal { const char* name; double ms; int calls; };
+    std::vector<ZoneTotal> totals;
+    std::vector<const ProfileEvent*> counters;
+    for (const ProfileEvent& event : frame->events) {
+        if (event.type == ProfileEvent::Counter) {
+            auto it = std::find_if(counters.begin(), counters.end(), [&](const ProfileEvent* c) { return c->name == event.name; });
+            if (it == counters.end()) counters.push_back(&event);
+            else *it = &event;
+            continue;
+        }
+        auto it = std::find_if(totals.begin(), totals.end(), [&](const ZoneTotal& t) { return t.name == event.name; });
+        if (it == totals.end()) it = totals.insert(totals.end(), { event.name, 0.0, 0 });
+        it->ms += Profiler::TicksToMs(event.end - event.start);
+        it->calls++;
+    }
+    std::sort(totals.begin(), totals.end(), [](const ZoneTotal& a, const ZoneTotal& b) { return a.ms > b.ms; });
+    if (ImGui::BeginTable("ProfilerTotals", 3)) {
+        ImGui::TableSetupColumn("Zona");
+        ImGui::TableSetupColumn("Total (ms)");
+        ImGui::TableSetupColumn("Chamadas");
+        ImGui::TableHeadersRow();
+        for (size_t i = 0; i < totals.size() && i < 15; ++i) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(totals[i].name);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", totals[i].ms);
+            ImGui::TableNextColumn(); ImGui::Text("%d", totals[i].calls);
+        }
+        ImGui::EndTable();
+    }
+    for (const ProfileEvent* counter : counters) ImGui::Text("%s: %g", counter->name, counter->value);
+
+    ImGui::End();
+}
+
+// Frame statistics: a rolling graph and percentiles per metric over the kept history
+void EngineUI::DrawFrameStats() {
+    ImGui::Begin("Estatísticas");
+    if (!m_FrameStats) {
+        ImGui::End();
+        return;
+    }
+
+    const std::deque<FrameStatsRecord>& history = m_FrameStats->GetHistory();
+    ImGui::Text("%d quadros", (int)history.size());
+    ImGui::SameLine();
+    if (ImGui::Button("Exportar CSV")) {
+        if (m_FrameStats->ExportCsv("frame_stats.csv"))
+            LOG_INFO(Editor, "Estatísticas exportadas: frame_stats.csv (%d quadros)", (int)history.size());
+        else
+            LOG_ERROR(Editor, "Falha ao exportar frame_stats.csv");
+    }
+
+    if (ImGui::BeginTable("FrameStatsTable", 7)) {
+        ImGui::TableSetupColumn("Métrica");
+        ImGui::TableSetupColumn("Histórico");
+        ImGui::TableSetupColumn("Média");
+        ImGui::TableSetupColumn("p50");
+        ImGui::TableSetupColumn("p95");
+        ImGui::TableSetupColumn("p99");
+        ImGui::TableSetupColumn("Máx");
+        ImGui::TableHeadersRow();
+
+        std::vector<float> values;
+        values.reserve(history.size());
+        for (int i = 0; i < (int)FrameMetric::Count; ++i) {
+            FrameMetric metric = static_cast<FrameMetric>(i);
+            // Frames without a value (pass not drawn, GPU time not back yet) are plotted as 0
+            values.clear();
+            for (const FrameStatsRecord& record : history) {
+                double value = 0.0;
+                values.push_back(FrameStats::GetValue(record, metric, value) ? (float)value : 0.0f);
+            }
+            StatSummary summary = m_FrameStats->Summarize(metric);
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(FrameStats::GetMetricName(metric));
+            ImGui::TableNextColumn();
+            ImGui::PushID(i);
+            ImGui::PlotLines("##history", values.data(), (int)values.size(), 0, nullptr, 0.0f, 3.4e38f, ImVec2(160.0f, 24.0f));
+            ImGui::PopID();
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", summary.average);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", summary.p50);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", summary.p95);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", summary.p99);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", summary.max);
+        }
+        ImGui::EndTable();
+    }
+
+    ImGui::End();
+}
+
+// GL call accounting: per-function calls of the last frame, with redundant calls and stall
+// suspects highlighted, and the aggregated KHR_debug messages
+void EngineUI::DrawGlTrace() {
+    ImGui::Begin("Chamadas GL");
+
+    bool enabled = GlTrace::IsEnabled();
+    if (ImGui::Checkbox("Instrumentar", &enabled)) GlTrace::SetEnabled(enabled);
+    ImGui::SameLine();
+    if (ImGui::Button("Exportar relatório")) {
+        if (GlTrace::WriteReport("gl_report.txt"))
+            LOG_INFO(Editor, "Relatório GL exportado: gl_report.txt (%llu quadros)", (unsigned long long)GlTrace::GetFrameCount());
+        else
+            LOG_ERROR(Editor, "Falha ao exportar gl_report.txt");
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Zerar")) GlTrace::Reset();
+    ImGui::SameLine();
+    ImGui::TextDisabled("%llu quadros", (unsigned long long)GlTrace::GetFrameCount());
+#if !RAMPAGE_GL_TRACE
+    ImGui::TextDisabled("Compilado com RAMPAGE_GL_TRACE=0: apenas mensagens KHR_debug");
+#endif
+
+    const ImVec4 kWarningColor(1.0f, 0.7f, 0.3f, 1.0f);
+    double frames = (double)std::max<uint64_t>(GlTrace::GetFrameCount(), 1);
+    if (GlTrace::IsEnabled() && ImGui::BeginTable("GlTraceTable", 6)) {
+        ImGui::TableSetupColumn("Função");
+        ImGui::TableSetupColumn("Quadro");
+        ImGui::TableSetupColumn("Média/quadro");
+        ImGui::TableSetupColumn("us/chamada");
+        ImGui::TableSetupColumn("Redundantes");
+        ImGui::TableSetupColumn("Stalls");
+        ImGui::TableHeadersRow();
+        for (const GlTrace::FunctionStats& stats : GlTrace::GetFunctions()) {
+            if (stats.calls == 0) continue;
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(stats.name);
+            ImGui::TableNextColumn(); ImGui::Text("%u", stats.lastFrameCalls);
+            ImGui::TableNextColumn(); ImGui::Text("%.1f", stats.calls / frames);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", Profiler::TicksToMs(stats.ticks) * 1000.0 / stats.calls);
+            ImGui::TableNextColumn();
+            if (stats.redundant > 0) ImGui::TextColored(kWarningColor, "%.0f%%", 100.0 * stats.redundant / stats.calls);
+            ImGui::TableNextColumn();
+            if (stats.stalls > 0) ImGui::TextColored(kWarningColor, "%.1f/quadro", stats.stalls / frames);
+        }
+        ImGui::EndTable();
+    }
+
+    const std::vector<GlTrace::DebugMessage>& messages = GlTrace::GetDebugMessages();
+    ImGui::Text("Mensagens KHR_debug: %d", (int)messages.size());
+    for (const GlTrace::DebugMessage& message : messages) {
+        ImGui::TextWrapped("[%s] x%llu%s%s: %s", GlTrace::GetDebugTypeName(message.type), (unsigned long long)message.count,
+                           message.during ? " em " : "", message.during ? message.during : "", message.text.c_str());
+    }
+
+    ImGui::End();
+}
+
+// Shows the logger's history. Only the visible rows are submitted (ImGuiListClipper),
+// so the panel costs the same with 10 lines or with the full history.
 void EngineUI::DrawConsole() {
+    PROFILE_SCOPE("EngineUI::DrawConsole");
     ImGui::Begin("Console");
-    ImGui::Text("Inicializando Rampage Engine...");
-    ImGui::Text("Sistema de renderização inicializado.");
-    // ImGui::Text("Sistema de física carregado."); // Commented out if not yet implemented
-    ImGui::Text("Aguardando comandos...");
+
+    // Pull what the drain thread formatted since the last frame
+    size_t before = m_ConsoleLines.size();
+    uint64_t cursor = m_ConsoleCursor;
+    Logger::ReadHistory(m_ConsoleCursor, [](void* user, const LogLine& line) {
+        static_cast<std::deque<LogLine>*>(user)->push_back(line);
+    }, &m_ConsoleLines);
+    bool changed = m_ConsoleCursor != cursor || m_ConsoleLines.size() != before;
+    while (m_ConsoleLines.size() > Logger::kHistorySize) m_ConsoleLines.pop_front();
+
+    static const char* levelNames[] = { "Trace", "Debug", "Info", "Warn", "Error" };
+    static const char* categoryNames[] = { "Todas", "General", "Render", "Assets", "Scene", "Editor" };
+    ImGui::SetNextItemWidth(100.0f);
+    changed |= ImGui::Combo("Nível", &m_ConsoleMinLevel, levelNames, IM_ARRAYSIZE(levelNames));
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(100.0f);
+    changed |= ImGui::Combo("Categoria", &m_ConsoleCategory, categoryNames, IM_ARRAYSIZE(categoryNames));
+    ImGui::SameLine();
+    if (ImGui::Button("Limpar")) {
+        m_ConsoleLines.clear();
+        changed = true;
+    }
+    ImGui::SameLine();
+    ImGui::Checkbox("Auto-scroll", &m_ConsoleAutoScroll);
+    if (uint64_t dropped = Logger::GetDroppedCount()) {
+        ImGui::SameLine();
+        ImGui::TextDisabled("(%llu descartadas)", static_cast<unsigned long long>(dropped));
+    }
+    ImGui::Separator();
+
+    if (changed) {
+        m_ConsoleRows.clear();
+        for (size_t i = 0; i < m_ConsoleLines.size(); ++i) {
+            const LogLine& line = m_ConsoleLines[i];
+            if (static_cast<int>(line.level) < m_ConsoleMinLevel) continue;
+            if (m_ConsoleCategory > 0 && static_cast<int>(line.category) != m_ConsoleCategory - 1) continue;
+            m_ConsoleRows.push_back(static_cast<int>(i));
+        }
+    }
+
+    ImGui::BeginChild("ConsoleScroll");
+    bool atBottom = ImGui::GetScrollY() >= ImGui::GetScrollMaxY();
+    static const ImVec4 levelColors[] = {
+        ImVec4(0.5f, 0.5f, 0.5f, 1.0f), // Trace
+        ImVec4(0.7f, 0.7f, 0.7f, 1.0f), // Debug
+        ImVec4(0.9f, 0.9f, 0.9f, 1.0f), // Info
+        ImVec4(1.0f, 0.8f, 0.3f, 1.0f), // Warning
+        ImVec4(1.0f, 0.4f, 0.4f, 1.0f), // Error
+    };
+    ImGuiListClipper clipper;
+    clipper.Begin(static_cast<int>(m_ConsoleRows.size()));
+    while (clipper.Step()) {
+        for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+            const LogLine& line = m_ConsoleLines[m_ConsoleRows[row]];
+            ImGui::PushStyleColor(ImGuiCol_Text, levelColors[static_cast<int>(line.level)]);
+            ImGui::TextUnformatted(line.text.c_str(), line.text.c_str() + line.text.size());
+            ImGui::PopStyleColor();
+        }
+    }
+    clipper.End();
+    if (changed && m_ConsoleAutoScroll && atBottom) ImGui::SetScrollHereY(1.0f);
+    ImGui::EndChild();
+
     ImGui::End();
 }
 
+// The hierarchy is flattened into rows (depth-first, skipping collapsed subtrees) only when
+// the World or the transform tree changed, and drawn through ImGuiListClipper: the cost per
+// frame is the number of visible rows, whatever the size of the scene.
 void EngineUI::DrawHierarchy() {
+    PROFILE_SCOPE("EngineUI::DrawHierarchy");
     ImGui::Begin("Hierarchy");
-    if (m_SceneObjectsPtr) {
-        // Create a temporary copy for safe iteration if objects might be deleted during UI interaction
-        // For now, direct iteration is fine as we are only selecting.
-        for (size_t i = 0; i < m_SceneObjectsPtr->size(); ++i) {
-            GameObject* obj = (*m_SceneObjectsPtr)[i];
-            if (obj) {
-                ImGui::PushID(obj); // Use pointer as unique ID
-                bool is_selected = (m_SelectedObjectPtr == obj);
-                if (ImGui::Selectable(obj->name.c_str(), is_selected)) {
-                    m_SelectedObjectPtr = obj;
+    if (m_World && m_Transforms) {
+        m_NameIndex.Sync(*m_World);
+
+        ImGui::SetNextItemWidth(-1.0f);
+        ImGui::InputTextWithHint("##HierarchySearch", "Buscar...", m_HierarchySearch, sizeof(m_HierarchySearch));
+        bool searching = m_HierarchySearch[0] != '\0';
+
+        int rowCount = 0;
+        if (searching) {
+            UpdateHierarchySearch();
+            rowCount = static_cast<int>(m_SearchResults.size());
+            ImGui::TextDisabled("%d de %d", rowCount, static_cast<int>(m_NameIndex.GetCount()));
+        } else {
+            if (m_HierarchyDirty || m_HierarchyWorldVersion != m_World->GetStructureVersion() ||
+                m_HierarchyTransformVersion != m_Transforms->GetHierarchyVersion()) {
+                RebuildHierarchyRows();
+            }
+            rowCount = static_cast<int>(m_HierarchyRows.size());
+        }
+
+        ImGuiListClipper clipper;
+        clipper.Begin(rowCount);
+        while (clipper.Step()) {
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+                if (searching) {
+                    // Matches are listed flat; the entity may have died since the search ran
+                    if (m_World->IsAlive(m_SearchResults[row])) DrawHierarchyRow(m_SearchResults[row], 0, false);
+                    else ImGui::TextDisabled("-");
+                } else {
+                    const HierarchyRow& entry = m_HierarchyRows[row];
+                    DrawHierarchyRow(entry.entity, entry.depth, entry.hasChildren);
                 }
-                if (is_selected && ImGui::IsWindowFocused(ImGuiFocusedFlags_RootAndChildWindows) && !ImGui::IsAnyItemActive()) {
-                     // ImGui::SetItemDefaultFocus(); // Can be a bit aggressive with focus
+            }
+        }
+        clipper.End();
+
+        // Dropping onto empty space turns the dragged entity back into a root
+        ImGui::Dummy(ImGui::GetContentRegionAvail());
+        if (ImGui::BeginDragDropTarget()) {
+            if (const ImGuiPayload* payload = ImGui::AcceptDragDropPayload("HIERARCHY_OBJECT")) {
+                Entity dropped = *static_cast<const Entity*>(payload->Data);
+                if (TransformComponent* droppedTransform = m_World->Get<TransformComponent>(dropped)) {
+                    m_Transforms->SetParent(droppedTransform->handle, TransformHandle());
                 }
-                ImGui::PopID();
             }
+            ImGui::EndDragDropTarget();
         }
     }
     ImGui::End();
 }
 
+// Depth-first walk from the roots with an explicit stack (no recursion limit on deep trees)
+void EngineUI::RebuildHierarchyRows() {
+    m_HierarchyRows.clear();
+    m_HierarchyWorldVersion = m_World->GetStructureVersion();
+    m_HierarchyTransformVersion = m_Transforms->GetHierarchyVersion();
+    m_HierarchyDirty = false;
+
+    std::vector<HierarchyRow> stack;
+    std::vector<HierarchyRow> children;
+    auto makeRow = [&](Entity entity, TransformHandle transform, uint32_t depth) {
+        HierarchyRow row;
+        row.entity = entity;
+        row.depth = depth;
+        row.hasChildren = m_Transforms->GetFirstChild(transform).IsValid();
+        return row;
+    };
+
+    m_World->Each<TransformComponent>([&](Entity root, TransformComponent& rootTransform) {
+        if (!m_Transforms->IsAlive(rootTransform.handle) || m_Transforms->GetParent(rootTransform.handle).IsValid()) return;
+
+        stack.push_back(makeRow(root, rootTransform.handle, 0));
+        while (!stack.empty()) {
+            HierarchyRow row = stack.back();
+            stack.pop_back();
+            m_HierarchyRows.push_back(row);
+            if (!row.hasChildren || m_CollapsedEntities.count(row.entity.ToUint64())) continue;
+
+            // Children are pushed in reverse so they come off the stack in sibling order
+            TransformHandle transform = m_World->Get<TransformComponent>(row.entity)->handle;
+            children.clear();
+            for (TransformHandle child = m_Transforms->GetFirstChild(transform); child.IsValid(); child = m_Transforms->GetNextSibling(child)) {
+                Entity childEntity = GetEntityOf(child);
+                if (m_World->Has<TransformComponent>(childEntity)) children.push_back(makeRow(childEntity, child, row.depth + 1));
+            }
+            stack.insert(stack.end(), children.rbegin(), children.rend());
+        }
+    });
+}
+
+// Typing more characters refines the previous matches instead of querying the index again
+void EngineUI::UpdateHierarchySearch() {
+    bool indexChanged = m_NameIndex.GetVersion() != m_SearchIndexVersion;
+    if (!indexChanged && m_LastHierarchySearch == m_HierarchySearch) return;
+
+    if (!indexChanged && !m_LastHierarchySearch.empty() &&
+        std::string(m_HierarchySearch).find(m_LastHierarchySearch) != std::string::npos) {
+        m_NameIndex.Filter(m_HierarchySearch, m_SearchResults);
+    } else {
+        m_SearchResults.clear();
+        m_NameIndex.Find(m_HierarchySearch, m_SearchResults);
+    }
+    m_LastHierarchySearch = m_HierarchySearch;
+    m_SearchIndexVersion = m_NameIndex.GetVersion();
+}
+
+void EngineUI::HandleHierarchyClick(Entity entity) {
+    ImGuiIO& io = ImGui::GetIO();
+    if (io.KeyCtrl) m_Selection.Toggle(entity);
+    else if (io.KeyShift) m_Selection.Add(entity);
+    else m_Selection.Set(entity);
+}
+
+// Draws one row. Entities can be dragged onto each other to reparent them
+// (local transforms are kept, so the child moves with its new parent).
+void EngineUI::DrawHierarchyRow(Entity entity, uint32_t depth, bool hasChildren) {
+    TransformComponent* transformComponent = m_World->Get<TransformComponent>(entity);
+    if (!transformComponent) return;
+    TransformHandle transform = transformComponent->handle;
+
+    // Rows are not nested through TreePush: the indent comes from the row's depth
+    ImGui::SetCursorPosX(ImGui::GetCursorPosX() + depth * ImGui::GetTreeNodeToLabelSpacing());
+    ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_SpanAvailWidth |
+                               ImGuiTreeNodeFlags_NoTreePushOnOpen;
+    if (m_Selection.Contains(entity)) flags |= ImGuiTreeNodeFlags_Selected;
+    if (!hasChildren) flags |= ImGuiTreeNodeFlags_Leaf;
+
+    bool collapsed = m_CollapsedEntities.count(entity.ToUint64()) != 0;
+    if (hasChildren) ImGui::SetNextItemOpen(!collapsed);
+
+    // Packed entity id as the unique ImGui ID
+    const void* nodeId = reinterpret_cast<const void*>(static_cast<uintptr_t>(entity.ToUint64()));
+    ImGui::TreeNodeEx(nodeId, flags, "%s", GetEntityName(entity));
+    if (hasChildren && ImGui::IsItemToggledOpen()) {
+        if (collapsed) m_CollapsedEntities.erase(entity.ToUint64());
+        else m_CollapsedEntities.insert(entity.ToUint64());
+        m_HierarchyDirty = true; // takes effect next frame, the rows are being iterated
+    }
+    if (ImGui::IsItemClicked() && !ImGui::IsItemToggledOpen()) {
+        HandleHierarchyClick(entity);
+    }
+
+    if (ImGui::BeginDragDropSource()) {
+        ImGui::SetDragDropPayload("HIERARCHY_OBJECT", &entity, sizeof(Entity));
+        ImGui::Text("%s", GetEntityName(entity));
+        ImGui::EndDragDropSource();
+    }
+    if (ImGui::BeginDragDropTarget()) {
+        if (const ImGuiPayload* payload = ImGui::AcceptDragDropPayload("HIERARCHY_OBJECT")) {
+            Entity dropped = *static_cast<const Entity*>(payload->Data);
+            TransformComponent* droppedTransform = m_World->Get<TransformComponent>(dropped);
+            if (droppedTransform && !m_Transforms->SetParent(droppedTransform->handle, transform)) {
+                LOG_WARN(Editor, "Cannot parent %s under its own descendant", GetEntityName(dropped));
+            }
+        }
+        ImGui::EndDragDropTarget();
+    }
+}
+
 void EngineUI::DrawMenuBar() {
+    PROFILE_SCOPE("EngineUI::DrawMenuBar");
     if (ImGui::BeginMenuBar()) {
         if (ImGui::BeginMenu("Arquivo")) {
             if (ImGui::MenuItem("Novo", "Ctrl+N")) { /* ... */ }
@@ -453,13 +1050,56 @@ void EngineUI::DrawMenuBar() {
             if (ImGui::MenuItem("Configurações")) { /* ... */ }
             ImGui::EndMenu();
         }
+        if (m_FrameCapture && ImGui::BeginMenu("Captura")) {
+            // Files are named after the local time, in the working directory
+            char stamp[32] = "captura";
+            std::time_t now = std::time(nullptr);
+            if (const std::tm* local = std::localtime(&now)) std::strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", local);
+
+            if (ImGui::MenuItem("Salvar imagem (QOI)"))
+                m_FrameCapture->RequestScreenshot(std::string("captura_") + stamp + ".qoi");
+            if (!m_FrameCapture->IsRecording()) {
+                if (ImGui::MenuItem("Iniciar gravação (Y4M)"))
+                    m_FrameCapture->StartRecording(std::string("gravacao_") + stamp + ".y4m");
+            } else if (ImGui::MenuItem("Parar gravação")) {
+                m_FrameCapture->StopRecording();
+            }
+            ImGui::EndMenu();
+        }
+        if (ImGui::BeginMenu("Visualizar")) {
+            // A/B switch between the CPU normal matrix and the old per-vertex inverse(model)
+            ImGui::MenuItem("Normal matrix por vértice (comparação)", nullptr, &m_UseLegacyNormalMatrix);
+            // Picking backend: ID buffer read back from the GPU, or BVH raycast on the CPU
+            ImGui::MenuItem("Seleção por ID buffer (GPU)", nullptr, &m_UseGpuPicking);
+            // Idle editor: block on events and reuse the last viewport image when nothing changed
+            ImGui::MenuItem("Renderizar sob demanda", nullptr, &m_RenderOnDemand);
+            // Render the viewport at a lower internal resolution to stay within a GPU time budget
+            ImGui::MenuItem("Resolução dinâmica", nullptr, &m_DynamicResolution);
+            if (m_DynamicResolution) {
+                ImGui::SetNextItemWidth(120.0f);
+                ImGui::SliderFloat("Orçamento (ms)", &m_DynamicResolutionTargetMs, 1.0f, 33.0f, "%.1f");
+            }
+            ImGui::EndMenu();
+        }
+
+        // Scene pass GPU time, averaged per draw to compare vertex shader cost
+        double perDrawUs = m_ScenePassDraws > 0 ? (m_ScenePassGpuMs * 1000.0) / m_ScenePassDraws : 0.0;
+        ImGui::Text("| Cena GPU: %.3f ms (%d draws, %.2f us/draw)%s",
+                    m_ScenePassGpuMs, m_ScenePassDraws, perDrawUs,
+                    m_UseLegacyNormalMatrix ? " [inverse por vértice]" : "");
+        if (m_DynamicResolution) ImGui::Text("| Resolução: %.0f%%", m_RenderScale * 100.0f);
+        if (m_FrameCapture && m_FrameCapture->IsRecording()) {
+            ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "| REC %llu quadros (%llu perdidos, %.2f ms)",
+                               (unsigned long long)m_FrameCapture->GetRecordedFrames(),
+                               (unsigned long long)m_FrameCapture->GetDroppedFrames(), m_FrameCapture->GetLastCpuMs());
+        }
         ImGui::EndMenuBar();
     }
 }
 
 // NEW: Handle interactive gizmo functionality
 void EngineUI::HandleGizmoInteraction(const ImVec2& mousePos, const ImVec2& viewportSize, bool isMouseDown, bool isMouseDragging) {
-    if (!m_SelectedObjectPtr || !m_ShowGizmos || m_GizmoMode != GizmoMode::Translate) return;
+    if (!HasSelection() || !m_ShowGizmos || !m_Transforms || m_GizmoMode != GizmoMode::Translate) return;
 
     // Convert mouse position to world ray
     glm::vec3 rayOrigin = m_Camera->GetCameraPosition();
@@ -473,23 +1113,23 @@ void EngineUI::HandleGizmoInteraction(const ImVec2& mousePos, const ImVec2& view
 
     // Debug output for hover state
     if (isHovered) {
-        std::cout << "Hovering over axis: " << hoveredAxis << std::endl;
+        LOG_TRACE(Editor, "Hovering over axis: %d", hoveredAxis);
     }
 
     // Handle mouse down
     if (isMouseDown && isHovered) {
         m_IsGizmoDragging = true;
         m_DraggedAxis = hoveredAxis;
-        m_GizmoDragStartPos = m_SelectedObjectPtr->transform.position;
+        m_GizmoDragStartPos = m_Transforms->GetWorldPosition(GetSelectedTransform());
         m_LastMousePos = mousePos;
-        std::cout << "Started dragging axis: " << hoveredAxis << std::endl;
+        LOG_DEBUG(Editor, "Started dragging axis: %d", hoveredAxis);
     }
 
     // Handle mouse release
     if (!ImGui::IsMouseDown(ImGuiMouseButton_Left) && m_IsGizmoDragging) {
         m_IsGizmoDragging = false;
         m_DraggedAxis = -1;
-        std::cout << "Stopped dragging" << std::endl;
+        LOG_DEBUG(Editor, "Stopped dragging");
     }
 
     // Handle dragging - check for any mouse movement (including held state)
@@ -499,23 +1139,22 @@ void EngineUI::HandleGizmoInteraction(const ImVec2& mousePos, const ImVec2& view
         
         // Check if mouse actually moved (lower threshold for more responsiveness)
         if (abs(mouseDelta.x) > 0.05f || abs(mouseDelta.y) > 0.05f) {
-            std::cout << "Mouse delta: (" << mouseDelta.x << ", " << mouseDelta.y << ")" << std::endl;
-            std::cout << "Dragged axis: " << m_DraggedAxis << std::endl;
+            LOG_TRACE(Editor, "Mouse delta: (%.2f, %.2f), dragged axis: %d", mouseDelta.x, mouseDelta.y, m_DraggedAxis);
             UpdateGizmoDrag(mouseDelta, viewportSize);
             m_LastMousePos = currentMousePos;
         } else {
-            std::cout << "Mouse moved but delta too small: (" << mouseDelta.x << ", " << mouseDelta.y << ")" << std::endl;
+            LOG_TRACE(Editor, "Mouse moved but delta too small: (%.2f, %.2f)", mouseDelta.x, mouseDelta.y);
         }
     } else if (m_IsGizmoDragging) {
-        std::cout << "Gizmo dragging but no movement detected" << std::endl;
+        LOG_TRACE(Editor, "Gizmo dragging but no movement detected");
     }
 }
 
 // NEW: Check if gizmo axis is hovered
 bool EngineUI::IsGizmoHovered(const glm::vec3& rayOrigin, const glm::vec3& rayDirection, int& hoveredAxis) {
-    if (!m_SelectedObjectPtr) return false;
+    if (!HasSelection() || !m_Transforms || !m_Transforms->IsAlive(GetSelectedTransform())) return false;
 
-    glm::vec3 objectPos = m_SelectedObjectPtr->transform.position;
+    glm::vec3 objectPos = m_Transforms->GetWorldPosition(GetSelectedTransform());
     float gizmoSize = 2.0f; // Match the rendering size
     float hitDistance = 0.5f; // Smaller hit area for precision
 
@@ -563,8 +1202,8 @@ bool EngineUI::IsGizmoHovered(const glm::vec3& rayOrigin, const glm::vec3& rayDi
 
 // NEW: Update gizmo drag movement
 void EngineUI::UpdateGizmoDrag(const ImVec2& mouseDelta, const ImVec2& viewportSize) {
-    if (!m_SelectedObjectPtr || m_DraggedAxis == -1) {
-        std::cout << "UpdateGizmoDrag: No selected object or invalid axis" << std::endl;
+    if (!HasSelection() || !m_Transforms || !m_Transforms->IsAlive(GetSelectedTransform()) || m_DraggedAxis == -1) {
+        LOG_WARN(Editor, "UpdateGizmoDrag: No selected object or invalid axis");
         return;
     }
 
@@ -576,25 +1215,28 @@ void EngineUI::UpdateGizmoDrag(const ImVec2& mouseDelta, const ImVec2& viewportS
     if (m_DraggedAxis == 0) { // X-axis (Red)
         // Move along world X-axis
         movement = glm::vec3(mouseDelta.x * sensitivity, 0.0f, 0.0f);
-        std::cout << "Moving X-axis: delta=" << mouseDelta.x << ", movement=(" << movement.x << "," << movement.y << "," << movement.z << ")" << std::endl;
+        LOG_TRACE(Editor, "Moving X-axis: delta=%.2f", mouseDelta.x);
     } else if (m_DraggedAxis == 1) { // Y-axis (Green)
         // Move along world Y-axis
         movement = glm::vec3(0.0f, -mouseDelta.y * sensitivity, 0.0f);
-        std::cout << "Moving Y-axis: delta=" << mouseDelta.y << ", movement=(" << movement.x << "," << movement.y << "," << movement.z << ")" << std::endl;
+        LOG_TRACE(Editor, "Moving Y-axis: delta=%.2f", mouseDelta.y);
     } else if (m_DraggedAxis == 2) { // Z-axis (Blue)
         // Move along world Z-axis
         movement = glm::vec3(0.0f, 0.0f, mouseDelta.y * sensitivity);
-        std::cout << "Moving Z-axis: delta=" << mouseDelta.y << ", movement=(" << movement.x << "," << movement.y << "," << movement.z << ")" << std::endl;
+        LOG_TRACE(Editor, "Moving Z-axis: delta=%.2f", mouseDelta.y);
     }
 
-    // Apply movement to object
-    glm::vec3 oldPos = m_SelectedObjectPtr->transform.position;
-    m_SelectedObjectPtr->transform.position += movement;
-    glm::vec3 newPos = m_SelectedObjectPtr->transform.position;
-    
-    std::cout << "Object moved from (" << oldPos.x << "," << oldPos.y << "," << oldPos.z 
-              << ") to (" << newPos.x << "," << newPos.y << "," << newPos.z << ")" << std::endl;
-    
-    // Verify the object pointer is valid
-    std::cout << "Selected object name: " << m_SelectedObjectPtr->name << std::endl;
+    // The same world offset for every selected entity, primary included. Only the topmost selected
+    // transforms are moved: SetWorldPosition works from world matrices of the last Update(), so a
+    // selected child would otherwise move once with its parent and once more on its own.
+    glm::vec3 oldPos = m_Transforms->GetWorldPosition(GetSelectedTransform());
+    glm::vec3 newPos = oldPos + movement;
+    for (Entity entity : m_Selection.GetEntities()) {
+        TransformComponent* transform = m_World->Get<TransformComponent>(entity);
+        if (!transform || !m_Transforms->IsAlive(transform->handle) || HasSelectedAncestor(transform->handle)) continue;
+        m_Transforms->SetWorldPosition(transform->handle, m_Transforms->GetWorldPosition(transform->handle) + movement);
+    }
+
+    LOG_TRACE(Editor, "%s moved from (%.2f, %.2f, %.2f) to (%.2f, %.2f, %.2f)", GetEntityName(m_Selection.GetPrimary()),
+              oldPos.x, oldPos.y, oldPos.z, newPos.x, newPos.y, newPos.z);
 }
\ No newline at end of file
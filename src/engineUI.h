@@ -4,7 +4,22 @@
 #include "imgui.h"
 #include <string>
 #include <vector> // For std::vector
-#include "gameobject.h" // include new GameObject 
+#include "ecs.h"
+#include "components.h"
+#include "pool.h"
+#include "gpu_picker.h"
+#include "selection.h"
+#include "log.h"
+#include "name_index.h"
+#include "profiler.h"
+#include "spatial_index.h"
+#include <deque>
+#include <unordered_set>
+
+class FrameCapture;
+class FrameStats;
+class Mesh;
+
 #include <glm/glm.hpp>
 
 class EngineUI {
@@ -24,34 +39,92 @@ public:
 
     // new additions 
 
-    void SetSceneObjects(std::vector<GameObject*>* objects); // Pass a pointer
-    // to the scene's object list 
-    GameObject* GetSelectedObject() const { return m_SelectedObjectPtr;}
+    void SetWorld(World* world) { m_World = world; } // Pass a pointer to the scene's entities
+    Entity GetSelectedEntity() const { return m_Selection.GetPrimary(); } // primary of the selection
+    const Selection& GetSelection() const { return m_Selection; }
 
     // NEW: Object selection by clicking
     void SetCamera(class Camera* camera) { m_Camera = camera; }
+    // Transform storage the entities' TransformComponent handles point into
+    void SetTransformSystem(TransformSystem* transforms) { m_Transforms = transforms; }
+    // Broad phase (scene BVH) and mesh storage used for precise picking
+    void SetSpatialIndex(SpatialIndex* index) { m_SpatialIndex = index; }
+    void SetMeshPool(Pool<Mesh>* meshes) { m_Meshes = meshes; }
+    // Screenshots and recordings of the viewport ("Captura" menu)
+    void SetFrameCapture(FrameCapture* capture) { m_FrameCapture = capture; }
+    // Frame timings and render counters ("Estatísticas" panel)
+    void SetFrameStats(const FrameStats* stats) { m_FrameStats = stats; }
     void HandleViewportClick(const ImVec2& clickPos, const ImVec2& viewportSize);
 
     // NEW: 3D Gizmo rendering
-    void RenderGizmos(class Shader* shader, const glm::mat4& view, const glm::mat4& projection);
+    void RenderGizmos(class DebugDraw& debugDraw);
     
     // NEW: Interactive gizmo functionality
     void HandleGizmoInteraction(const ImVec2& mousePos, const ImVec2& viewportSize, bool isMouseDown, bool isMouseDragging);
     bool IsGizmoHovered(const glm::vec3& rayOrigin, const glm::vec3& rayDirection, int& hoveredAxis);
     void UpdateGizmoDrag(const ImVec2& mouseDelta, const ImVec2& viewportSize);
 
+    // Scene pass GPU timing, shown in the menu bar
+    void SetScenePassStats(double gpuMs, int drawCount) { m_ScenePassGpuMs = gpuMs; m_ScenePassDraws = drawCount; }
+    // When true, main.cpp renders with the per-vertex inverse(model) shader for comparison
+    bool UseLegacyNormalMatrix() const { return m_UseLegacyNormalMatrix; }
+
+    // Set by main.cpp each frame: true when the scene pass wrote object IDs into the framebuffer
+    void SetGpuPickingAvailable(bool available) { m_GpuPickingAvailable = available; }
+    // Entity under the cursor from the GPU ID buffer (resolved a frame late), for hover highlighting
+    Entity GetHoveredEntity() const { return m_HoveredEntity; }
+    bool HasPendingGpuPicks() const { return m_GpuPicker.HasPending(); }
+    // Input recording/replay: blocks on GPU picks so they resolve on a fixed frame
+    void SetWaitForGpuPicks(bool wait) { m_WaitForGpuPicks = wait; }
+
+    // Input recording/replay: ImGui runs on the recorded delta time instead of the clock (0 = off)
+    void SetDeltaTimeOverride(float deltaTime) { m_DeltaTimeOverride = deltaTime; }
+    // UI layout (ImGui ini contents): saved into input recordings, restored on replay.
+    // Using a layout stops ImGui from reading or writing imgui.ini for the rest of the session.
+    std::string GetLayoutSettings() const;
+    void UseLayoutSettings(const std::string& settings);
+
+    // Render on demand: main.cpp re-renders the viewport only when something it draws changed.
+    // The version covers the editor state drawn into the viewport (selection, hover, gizmos...).
+    bool IsRenderOnDemand() const { return m_RenderOnDemand; }
+    uint64_t GetViewportVersion() const { return m_ViewportVersion; }
+    void InvalidateViewport() { ++m_ViewportVersion; }
+    // Called by main.cpp after the viewport framebuffer was re-rendered (new ID buffer contents)
+    void NotifyViewportRendered() { ++m_ViewportRenderCount; }
+
+    // Dynamic resolution settings (the controller lives in main.cpp, which reports the scale back)
+    bool IsDynamicResolutionEnabled() const { return m_DynamicResolution; }
+    float GetDynamicResolutionTargetMs() const { return m_DynamicResolutionTargetMs; }
+    void SetRenderScale(float scale) { m_RenderScale = scale; }
+
 private:
+    void UpdateViewportVersion();
     void DrawMainDockspace();
     void DrawViewport();
     void DrawHierarchy();
+    void RebuildHierarchyRows();
+    void UpdateHierarchySearch();
+    void DrawHierarchyRow(Entity entity, uint32_t depth, bool hasChildren);
+    void HandleHierarchyClick(Entity entity);
     void DrawInspector();
     void DrawAssetBrowser();
     void DrawConsole();
+    void DrawProfiler();
+    void DrawFrameStats();
+    void DrawGlTrace();
     void DrawMenuBar();
     void DrawGizmos(); // NEW: Draw gizmos for selected object
 
     // NEW: Ray casting for object selection
-    GameObject* PickObject(const glm::vec3& rayOrigin, const glm::vec3& rayDirection);
+    PickResult PickObject(const glm::vec3& rayOrigin, const glm::vec3& rayDirection);
+    // GPU ID-buffer picking: queue reads, and apply the ones that came back
+    bool RequestGpuPick(const ImVec2& screenPos, const ImVec2& imageMin, const ImVec2& imageSize, uint32_t tag);
+    void ResolveGpuPicks();
+    void ApplySelection(Entity picked);
+
+    // Marquee (box) selection: the screen rectangle becomes a sub-frustum queried on the spatial index
+    void ApplyMarquee(const ImVec2& a, const ImVec2& b, const ImVec2& imageMin, const ImVec2& imageSize);
+    void DrawBatchTransformEditor();
     glm::vec3 ScreenToWorldRay(const ImVec2& screenPos, const ImVec2& viewportSize);
 
     // framebuffer reference 
@@ -70,12 +143,34 @@ private:
     float m_Rotation[3] = { 0.0f, 0.0f, 0.0f };
     float m_Scale[3] = { 1.0f, 1.0f, 1.0f };*/
 
-    std::vector<GameObject*>* m_SceneObjectsPtr = nullptr; // Ponter to the actual list of objects in the scene
-    GameObject* m_SelectedObjectPtr = nullptr; // Pointer to the selected object
+    // Selection helpers (selection is an Entity handle, so a destroyed entity simply reads as "nothing selected")
+    bool HasSelection() const { return m_World && m_World->IsAlive(m_Selection.GetPrimary()); }
+    TransformHandle GetSelectedTransform();
+    const char* GetEntityName(Entity entity);
+    Entity GetEntityOf(TransformHandle handle) const;
+    // True if a parent, grandparent... of handle is selected too: edits to the selection go to
+    // the topmost selected transforms only, which carry their selected descendants along
+    bool HasSelectedAncestor(TransformHandle handle) const;
+
+    World* m_World = nullptr; // Pointer to the scene's entities
+    Selection m_Selection;    // Selected entities (sorted); the primary one drives gizmos
+    uint64_t m_SelectionWorldVersion = 0; // World structure version the selection was last pruned at
+
+    // Marquee drag state (screen coordinates)
+    bool m_MarqueeArmed = false;  // left button went down in the viewport, off the gizmo
+    bool m_MarqueeActive = false; // ...and has moved far enough to count as a drag (no click pick on release)
+    ImVec2 m_MarqueeStart = { 0, 0 };
 
     // NEW: Camera reference for ray casting
     class Camera* m_Camera = nullptr;
 
+    TransformSystem* m_Transforms = nullptr;
+    SpatialIndex* m_SpatialIndex = nullptr;
+    Pool<Mesh>* m_Meshes = nullptr;
+    FrameCapture* m_FrameCapture = nullptr;
+    const FrameStats* m_FrameStats = nullptr;
+    bool m_Initialized = false; // ImGui context and backends exist (not in headless runs)
+
     // NEW: Gizmo state
     enum class GizmoMode {
         Translate,
@@ -91,12 +186,81 @@ private:
     int m_DraggedAxis = -1;
     ImVec2 m_LastMousePos = {0, 0};
     glm::vec3 m_GizmoDragStartPos = glm::vec3(0.0f);
-    
-    // NEW: Gizmo shader for proper rendering
-    Shader* m_GizmoShader = nullptr;
+
+    // GPU ID-buffer picking (click selection + hover)
+    enum GpuPickTag : uint32_t { kGpuPickClick = 1, kGpuPickHover = 2 };
+    GpuPicker m_GpuPicker;
+    bool m_UseGpuPicking = true;
+    bool m_GpuPickingAvailable = false;
+    bool m_HoverPickPending = false;
+    bool m_WaitForGpuPicks = false;
+    Entity m_HoveredEntity;
+    float m_DeltaTimeOverride = 0.0f;
+
+    // Scene pass stats
+    double m_ScenePassGpuMs = 0.0;
+    int m_ScenePassDraws = 0;
+    bool m_UseLegacyNormalMatrix = false;
+
+    // Render on demand
+    struct ViewportState {
+        uint64_t selectionVersion = 0;
+        Entity hoveredEntity;
+        int hoveredAxis = -1;
+        int draggedAxis = -1;
+        bool showGizmos = true;
+        bool legacyNormalMatrix = false;
+
+        bool operator==(const ViewportState& other) const {
+            return selectionVersion == other.selectionVersion && hoveredEntity == other.hoveredEntity &&
+                   hoveredAxis == other.hoveredAxis && draggedAxis == other.draggedAxis &&
+                   showGizmos == other.showGizmos && legacyNormalMatrix == other.legacyNormalMatrix;
+        }
+    };
+    bool m_RenderOnDemand = true;
+    bool m_DynamicResolution = false;
+    float m_DynamicResolutionTargetMs = 8.0f;
+    float m_RenderScale = 1.0f;
+    uint64_t m_ViewportVersion = 0;
+    uint64_t m_ViewportRenderCount = 0;
+    // Hover picks are only re-issued when the cursor moved or the image changed
+    ImVec2 m_HoverPickMouse = { -1.0f, -1.0f };
+    uint64_t m_HoverPickRenderCount = ~0ull;
+    ViewportState m_LastViewportState;
+
+    // Hierarchy: the expanded tree flattened into rows, so only the visible ones are drawn
+    struct HierarchyRow {
+        Entity entity;
+        uint32_t depth = 0;
+        bool hasChildren = false;
+    };
+    std::vector<HierarchyRow> m_HierarchyRows;
+    std::unordered_set<uint64_t> m_CollapsedEntities; // nodes start open
+    uint64_t m_HierarchyWorldVersion = ~0ull;
+    uint64_t m_HierarchyTransformVersion = ~0ull;
+    bool m_HierarchyDirty = true;
+
+    // Hierarchy search (trigram index over the entity names)
+    NameIndex m_NameIndex;
+    char m_HierarchySearch[64] = "";
+    std::string m_LastHierarchySearch;
+    uint64_t m_SearchIndexVersion = ~0ull;
+    std::vector<Entity> m_SearchResults;
+
+    // Console: a copy of the logger's history plus the rows that pass the filters
+    std::deque<LogLine> m_ConsoleLines;
+    std::vector<int> m_ConsoleRows;
+    uint64_t m_ConsoleCursor = 0; // next logger history line to read
+    int m_ConsoleMinLevel = static_cast<int>(LogLevel::Trace);
+    int m_ConsoleCategory = 0;    // 0 = all, otherwise category + 1
+    bool m_ConsoleAutoScroll = true;
+
+    // Profiler panel: the frame shown in the flame graph is frozen while paused
+    bool m_ProfilerPaused = false;
+    ProfileFrame m_ProfilerFrame;
 
     // Asset Browser data (Will be expanded later)
     int m_AssetTypeIndex = 0;
-    //std::string m_SelectedObject; removed, it was replaced by m_SelectedObjectPtr
+    //std::string m_SelectedObject; removed, it was replaced by m_Selection
 
 };
\ No newline at end of file
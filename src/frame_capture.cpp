@@ -0,0 +1,278 @@
+#include "frame_capture.h"
+#include "framebuffer.h"
+#include "image_writer.h"
+#include "log.h"
+#include <chrono>
+
+namespace {
+    double ElapsedMs(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+FrameCapture::FrameCapture() {
+    m_Thread = std::thread(&FrameCapture::EncoderThread, this);
+}
+
+// Shutdown() should have run with the context current; this only stops the thread
+FrameCapture::~FrameCapture() {
+    if (!m_Thread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stopping = true;
+    }
+    m_Condition.notify_one();
+    m_Thread.join();
+}
+
+// Buffers are created on first use so the object can be constructed before a context exists
+void FrameCapture::CreateBuffers() {
+    for (Slot& slot : m_Slots) glGenBuffers(1, &slot.pbo);
+    m_Created = true;
+}
+
+void FrameCapture::RequestScreenshot(const std::string& path) {
+    m_ScreenshotPath = path;
+}
+
+void FrameCapture::StartRecording(const std::string& path, int framesPerSecond) {
+    if (m_Recording) StopRecording();
+    Job job;
+    job.type = Job::OpenRecording;
+    job.path = path;
+    job.framesPerSecond = framesPerSecond;
+    Submit(job);
+    m_Recording = true;
+    m_RecordingWidth = m_RecordingHeight = 0;
+    m_RecordedFrames.store(0, std::memory_order_relaxed);
+    m_DroppedFrames = 0;
+    LOG_INFO(Render, "Gravando viewport em %s (%d fps)", path, framesPerSecond);
+}
+
+// Frames already read keep their place in the queue ahead of the close
+void FrameCapture::StopRecording() {
+    if (!m_Recording) return;
+    m_Recording = false;
+    Job job;
+    job.type = Job::CloseRecording;
+    Submit(job);
+}
+
+void FrameCapture::Capture(const Framebuffer& framebuffer) {
+    auto start = std::chrono::steady_clock::now();
+    int width = static_cast<int>(framebuffer.GetRenderWidth());
+    int height = static_cast<int>(framebuffer.GetRenderHeight());
+
+    // A Y4M stream has one size: frames rendered at another one (resize, dynamic resolution) are dropped
+    bool recordFrame = m_Recording;
+    if (recordFrame && m_RecordingWidth != 0 && (width != m_RecordingWidth || height != m_RecordingHeight)) {
+        recordFrame = false;
+        ++m_DroppedFrames;
+    }
+    if (!recordFrame && m_ScreenshotPath.empty()) return;
+
+    Slot* slot = nullptr;
+    for (Slot& candidate : m_Slots) {
+        if (candidate.state == SlotState::Free) { slot = &candidate; break; }
+    }
+    if (!slot) {
+        if (recordFrame) ++m_DroppedFrames; // a pending screenshot just waits for the next frame
+        m_FrameCpuMs += ElapsedMs(start);
+        return;
+    }
+    if (!m_Created) CreateBuffers();
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot->pbo);
+    size_t bytes = static_cast<size_t>(width) * height * 4;
+    if (slot->capacity < bytes) {
+        glBufferData(GL_PIXEL_PACK_BUFFER, bytes, nullptr, GL_STREAM_READ);
+        slot->capacity = bytes;
+    }
+
+    GLint previousRead = 0;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousRead);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer.GetFBO());
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+
+    // With a PACK buffer bound, glReadPixels only queues a copy into it and returns
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, previousRead);
+
+    slot->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot->state = SlotState::Reading;
+    slot->width = width;
+    slot->height = height;
+    slot->screenshotPath.swap(m_ScreenshotPath);
+    m_ScreenshotPath.clear();
+    slot->recordFrame = recordFrame;
+    slot->sequence = m_NextSequence++;
+    if (recordFrame && m_RecordingWidth == 0) {
+        m_RecordingWidth = width;
+        m_RecordingHeight = height;
+    }
+    m_FrameCpuMs += ElapsedMs(start);
+}
+
+// Maps finished reads, oldest first so recorded frames reach the encoder in order.
+// With wait, blocks until every read has finished (shutdown only).
+void FrameCapture::DrainSlots(bool wait) {
+    for (;;) {
+        Slot* oldest = nullptr;
+        for (Slot& slot : m_Slots) {
+            if (slot.state == SlotState::Reading && (!oldest || slot.sequence < oldest->sequence)) oldest = &slot;
+        }
+        if (!oldest) return;
+
+        // Zero timeout unless waiting: only asks whether the copy has finished
+        GLenum status = wait ? glClientWaitSync(oldest->fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull)
+                             : glClientWaitSync(oldest->fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+            if (!wait) return;
+            if (status == GL_WAIT_FAILED) {
+                LOG_ERROR(Render, "Captura: falha ao esperar a leitura do framebuffer");
+                return;
+            }
+            continue; // timed out: keep waiting
+        }
+        glDeleteSync(oldest->fence);
+        oldest->fence = nullptr;
+
+        size_t bytes = static_cast<size_t>(oldest->width) * oldest->height * 4;
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, oldest->pbo);
+        const void* mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, bytes, GL_MAP_READ_BIT);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        if (!mapped) {
+            LOG_ERROR(Render, "Captura: glMapBufferRange falhou");
+            oldest->state = SlotState::Free;
+            continue;
+        }
+
+        // The mapping stays valid until unmapped; the encoder reads it directly
+        oldest->state = SlotState::Encoding;
+        Job job;
+        job.type = Job::Frame;
+        job.slot = oldest;
+        job.pixels = static_cast<const unsigned char*>(mapped);
+        Submit(job);
+    }
+}
+
+void FrameCapture::Update() {
+    if (!m_Created) return;
+    auto start = std::chrono::steady_clock::now();
+
+    DrainSlots(false);
+
+    // Buffers the encoder is done with go back to the ring
+    for (Slot& slot : m_Slots) {
+        if (slot.state != SlotState::Encoding || !slot.encoded.load(std::memory_order_acquire)) continue;
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        slot.encoded.store(false, std::memory_order_relaxed);
+        slot.state = SlotState::Free;
+    }
+
+    m_LastCpuMs = m_FrameCpuMs + ElapsedMs(start);
+    m_FrameCpuMs = 0.0;
+}
+
+void FrameCapture::Shutdown() {
+    if (m_Created) DrainSlots(true);
+    StopRecording();
+
+    if (m_Thread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Stopping = true;
+        }
+        m_Condition.notify_one();
+        m_Thread.join(); // the thread finishes the queued jobs first
+    }
+
+    if (!m_Created) return;
+    for (Slot& slot : m_Slots) {
+        if (slot.state == SlotState::Encoding) {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+        if (slot.fence) glDeleteSync(slot.fence);
+        glDeleteBuffers(1, &slot.pbo);
+        slot.pbo = 0;
+        slot.capacity = 0;
+        slot.fence = nullptr;
+        slot.state = SlotState::Free;
+        slot.encoded.store(false, std::memory_order_relaxed);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    m_Created = false;
+}
+
+bool FrameCapture::HasPending() const {
+    for (const Slot& slot : m_Slots) {
+        if (slot.state != SlotState::Free) return true;
+    }
+    return false;
+}
+
+void FrameCapture::Submit(Job job) {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Jobs.push_back(std::move(job));
+    }
+    m_Condition.notify_one();
+}
+
+void FrameCapture::EncoderThread() {
+    Y4MWriter writer;
+    std::string recordingPath;
+    int recordingFps = 60;
+
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Condition.wait(lock, [this] { return m_Stopping || !m_Jobs.empty(); });
+            if (m_Jobs.empty()) break; // stopping and nothing left
+            job = std::move(m_Jobs.front());
+            m_Jobs.pop_front();
+        }
+
+        switch (job.type) {
+        case Job::OpenRecording:
+            writer.Close();
+            recordingPath = job.path;
+            recordingFps = job.framesPerSecond;
+            break;
+        case Job::CloseRecording:
+            if (writer.IsOpen()) {
+                writer.Close();
+                LOG_INFO(Render, "Gravação salva: %s (%llu quadros)", recordingPath, GetRecordedFrames());
+            }
+            recordingPath.clear();
+            break;
+        case Job::Frame: {
+            Slot& slot = *job.slot;
+            if (!slot.screenshotPath.empty()) {
+                // glReadPixels rows are bottom-up
+                if (WriteQoi(slot.screenshotPath, job.pixels, slot.width, slot.height, 4, true))
+                    LOG_INFO(Render, "Captura salva: %s (%dx%d)", slot.screenshotPath, slot.width, slot.height);
+                else
+                    LOG_ERROR(Render, "Falha ao salvar a captura %s", slot.screenshotPath);
+            }
+            if (slot.recordFrame && !recordingPath.empty()) {
+                if (!writer.IsOpen() && !writer.Open(recordingPath, slot.width, slot.height, recordingFps)) {
+                    LOG_ERROR(Render, "Falha ao abrir a gravação %s", recordingPath);
+                    recordingPath.clear();
+                } else if (writer.WriteFrame(job.pixels, true)) {
+                    m_RecordedFrames.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            slot.encoded.store(true, std::memory_order_release);
+            break;
+        }
+        }
+    }
+}
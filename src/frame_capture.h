@@ -0,0 +1,104 @@
+#pragma once
+#include <glad/glad.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+class Framebuffer;
+
+// FrameCapture saves the viewport as QOI screenshots or a Y4M recording without stalling
+// the render thread.
+//
+// Capture() queues a glReadPixels of the framebuffer's render rectangle into one of
+// kSlotCount pixel buffer objects and drops a fence behind it. Update() maps the buffers
+// whose fence has signaled and hands the mapped pointer to a background thread, which
+// converts and writes the frame; the buffer is unmapped and reused once that is done.
+// The render thread never copies pixels: its cost is the read call, a fence and a map.
+//
+// When every slot is busy (the encoder or the GPU is behind) the frame is dropped and
+// counted rather than waited for.
+class FrameCapture {
+public:
+    static const int kSlotCount = 3;
+
+    FrameCapture();
+    ~FrameCapture();
+
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+
+    // Saves the next captured frame as a QOI image
+    void RequestScreenshot(const std::string& path);
+    // Every following Capture() becomes a Y4M frame; the size is fixed by the first one
+    void StartRecording(const std::string& path, int framesPerSecond = 60);
+    void StopRecording();
+    bool IsRecording() const { return m_Recording; }
+    // True when the next Capture() has something to do
+    bool IsCaptureRequested() const { return m_Recording || !m_ScreenshotPath.empty(); }
+
+    // Call after the viewport was rendered (or each frame while recording)
+    void Capture(const Framebuffer& framebuffer);
+    // Call once per frame: forwards finished reads and recycles encoded buffers
+    void Update();
+    // Waits for everything in flight, closes the recording and releases the buffers.
+    // Must run while the GL context is current.
+    void Shutdown();
+
+    bool HasPending() const;
+    uint64_t GetRecordedFrames() const { return m_RecordedFrames.load(std::memory_order_relaxed); }
+    uint64_t GetDroppedFrames() const { return m_DroppedFrames; }
+    // Render thread time spent in Capture() + Update() during the last frame
+    double GetLastCpuMs() const { return m_LastCpuMs; }
+
+private:
+    enum class SlotState : uint8_t { Free, Reading, Encoding };
+
+    struct Slot {
+        GLuint pbo = 0;
+        size_t capacity = 0; // bytes allocated for the buffer
+        GLsync fence = nullptr;
+        SlotState state = SlotState::Free;
+        int width = 0, height = 0;
+        std::string screenshotPath;
+        bool recordFrame = false;
+        uint64_t sequence = 0;
+        std::atomic<bool> encoded{ false }; // set by the encoder thread
+    };
+
+    // Encoder thread work, processed strictly in order
+    struct Job {
+        enum Type : uint8_t { Frame, OpenRecording, CloseRecording } type = Frame;
+        Slot* slot = nullptr;
+        const unsigned char* pixels = nullptr;
+        std::string path;
+        int framesPerSecond = 0;
+    };
+
+    void CreateBuffers();
+    void Submit(Job job);
+    void EncoderThread();
+    void DrainSlots(bool wait);
+
+    Slot m_Slots[kSlotCount];
+    bool m_Created = false;
+    uint64_t m_NextSequence = 0;
+
+    std::string m_ScreenshotPath;
+    bool m_Recording = false;
+    int m_RecordingWidth = 0, m_RecordingHeight = 0; // 0 until the first recorded frame
+
+    std::thread m_Thread;
+    std::mutex m_Mutex;
+    std::condition_variable m_Condition;
+    std::deque<Job> m_Jobs;
+    bool m_Stopping = false;
+
+    std::atomic<uint64_t> m_RecordedFrames{ 0 };
+    uint64_t m_DroppedFrames = 0;
+    double m_FrameCpuMs = 0.0;
+    double m_LastCpuMs = 0.0;
+};
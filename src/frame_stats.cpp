@@ -0,0 +1,198 @@
+#include "frame_stats.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <vector>
+
+RenderCounters FrameStats::s_Counters;
+
+namespace {
+    uint64_t NowNs() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    const int kPassCount = static_cast<int>(GpuPass::Count);
+}
+
+FrameStats::FrameStats() {
+    for (QueryFrame& queryFrame : m_QueryFrames) {
+        glGenQueries(kPassCount * 2, &queryFrame.queries[0][0]);
+    }
+}
+
+void FrameStats::Release() {
+    if (m_Released) return;
+    for (QueryFrame& queryFrame : m_QueryFrames) {
+        glDeleteQueries(kPassCount * 2, &queryFrame.queries[0][0]);
+        queryFrame.pending = false;
+    }
+    m_Released = true;
+}
+
+void FrameStats::BeginFrame() {
+    Resolve(false);
+    s_Counters = RenderCounters();
+    m_FrameStart = NowNs();
+
+    // Slot still in flight: the GPU is more than kQueryFrames frames behind, skip timing this frame
+    QueryFrame& queryFrame = m_QueryFrames[m_CurrentQueryFrame];
+    m_TimingFrame = !queryFrame.pending;
+    if (m_TimingFrame) {
+        queryFrame.issued = 0;
+        queryFrame.frame = m_FrameIndex;
+    }
+}
+
+void FrameStats::EndFrame() {
+    FrameStatsRecord record;
+    record.frame = m_FrameIndex;
+    record.cpuMs = (NowNs() - m_FrameStart) / 1000000.0;
+    record.counters = s_Counters;
+    m_History.push_back(record);
+    while (m_History.size() > m_HistorySize) m_History.pop_front();
+
+    if (m_TimingFrame) {
+        QueryFrame& queryFrame = m_QueryFrames[m_CurrentQueryFrame];
+        queryFrame.pending = queryFrame.issued != 0;
+        m_CurrentQueryFrame = (m_CurrentQueryFrame + 1) % kQueryFrames;
+        m_TimingFrame = false;
+    }
+    m_FrameIndex++;
+}
+
+void FrameStats::BeginPass(GpuPass pass) {
+    if (!m_TimingFrame) return;
+    glQueryCounter(m_QueryFrames[m_CurrentQueryFrame].queries[static_cast<int>(pass)][0], GL_TIMESTAMP);
+}
+
+void FrameStats::EndPass(GpuPass pass) {
+    if (!m_TimingFrame) return;
+    QueryFrame& queryFrame = m_QueryFrames[m_CurrentQueryFrame];
+    glQueryCounter(queryFrame.queries[static_cast<int>(pass)][1], GL_TIMESTAMP);
+    queryFrame.issued |= 1 << static_cast<int>(pass);
+}
+
+void FrameStats::WaitForGpu() {
+    Resolve(true);
+}
+
+// Read back finished frames, oldest first. Queries complete in submission order, so a frame
+// is done once its last timestamp is available.
+void FrameStats::Resolve(bool wait) {
+    for (int k = 0; k < kQueryFrames; ++k) {
+        QueryFrame& queryFrame = m_QueryFrames[(m_CurrentQueryFrame + k) % kQueryFrames];
+        if (!queryFrame.pending) continue;
+
+        GLuint lastQuery = 0;
+        for (int pass = 0; pass < kPassCount; ++pass) {
+            if (queryFrame.issued & (1 << pass)) lastQuery = queryFrame.queries[pass][1];
+        }
+        if (!wait) {
+            GLint available = 0;
+            glGetQueryObjectiv(lastQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) break; // later frames can't be done either
+        }
+
+        FrameStatsRecord* record = nullptr;
+        if (!m_History.empty() && queryFrame.frame >= m_History.front().frame &&
+            queryFrame.frame - m_History.front().frame < m_History.size()) {
+            record = &m_History[static_cast<size_t>(queryFrame.frame - m_History.front().frame)];
+        }
+        for (int pass = 0; pass < kPassCount; ++pass) {
+            if (!(queryFrame.issued & (1 << pass))) continue;
+            GLuint64 begin = 0, end = 0;
+            glGetQueryObjectui64v(queryFrame.queries[pass][0], GL_QUERY_RESULT, &begin);
+            glGetQueryObjectui64v(queryFrame.queries[pass][1], GL_QUERY_RESULT, &end);
+            double ms = end > begin ? (end - begin) / 1000000.0 : 0.0;
+            m_LastGpuMs[pass] = ms;
+            if (record) {
+                record->gpuMs[pass] = ms;
+                record->gpuResolved |= 1 << pass;
+            }
+        }
+        queryFrame.pending = false;
+    }
+}
+
+void FrameStats::SetHistorySize(size_t frames) {
+    m_HistorySize = std::max<size_t>(frames, 1);
+    while (m_History.size() > m_HistorySize) m_History.pop_front();
+}
+
+bool FrameStats::GetValue(const FrameStatsRecord& record, FrameMetric metric, double& value) {
+    auto gpu = [&](GpuPass pass) {
+        int index = static_cast<int>(pass);
+        value = record.gpuMs[index];
+        return (record.gpuResolved & (1 << index)) != 0;
+    };
+    switch (metric) {
+        case FrameMetric::CpuMs: value = record.cpuMs; return true;
+        case FrameMetric::GpuSceneMs: return gpu(GpuPass::Scene);
+        case FrameMetric::GpuGizmosMs: return gpu(GpuPass::Gizmos);
+        case FrameMetric::GpuUiMs: return gpu(GpuPass::UI);
+        case FrameMetric::DrawCalls: value = record.counters.drawCalls; return true;
+        case FrameMetric::Triangles: value = static_cast<double>(record.counters.triangles); return true;
+        case FrameMetric::StateChanges: value = record.counters.stateChanges; return true;
+        case FrameMetric::TextureBinds: value = record.counters.textureBinds; return true;
+        case FrameMetric::UploadedKB: value = record.counters.uploadedBytes / 1024.0; return true;
+        default: return false;
+    }
+}
+
+const char* FrameStats::GetMetricName(FrameMetric metric) {
+    switch (metric) {
+        case FrameMetric::CpuMs: return "CPU (ms)";
+        case FrameMetric::GpuSceneMs: return "GPU cena (ms)";
+        case FrameMetric::GpuGizmosMs: return "GPU gizmos (ms)";
+        case FrameMetric::GpuUiMs: return "GPU UI (ms)";
+        case FrameMetric::DrawCalls: return "Draw calls";
+        case FrameMetric::Triangles: return "Triângulos";
+        case FrameMetric::StateChanges: return "Mudanças de estado";
+        case FrameMetric::TextureBinds: return "Binds de textura";
+        case FrameMetric::UploadedKB: return "Upload (KB)";
+        default: return "?";
+    }
+}
+
+StatSummary FrameStats::Summarize(FrameMetric metric) const {
+    std::vector<double> values;
+    values.reserve(m_History.size());
+    double total = 0.0;
+    for (const FrameStatsRecord& record : m_History) {
+        double value;
+        if (!GetValue(record, metric, value)) continue;
+        values.push_back(value);
+        total += value;
+    }
+
+    StatSummary summary;
+    if (values.empty()) return summary;
+    std::sort(values.begin(), values.end());
+    auto percentile = [&](double p) { return values[std::min(values.size() - 1, static_cast<size_t>(p * (values.size() - 1) + 0.5))]; };
+    summary.samples = static_cast<int>(values.size());
+    summary.average = total / values.size();
+    summary.p50 = percentile(0.5);
+    summary.p95 = percentile(0.95);
+    summary.p99 = percentile(0.99);
+    summary.max = values.back();
+    return summary;
+}
+
+bool FrameStats::ExportCsv(const std::string& path) const {
+    std::ofstream csv(path);
+    if (!csv) return false;
+
+    csv << "frame,cpu_ms,gpu_scene_ms,gpu_gizmos_ms,gpu_ui_ms,draw_calls,triangles,state_changes,texture_binds,uploaded_bytes\n";
+    for (const FrameStatsRecord& record : m_History) {
+        csv << record.frame << ',' << record.cpuMs;
+        for (int pass = 0; pass < kPassCount; ++pass) {
+            csv << ',';
+            if (record.gpuResolved & (1 << pass)) csv << record.gpuMs[pass];
+        }
+        const RenderCounters& counters = record.counters;
+        csv << ',' << counters.drawCalls << ',' << counters.triangles << ',' << counters.stateChanges << ','
+            << counters.textureBinds << ',' << counters.uploadedBytes << '\n';
+    }
+    return static_cast<bool>(csv);
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include <glad/glad.h>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+
+// Passes timed on the GPU every frame
+enum class GpuPass : uint8_t { Scene, Gizmos, UI, Count };
+
+// Work submitted by the engine in one frame (ImGui's own draws are not included)
+struct RenderCounters {
+    uint32_t drawCalls = 0;
+    uint64_t triangles = 0;
+    uint32_t stateChanges = 0; // program and vertex array binds
+    uint32_t textureBinds = 0;
+    uint64_t uploadedBytes = 0; // buffer and texture data sent to the GPU
+};
+
+struct FrameStatsRecord {
+    uint64_t frame = 0;
+    double cpuMs = 0.0; // BeginFrame() to EndFrame()
+    double gpuMs[static_cast<int>(GpuPass::Count)] = {};
+    uint8_t gpuResolved = 0; // bit per pass whose GPU time has been read back
+    RenderCounters counters;
+};
+
+// Values the stats panel and the exports summarize
+enum class FrameMetric : uint8_t {
+    CpuMs, GpuSceneMs, GpuGizmosMs, GpuUiMs, DrawCalls, Triangles, StateChanges, TextureBinds, UploadedKB, Count
+};
+
+struct StatSummary {
+    int samples = 0;
+    double average = 0.0, p50 = 0.0, p95 = 0.0, p99 = 0.0, max = 0.0;
+};
+
+// FrameStats keeps a rolling per-frame history of CPU time, GPU pass times and render
+// counters.
+//
+// GPU passes are timed with glQueryCounter(GL_TIMESTAMP) pairs from a pool of
+// kQueryFrames frames' worth of queries. A frame's queries are read back once the last of
+// them is available, a few frames later, and the times are written into that frame's
+// record; nothing waits on the GPU. When the GPU falls further behind than the pool, the
+// frame is left untimed instead.
+//
+// Counters are plain increments from Mesh, Shader, Texture and DebugDraw on the GL thread.
+class FrameStats {
+public:
+    static const int kQueryFrames = 4;
+    static const size_t kDefaultHistory = 300;
+
+    FrameStats();
+    ~FrameStats() { Release(); }
+
+    FrameStats(const FrameStats&) = delete;
+    FrameStats& operator=(const FrameStats&) = delete;
+
+    // Deletes the timer queries; call while the context is still current (the destructor then does nothing)
+    void Release();
+
+    void BeginFrame();
+    void EndFrame();
+    void BeginPass(GpuPass pass);
+    void EndPass(GpuPass pass);
+    // Blocks until every issued query is read back (end of a headless run)
+    void WaitForGpu();
+
+    // Latest resolved GPU time of a pass (0 until one resolves)
+    double GetLastGpuMs(GpuPass pass) const { return m_LastGpuMs[static_cast<int>(pass)]; }
+    const std::deque<FrameStatsRecord>& GetHistory() const { return m_History; }
+    void SetHistorySize(size_t frames);
+
+    // False for GPU metrics of a pass that was not drawn or not read back
+    static bool GetValue(const FrameStatsRecord& record, FrameMetric metric, double& value);
+    static const char* GetMetricName(FrameMetric metric);
+    StatSummary Summarize(FrameMetric metric) const;
+    // One line per frame in the history; unresolved GPU times are left empty
+    bool ExportCsv(const std::string& path) const;
+
+    static void CountDraw(uint64_t triangles) { s_Counters.drawCalls++; s_Counters.triangles += triangles; }
+    static void CountStateChange() { s_Counters.stateChanges++; }
+    static void CountTextureBind() { s_Counters.textureBinds++; }
+    static void CountUpload(uint64_t bytes) { s_Counters.uploadedBytes += bytes; }
+
+private:
+    struct QueryFrame {
+        GLuint queries[static_cast<int>(GpuPass::Count)][2] = {};
+        uint8_t issued = 0; // passes with both timestamps written
+        uint64_t frame = 0;
+        bool pending = false;
+    };
+
+    void Resolve(bool wait);
+
+    QueryFrame m_QueryFrames[kQueryFrames];
+    int m_CurrentQueryFrame = 0;
+    bool m_TimingFrame = false; // the current frame has a free query slot
+    bool m_Released = false;
+    double m_LastGpuMs[static_cast<int>(GpuPass::Count)] = {};
+
+    std::deque<FrameStatsRecord> m_History;
+    size_t m_HistorySize = kDefaultHistory;
+    uint64_t m_FrameIndex = 0;
+    uint64_t m_FrameStart = 0; // steady clock, nanoseconds
+
+    static RenderCounters s_Counters;
+};
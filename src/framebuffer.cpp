@@ -1,8 +1,30 @@
 #include "framebuffer.h"
 #include <glad/glad.h>
-#include <iostream>
+#include "log.h"
 #include <cstdio>  
 
+// Allocates level 0 of the bound texture at the given size.
+// Immutable storage (glTexStorage2D, GL 4.2) lets the driver skip the per-use validation and
+// reallocation checks of glTexImage2D; it cannot be respecified, so growing recreates the texture.
+static void AllocateTextureStorage(GLenum internalFormat, GLenum format, GLenum type,
+                                   unsigned int width, unsigned int height) {
+    if (GLAD_GL_VERSION_4_2)
+        glTexStorage2D(GL_TEXTURE_2D, 1, internalFormat, width, height);
+    else
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, type, nullptr);
+}
+
+// Storage grows by at least this factor and is rounded up to this many pixels,
+// so dragging a dock splitter outwards reallocates a handful of times instead of every frame
+static const float kStorageGrowth = 1.5f;
+static const unsigned int kStorageAlignment = 64;
+
+static unsigned int GrowStorageExtent(unsigned int current, unsigned int needed) {
+    unsigned int grown = static_cast<unsigned int>(current * kStorageGrowth);
+    unsigned int extent = needed > grown ? needed : grown;
+    return (extent + kStorageAlignment - 1) / kStorageAlignment * kStorageAlignment;
+}
+
 
 // Framebuffer constructor
 // This constructor initializes the framebuffer object
@@ -10,8 +32,9 @@
 // It sets the size of the framebuffer object
 // It sets the size of the texture object
 // It sets the size of the renderbuffer object
-Framebuffer::Framebuffer(unsigned int width, unsigned int height)
-    : m_Width(width), m_Height(height) {
+Framebuffer::Framebuffer(unsigned int width, unsigned int height, bool withObjectIds)
+    : m_Width(width), m_Height(height), m_RenderWidth(width), m_RenderHeight(height),
+      m_StorageWidth(width), m_StorageHeight(height) {
 
         // glGenFramebuffers(1, &m_FBO);
         // means that the framebuffer object is created with GL framebuffer
@@ -26,7 +49,7 @@ Framebuffer::Framebuffer(unsigned int width, unsigned int height)
     // glBindTexture(GL_TEXTURE_2D, m_TextureID);
     // means that the texture object is bound to the GL texture
     glBindTexture(GL_TEXTURE_2D, m_TextureID);
-    // glTexImage2D is used to create a 2D texture
+    // glTexImage2D (or glTexStorage2D, see AllocateTextureStorage) is used to create a 2D texture
     // it takes the following parameters:
     // target, level, internalformat, width, height, border, format, type, data
     // target is the target texture
@@ -42,7 +65,8 @@ Framebuffer::Framebuffer(unsigned int width, unsigned int height)
     // GL_TEXTURE_2D means that the texture is a 2D texture
     // GL_RGB means that the texture is in RGB format
     // GL_UNSIGNED_BYTE means that the texture is in unsigned byte format
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, m_Width, m_Height, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+    // GL_RGB8 is the sized format immutable storage requires (GL_RGB with unsigned bytes)
+    AllocateTextureStorage(GL_RGB8, GL_RGB, GL_UNSIGNED_BYTE, m_StorageWidth, m_StorageHeight);
 
     // glTexParameteri is used to set the texture parameters
     // it takes the following parameters:
@@ -54,6 +78,10 @@ Framebuffer::Framebuffer(unsigned int width, unsigned int height)
     // GL_LINEAR means that the texture is linear
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    // GL_CLAMP_TO_EDGE: the default GL_REPEAT would blend texels from the far side of the
+    // storage into the edge at u/v = 0 when the viewport is sampled bilinearly
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
     // glFramebufferTexture2D is used to attach the texture to the framebuffer
     // it takes the following parameters:
@@ -70,6 +98,24 @@ Framebuffer::Framebuffer(unsigned int width, unsigned int height)
     // 0 means that the level of detail is 0
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_TextureID, 0);
 
+    // Optional object ID attachment for GPU picking
+    // GL_R32UI stores one unsigned integer per pixel; it must be read with GL_RED_INTEGER
+    // GL_NEAREST because IDs must never be filtered
+    // glDrawBuffers routes fragment output location 0 to the color texture and location 1 to the IDs
+    if (withObjectIds) {
+        glGenTextures(1, &m_ObjectIdTextureID);
+        glBindTexture(GL_TEXTURE_2D, m_ObjectIdTextureID);
+        AllocateTextureStorage(GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, m_StorageWidth, m_StorageHeight);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, m_ObjectIdTextureID, 0);
+
+        const GLenum drawBuffers[] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+        glDrawBuffers(2, drawBuffers);
+    }
+
     // what is done here is 
     // to create a renderbuffer object
     // it is used to store the depth and stencil information
@@ -80,7 +126,7 @@ Framebuffer::Framebuffer(unsigned int width, unsigned int height)
     // renderbuffers is the renderbuffer object
     glGenRenderbuffers(1, &m_RBO);
     glBindRenderbuffer(GL_RENDERBUFFER, m_RBO);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, m_Width, m_Height);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, m_StorageWidth, m_StorageHeight);
     glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_RBO);
 
     // This condition checks if the framebuffer is complete
@@ -90,10 +136,10 @@ Framebuffer::Framebuffer(unsigned int width, unsigned int height)
     // target is the target framebuffer
     // GL_FRAMEBUFFER means that the framebuffer is a GL framebuffer
     // GL_FRAMEBUFFER_COMPLETE means that the framebuffer is complete
-    // the std::cerr is used to print the error message
+    // the logger is used to print the error message
     // if the framebuffer is not complete  
     if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-        std::cerr << "Erro: Framebuffer incompleto!\n";
+        LOG_ERROR(Render, "Erro: Framebuffer incompleto!");
 
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
@@ -105,17 +151,41 @@ Framebuffer::Framebuffer(unsigned int width, unsigned int height)
 Framebuffer::~Framebuffer() {
     glDeleteFramebuffers(1, &m_FBO);
     glDeleteTextures(1, &m_TextureID);
+    if (m_ObjectIdTextureID) glDeleteTextures(1, &m_ObjectIdTextureID);
     glDeleteRenderbuffers(1, &m_RBO);
 }
 
 // Bind the framebuffer object
 // This function binds the framebuffer object
-// It sets the viewport size to the size of the framebuffer object
+// It sets the viewport size to the render size (the full size unless scaled down)
 // It takes no parameters
 // It returns nothing
 void Framebuffer::Bind() {
     glBindFramebuffer(GL_FRAMEBUFFER, m_FBO);
-    glViewport(0, 0, m_Width, m_Height);
+    glViewport(0, 0, m_RenderWidth, m_RenderHeight);
+}
+
+// Set the render size
+// Clamped to the framebuffer size; nothing is reallocated, so this is cheap to call every frame
+void Framebuffer::SetRenderSize(unsigned int width, unsigned int height) {
+    m_RenderWidth = width < 1 ? 1 : (width > m_Width ? m_Width : width);
+    m_RenderHeight = height < 1 ? 1 : (height > m_Height ? m_Height : height);
+}
+
+float Framebuffer::GetUVScaleX() const {
+    return static_cast<float>(m_RenderWidth) / static_cast<float>(m_StorageWidth);
+}
+
+float Framebuffer::GetUVScaleY() const {
+    return static_cast<float>(m_RenderHeight) / static_cast<float>(m_StorageHeight);
+}
+
+// Clear the object ID attachment
+// The framebuffer must be bound; ID 0 means "no object" under this pixel
+void Framebuffer::ClearObjectIds() {
+    if (!m_ObjectIdTextureID) return;
+    const GLuint noObject[4] = { 0, 0, 0, 0 };
+    glClearBufferuiv(GL_COLOR, 1, noObject);
 }
 
 // Unbind the framebuffer object
@@ -130,13 +200,48 @@ void Framebuffer::Unbind() {
 // width, height
 // width is the new width of the framebuffer object
 // height is the new height of the framebuffer object
+// The storage only grows: a size that fits the current storage just moves the render
+// rectangle, so shrinking or re-growing within it never touches the driver
 void Framebuffer::Resize(unsigned int width, unsigned int height) {
     m_Width = width;
     m_Height = height;
+    m_RenderWidth = width;
+    m_RenderHeight = height;
+    if (width <= m_StorageWidth && height <= m_StorageHeight) return;
+
+    if (width > m_StorageWidth) m_StorageWidth = GrowStorageExtent(m_StorageWidth, width);
+    if (height > m_StorageHeight) m_StorageHeight = GrowStorageExtent(m_StorageHeight, height);
+    LOG_DEBUG(Render, "Framebuffer storage grown to %ux%u", m_StorageWidth, m_StorageHeight);
+
+    // Immutable textures cannot be respecified: replace them and reattach
+    glBindFramebuffer(GL_FRAMEBUFFER, m_FBO);
 
+    glDeleteTextures(1, &m_TextureID);
+    glGenTextures(1, &m_TextureID);
     glBindTexture(GL_TEXTURE_2D, m_TextureID);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, m_Width, m_Height, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+    AllocateTextureStorage(GL_RGB8, GL_RGB, GL_UNSIGNED_BYTE, m_StorageWidth, m_StorageHeight);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_TextureID, 0);
+
+    if (m_ObjectIdTextureID) {
+        glDeleteTextures(1, &m_ObjectIdTextureID);
+        glGenTextures(1, &m_ObjectIdTextureID);
+        glBindTexture(GL_TEXTURE_2D, m_ObjectIdTextureID);
+        AllocateTextureStorage(GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, m_StorageWidth, m_StorageHeight);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, m_ObjectIdTextureID, 0);
+    }
 
     glBindRenderbuffer(GL_RENDERBUFFER, m_RBO);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, m_Width, m_Height);
-}
\ No newline at end of file
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, m_StorageWidth, m_StorageHeight);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        LOG_ERROR(Render, "Erro: Framebuffer incompleto!");
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
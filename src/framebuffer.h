@@ -8,20 +8,46 @@
 // framebuffer means that a frame is rendered to a texture
 // renderbuffer means that a buffer is used to store the depth and stencil information
 // texture means that a texture is used to store the color information
+//
+// withObjectIds adds a second color attachment (GL_R32UI) that the scene pass fills
+// with per-pixel object IDs (0 = nothing) for GPU picking.
 class Framebuffer {
 public:
-    Framebuffer(unsigned int width, unsigned int height);
+    Framebuffer(unsigned int width, unsigned int height, bool withObjectIds = false);
     ~Framebuffer();
 
     void Bind();
     void Unbind();
 
+    // Clears the object ID attachment to 0. glClear is undefined for integer
+    // attachments, so call this after the regular clear.
+    void ClearObjectIds();
+
+    unsigned int GetFBO() const { return m_FBO; }
     unsigned int GetTextureID() const { return m_TextureID; }
+    bool HasObjectIds() const { return m_ObjectIdTextureID != 0; }
+    unsigned int GetObjectIdTextureID() const { return m_ObjectIdTextureID; }
     unsigned int GetWidth() const { return m_Width; }
     unsigned int GetHeight() const { return m_Height; }
+    // Allocated texture size, at least GetWidth() x GetHeight() (storage only grows)
+    unsigned int GetStorageWidth() const { return m_StorageWidth; }
+    unsigned int GetStorageHeight() const { return m_StorageHeight; }
+
+    // Render size: the sub-rectangle (anchored at the origin) of the storage the scene is drawn into.
+    // Dynamic resolution shrinks it below the framebuffer size without reallocating;
+    // Bind() sets the viewport to it and readers sample only [0, GetUVScale*()].
+    void SetRenderSize(unsigned int width, unsigned int height);
+    unsigned int GetRenderWidth() const { return m_RenderWidth; }
+    unsigned int GetRenderHeight() const { return m_RenderHeight; }
+    // Texture coordinate of the far edge of the render rectangle (render / storage), so
+    // drawing it at the render size maps texels one to one
+    float GetUVScaleX() const;
+    float GetUVScaleY() const;
 
 // set the size of the framebuffer 
 // width and height are the new size 
+// the render size is reset to the full size
+// storage is reallocated (grown geometrically) only when the new size does not fit
 
     void Resize(unsigned int width, unsigned int height);
 
@@ -39,5 +65,8 @@ private:
     unsigned int m_FBO = 0;
     unsigned int m_TextureID = 0;
     unsigned int m_RBO = 0;
+    unsigned int m_ObjectIdTextureID = 0; // GL_R32UI, attachment 1 (0 if disabled)
     unsigned int m_Width, m_Height;
+    unsigned int m_RenderWidth, m_RenderHeight;
+    unsigned int m_StorageWidth, m_StorageHeight;
 };
\ No newline at end of file
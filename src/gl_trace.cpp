@@ -0,0 +1,430 @@
+#include "gl_trace.h"
+#include "log.h"
+#include "profiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <type_traits>
+
+bool GlTrace::s_Installed = false;
+bool GlTrace::s_Requested = false;
+bool GlTrace::s_Active = false;
+uint64_t GlTrace::s_Frames = 0;
+std::vector<GlTrace::DebugMessage> GlTrace::s_Messages;
+
+namespace {
+    const size_t kMaxDebugMessages = 256; // distinct ids kept
+
+    const char* g_CurrentCall = nullptr; // traced call in progress (debug message attribution)
+
+#if RAMPAGE_GL_TRACE
+    // Traced functions and their report category
+#define RAMPAGE_GL_TRACED_FUNCTIONS(X)                                                          \
+    X(DrawArrays, GlTrace::Draw) X(DrawElements, GlTrace::Draw)                                \
+    X(Clear, GlTrace::Draw) X(ClearBufferuiv, GlTrace::Draw)                                   \
+    X(BufferData, GlTrace::Upload) X(BufferSubData, GlTrace::Upload)                           \
+    X(MapBufferRange, GlTrace::Upload) X(UnmapBuffer, GlTrace::Upload)                         \
+    X(TexImage2D, GlTrace::Upload) X(TexSubImage2D, GlTrace::Upload)                           \
+    X(TexStorage2D, GlTrace::Upload) X(GenerateMipmap, GlTrace::Upload)                        \
+    X(UseProgram, GlTrace::State) X(BindVertexArray, GlTrace::State)                           \
+    X(ActiveTexture, GlTrace::State) X(BindTexture, GlTrace::State)                            \
+    X(BindBuffer, GlTrace::State) X(BindFramebuffer, GlTrace::State)                           \
+    X(Enable, GlTrace::State) X(Disable, GlTrace::State) X(Viewport, GlTrace::State)           \
+    X(DepthFunc, GlTrace::State) X(ColorMaski, GlTrace::State) X(ClearColor, GlTrace::State)   \
+    X(Uniform1i, GlTrace::State) X(Uniform1ui, GlTrace::State) X(Uniform1f, GlTrace::State)    \
+    X(Uniform3fv, GlTrace::State) X(UniformMatrix3fv, GlTrace::State)                          \
+    X(UniformMatrix4fv, GlTrace::State)                                                        \
+    X(GetUniformLocation, GlTrace::Query) X(GetIntegerv, GlTrace::Query)                       \
+    X(GetError, GlTrace::Query) X(GetShaderiv, GlTrace::Query) X(GetProgramiv, GlTrace::Query) \
+    X(GetQueryObjectiv, GlTrace::Query) X(GetQueryObjectui64v, GlTrace::Query)                 \
+    X(QueryCounter, GlTrace::Query) X(ReadPixels, GlTrace::Query)                              \
+    X(FenceSync, GlTrace::Query) X(ClientWaitSync, GlTrace::Query) X(Finish, GlTrace::Query)
+
+    enum TracedFunction {
+#define RAMPAGE_GL_ENUM(fn, category) kFn_##fn,
+        RAMPAGE_GL_TRACED_FUNCTIONS(RAMPAGE_GL_ENUM)
+#undef RAMPAGE_GL_ENUM
+        kFunctionCount
+    };
+
+    std::vector<GlTrace::FunctionStats> g_Functions(kFunctionCount);
+
+    // What the traced calls have set, to spot redundant ones. kUnknown entries are forgotten at
+    // each frame boundary because ImGui's renderer changes them through its own loader.
+    const GLuint kUnknown = ~0u;
+    const int kTextureUnits = 32;
+    enum TrackedCap { kCapDepthTest, kCapBlend, kCapCullFace, kCapScissorTest, kCapCount };
+
+    struct ShadowState {
+        GLuint program = kUnknown;
+        GLuint vertexArray = kUnknown;
+        GLuint activeUnit = kUnknown;
+        GLuint textures[kTextureUnits];
+        GLuint arrayBuffer = kUnknown;
+        GLuint pixelPackBuffer = 0; // not touched by ImGui: kept across frames
+        GLuint drawFramebuffer = kUnknown;
+        GLint viewport[4] = { -1, -1, -1, -1 };
+        GLenum depthFunc = kUnknown;
+        int caps[kCapCount] = { -1, -1, -1, -1 }; // -1 unknown, 0 disabled, 1 enabled
+
+        void ForgetFrameState() {
+            GLuint pack = pixelPackBuffer;
+            *this = ShadowState();
+            pixelPackBuffer = pack;
+        }
+        ShadowState() { std::fill(std::begin(textures), std::end(textures), kUnknown); }
+    };
+    ShadowState g_Shadow;
+
+    int GetTrackedCap(GLenum cap) {
+        switch (cap) {
+            case GL_DEPTH_TEST: return kCapDepthTest;
+            case GL_BLEND: return kCapBlend;
+            case GL_CULL_FACE: return kCapCullFace;
+            case GL_SCISSOR_TEST: return kCapScissorTest;
+            default: return -1;
+        }
+    }
+
+    // Counts a redundant call when the tracked value is already set, then stores it
+    template <typename T>
+    void SetTracked(GlTrace::FunctionStats& stats, T& tracked, T value) {
+        if (tracked == value) stats.redundant++;
+        tracked = value;
+    }
+
+    uint64_t GetPixelBytes(GLsizei width, GLsizei height, GLenum format, GLenum type) {
+        int components = 4;
+        switch (format) {
+            case GL_RED: case GL_RED_INTEGER: case GL_DEPTH_COMPONENT: components = 1; break;
+            case GL_RG: case GL_RG_INTEGER: components = 2; break;
+            case GL_RGB: case GL_BGR: case GL_RGB_INTEGER: components = 3; break;
+            default: break;
+        }
+        int componentBytes = 1;
+        switch (type) {
+            case GL_HALF_FLOAT: case GL_SHORT: case GL_UNSIGNED_SHORT: componentBytes = 2; break;
+            case GL_FLOAT: case GL_INT: case GL_UNSIGNED_INT: componentBytes = 4; break;
+            default: break;
+        }
+        return static_cast<uint64_t>(width) * height * components * componentBytes;
+    }
+
+    // Per-function inspection before the real call (bytes, redundancy, stalls); most have none
+    template <int Id>
+    struct Inspect {
+        template <typename... Args>
+        static void Before(GlTrace::FunctionStats&, Args...) {}
+    };
+
+    template <> struct Inspect<kFn_BufferData> {
+        static void Before(GlTrace::FunctionStats& stats, GLenum, GLsizeiptr size, const void* data, GLenum) {
+            if (data) stats.bytes += static_cast<uint64_t>(size);
+        }
+    };
+    template <> struct Inspect<kFn_BufferSubData> {
+        static void Before(GlTrace::FunctionStats& stats, GLenum, GLintptr, GLsizeiptr size, const void*) {
+            stats.bytes += static_cast<uint64_t>(size);
+        }
+    };
+    template <> struct Inspect<kFn_MapBufferRange> {
+        static void Before(GlTrace::FunctionStats& stats, GLenum, GLintptr, GLsizeiptr length, GLbitfield access) {
+            if (!(access & GL_MAP_WRITE_BIT)) return;
+            stats.bytes += static_cast<uint64_t>(length);
+            // A write map the driver has to synchronize with pending draws that use the buffer
+            if (!(access & (GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_BUFFER_BIT))) stats.stalls++;
+        }
+    };
+    template <> struct Inspect<kFn_TexImage2D> {
+        static void Before(GlTrace::FunctionStats& stats, GLenum, GLint, GLint, GLsizei width, GLsizei height, GLint,
+                           GLenum format, GLenum type, const void* pixels) {
+            if (pixels) stats.bytes += GetPixelBytes(width, height, format, type);
+        }
+    };
+    template <> struct Inspect<kFn_TexSubImage2D> {
+        static void Before(GlTrace::FunctionStats& stats, GLenum, GLint, GLint, GLint, GLsizei width, GLsizei height,
+                           GLenum format, GLenum type, const void*) {
+            stats.bytes += GetPixelBytes(width, height, format, type);
+        }
+    };
+    template <> struct Inspect<kFn_UseProgram> {
+        static void Before(GlTrace::FunctionStats& stats, GLuint program) { SetTracked(stats, g_Shadow.program, program); }
+    };
+    template <> struct Inspect<kFn_BindVertexArray> {
+        static void Before(GlTrace::FunctionStats& stats, GLuint vertexArray) { SetTracked(stats, g_Shadow.vertexArray, vertexArray); }
+    };
+    template <> struct Inspect<kFn_ActiveTexture> {
+        static void Before(GlTrace::FunctionStats& stats, GLenum unit) { SetTracked(stats, g_Shadow.activeUnit, static_cast<GLuint>(unit - GL_TEXTURE0)); }
+    };
+    template <> struct Inspect<kFn_BindTexture> {
+        static void Before(GlTrace::FunctionStats& stats, GLenum target, GLuint texture) {
+            if (target != GL_TEXTURE_2D || g_Shadow.activeUnit >= static_cast<GLuint>(kTextureUnits)) return;
+            SetTracked(stats, g_Shadow.textures[g_Shadow.activeUnit], texture);
+        }
+    };
+    template <> struct Inspect<kFn_BindBuffer> {
+        static void Before(GlTrace::FunctionStats& stats, GLenum target, GLuint buffer) {
+            if (target == GL_ARRAY_BUFFER) SetTracked(stats, g_Shadow.arrayBuffer, buffer);
+            else if (target == GL_PIXEL_PACK_BUFFER) SetTracked(stats, g_Shadow.pixelPackBuffer, buffer);
+        }
+    };
+    template <> struct Inspect<kFn_BindFramebuffer> {
+        static void Before(GlTrace::FunctionStats& stats, GLenum target, GLuint framebuffer) {
+            if (target == GL_FRAMEBUFFER || target == GL_DRAW_FRAMEBUFFER) SetTracked(stats, g_Shadow.drawFramebuffer, framebuffer);
+        }
+    };
+    template <> struct Inspect<kFn_Enable> {
+        static void Before(GlTrace::FunctionStats& stats, GLenum cap) {
+            int index = GetTrackedCap(cap);
+            if (index >= 0) SetTracked(stats, g_Shadow.caps[index], 1);
+        }
+    };
+    template <> struct Inspect<kFn_Disable> {
+        static void Before(GlTrace::FunctionStats& stats, GLenum cap) {
+            int index = GetTrackedCap(cap);
+            if (index >= 0) SetTracked(stats, g_Shadow.caps[index], 0);
+        }
+    };
+    template <> struct Inspect<kFn_Viewport> {
+        static void Before(GlTrace::FunctionStats& stats, GLint x, GLint y, GLsizei width, GLsizei height) {
+            GLint* viewport = g_Shadow.viewport;
+            if (viewport[0] == x && viewport[1] == y && viewport[2] == width && viewport[3] == height) stats.redundant++;
+            viewport[0] = x; viewport[1] = y; viewport[2] = width; viewport[3] = height;
+        }
+    };
+    template <> struct Inspect<kFn_DepthFunc> {
+        static void Before(GlTrace::FunctionStats& stats, GLenum func) { SetTracked(stats, g_Shadow.depthFunc, func); }
+    };
+    // Queries that round-trip to the driver (and on some drivers wait for the GPU)
+    struct AlwaysStalls {
+        template <typename... Args>
+        static void Before(GlTrace::FunctionStats& stats, Args...) { stats.stalls++; }
+    };
+    template <> struct Inspect<kFn_GetUniformLocation> : AlwaysStalls {};
+    template <> struct Inspect<kFn_GetIntegerv> : AlwaysStalls {};
+    template <> struct Inspect<kFn_GetError> : AlwaysStalls {};
+    template <> struct Inspect<kFn_GetShaderiv> : AlwaysStalls {};
+    template <> struct Inspect<kFn_GetProgramiv> : AlwaysStalls {};
+    template <> struct Inspect<kFn_Finish> : AlwaysStalls {};
+    template <> struct Inspect<kFn_ReadPixels> {
+        static void Before(GlTrace::FunctionStats& stats, GLint, GLint, GLsizei width, GLsizei height, GLenum format, GLenum type, void*) {
+            stats.bytes += GetPixelBytes(width, height, format, type);
+            if (g_Shadow.pixelPackBuffer == 0) stats.stalls++; // into client memory: waits for the GPU
+        }
+    };
+    template <> struct Inspect<kFn_ClientWaitSync> {
+        static void Before(GlTrace::FunctionStats& stats, GLsync, GLbitfield, GLuint64 timeout) {
+            if (timeout > 0) stats.stalls++;
+        }
+    };
+
+    // Replacement for one glad pointer: counts, inspects, times and forwards to the real function
+    template <int Id, typename Fn>
+    struct Shim;
+
+    template <int Id, typename R, typename... Args>
+    struct Shim<Id, R(APIENTRY*)(Args...)> {
+        static inline R(APIENTRY* real)(Args...) = nullptr;
+
+        static R APIENTRY Call(Args... args) {
+            GlTrace::FunctionStats& stats = g_Functions[Id];
+            stats.frameCalls++;
+            Inspect<Id>::Before(stats, args...);
+
+            const char* outerCall = g_CurrentCall;
+            g_CurrentCall = stats.name;
+            uint64_t start = Profiler::Now();
+            if constexpr (std::is_void<R>::value) {
+                real(args...);
+                stats.ticks += Profiler::Now() - start;
+                g_CurrentCall = outerCall;
+            } else {
+                R result = real(args...);
+                stats.ticks += Profiler::Now() - start;
+                g_CurrentCall = outerCall;
+                return result;
+            }
+        }
+    };
+#endif
+}
+
+void GlTrace::Install() {
+    if (s_Installed) return;
+    s_Installed = true;
+
+#if RAMPAGE_GL_TRACE
+#define RAMPAGE_GL_REMEMBER(fn, category)                                                           \
+    g_Functions[kFn_##fn].name = "gl" #fn;                                                          \
+    g_Functions[kFn_##fn].flags = category;                                                         \
+    Shim<kFn_##fn, decltype(glad_gl##fn)>::real = glad_gl##fn;
+    RAMPAGE_GL_TRACED_FUNCTIONS(RAMPAGE_GL_REMEMBER)
+#undef RAMPAGE_GL_REMEMBER
+#endif
+
+    if (!glDebugMessageCallback) {
+        LOG_INFO(Render, "KHR_debug indisponivel: mensagens do driver nao serao coletadas");
+    }
+}
+
+void GlTrace::Swap(bool traced) {
+    // KHR_debug (core in 4.3) only while tracing: synchronous output ties each message to the
+    // call that raised it, but serializes the driver, so a normal run must not pay for it.
+    // Turned on before the shims go in and off after they are gone, so it never shows up in the counts.
+    if (traced && glDebugMessageCallback) {
+        glEnable(GL_DEBUG_OUTPUT);
+        glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+        glDebugMessageControl(GL_DONT_CARE, GL_DEBUG_TYPE_PERFORMANCE, GL_DONT_CARE, 0, nullptr, GL_TRUE);
+        glDebugMessageCallback(&GlTrace::OnDebugMessage, nullptr);
+    }
+
+#if RAMPAGE_GL_TRACE
+    if (traced) {
+        // Start from the real bindings where they outlive a frame (queried before the shims go in)
+        GLint pixelPackBuffer = 0;
+        glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &pixelPackBuffer);
+        g_Shadow = ShadowState();
+        g_Shadow.pixelPackBuffer = static_cast<GLuint>(pixelPackBuffer);
+    }
+
+#define RAMPAGE_GL_SWAP(fn, category)                                                               \
+    if (Shim<kFn_##fn, decltype(glad_gl##fn)>::real)                                                \
+        glad_gl##fn = traced ? &Shim<kFn_##fn, decltype(glad_gl##fn)>::Call                         \
+                               : Shim<kFn_##fn, decltype(glad_gl##fn)>::real;
+    RAMPAGE_GL_TRACED_FUNCTIONS(RAMPAGE_GL_SWAP)
+#undef RAMPAGE_GL_SWAP
+#endif
+
+    if (!traced && glDebugMessageCallback) {
+        glDebugMessageCallback(nullptr, nullptr);
+        glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+        glDisable(GL_DEBUG_OUTPUT);
+    }
+}
+
+void GlTrace::NewFrame() {
+#if RAMPAGE_GL_TRACE
+    if (s_Active) {
+        for (FunctionStats& stats : g_Functions) {
+            stats.calls += stats.frameCalls;
+            stats.lastFrameCalls = stats.frameCalls;
+            stats.frameCalls = 0;
+        }
+        s_Frames++;
+        g_Shadow.ForgetFrameState();
+    }
+#endif
+    if (s_Installed && s_Requested != s_Active) {
+        Swap(s_Requested);
+        s_Active = s_Requested;
+        LOG_INFO(Render, "Instrumentacao de chamadas GL %s", s_Active ? "ativada" : "desativada");
+    }
+}
+
+void GlTrace::Reset() {
+#if RAMPAGE_GL_TRACE
+    for (FunctionStats& stats : g_Functions) {
+        const char* name = stats.name;
+        uint8_t flags = stats.flags;
+        stats = FunctionStats();
+        stats.name = name;
+        stats.flags = flags;
+    }
+#endif
+    s_Frames = 0;
+    s_Messages.clear();
+}
+
+const std::vector<GlTrace::FunctionStats>& GlTrace::GetFunctions() {
+#if RAMPAGE_GL_TRACE
+    return g_Functions;
+#else
+    static const std::vector<FunctionStats> none;
+    return none;
+#endif
+}
+
+const char* GlTrace::GetDebugTypeName(GLenum type) {
+    switch (type) {
+        case GL_DEBUG_TYPE_ERROR: return "Erro";
+        case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: return "Obsoleto";
+        case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR: return "Indefinido";
+        case GL_DEBUG_TYPE_PORTABILITY: return "Portabilidade";
+        case GL_DEBUG_TYPE_PERFORMANCE: return "Desempenho";
+        default: return "Outro";
+    }
+}
+
+void APIENTRY GlTrace::OnDebugMessage(GLenum source, GLenum type, GLuint id, GLenum severity,
+                                      GLsizei length, const GLchar* message, const void*) {
+    for (DebugMessage& existing : s_Messages) {
+        if (existing.id == id && existing.source == source && existing.type == type) {
+            existing.count++;
+            return;
+        }
+    }
+    if (s_Messages.size() >= kMaxDebugMessages) return;
+
+    DebugMessage entry;
+    entry.source = source;
+    entry.type = type;
+    entry.severity = severity;
+    entry.id = id;
+    entry.count = 1;
+    entry.text = length >= 0 ? std::string(message, static_cast<size_t>(length)) : std::string(message);
+    entry.during = g_CurrentCall;
+    s_Messages.push_back(entry);
+
+    // First occurrence only: repeated messages are counted in the report
+    if (type == GL_DEBUG_TYPE_ERROR || severity == GL_DEBUG_SEVERITY_HIGH)
+        LOG_WARN(Render, "GL [%s] %s", GetDebugTypeName(type), entry.text);
+    else
+        LOG_DEBUG(Render, "GL [%s] %s", GetDebugTypeName(type), entry.text);
+}
+
+bool GlTrace::WriteReport(const std::string& path) {
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) return false;
+
+    const std::vector<FunctionStats>& functions = GetFunctions();
+    double frames = static_cast<double>(std::max<uint64_t>(s_Frames, 1));
+    std::fprintf(file, "Relatorio de chamadas GL: %llu quadros\n", (unsigned long long)s_Frames);
+
+    std::vector<const FunctionStats*> sorted;
+    for (const FunctionStats& stats : functions)
+        if (stats.calls > 0) sorted.push_back(&stats);
+
+    std::sort(sorted.begin(), sorted.end(), [](const FunctionStats* a, const FunctionStats* b) { return a->ticks > b->ticks; });
+    std::fprintf(file, "\n== Chamadas mais caras (tempo de CPU dentro do driver) ==\n");
+    std::fprintf(file, "%-24s %10s %12s %10s %10s %14s\n", "funcao", "chamadas", "por quadro", "total ms", "us/chamada", "bytes");
+    for (const FunctionStats* stats : sorted) {
+        double totalMs = Profiler::TicksToMs(stats->ticks);
+        std::fprintf(file, "%-24s %10llu %12.1f %10.3f %10.3f %14llu\n", stats->name, (unsigned long long)stats->calls,
+                     stats->calls / frames, totalMs, totalMs * 1000.0 / stats->calls, (unsigned long long)stats->bytes);
+    }
+
+    std::sort(sorted.begin(), sorted.end(), [](const FunctionStats* a, const FunctionStats* b) { return a->redundant > b->redundant; });
+    std::fprintf(file, "\n== Chamadas redundantes (mesmo estado ja definido no quadro) ==\n");
+    for (const FunctionStats* stats : sorted) {
+        if (stats->redundant == 0) break;
+        std::fprintf(file, "%-24s %10llu de %llu (%.0f%%), %.1f por quadro\n", stats->name, (unsigned long long)stats->redundant,
+                     (unsigned long long)stats->calls, 100.0 * stats->redundant / stats->calls, stats->redundant / frames);
+    }
+
+    std::sort(sorted.begin(), sorted.end(), [](const FunctionStats* a, const FunctionStats* b) { return a->stalls > b->stalls; });
+    std::fprintf(file, "\n== Possiveis sincronizacoes com o driver/GPU ==\n");
+    for (const FunctionStats* stats : sorted) {
+        if (stats->stalls == 0) break;
+        std::fprintf(file, "%-24s %10llu chamadas, %.1f por quadro, %.3f ms no total\n", stats->name, (unsigned long long)stats->stalls,
+                     stats->stalls / frames, Profiler::TicksToMs(stats->ticks));
+    }
+
+    std::fprintf(file, "\n== Mensagens KHR_debug ==\n");
+    for (const DebugMessage& message : s_Messages) {
+        std::fprintf(file, "[%s] id %u x%llu%s%s: %s\n", GetDebugTypeName(message.type), message.id, (unsigned long long)message.count,
+                     message.during ? " em " : "", message.during ? message.during : "", message.text.c_str());
+    }
+
+    bool ok = std::ferror(file) == 0;
+    std::fclose(file);
+    return ok;
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <glad/glad.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// GL call accounting.
+//
+// Install() (after gladLoadGLLoader) remembers the real glad function pointers. While
+// tracing is enabled, the pointers of the functions listed in gl_trace.cpp are swapped
+// for shims that count calls, time them (profiler ticks), add up bytes uploaded and flag:
+//   - redundant calls: binds and enables that set what is already set this frame;
+//   - stall suspects: calls that may wait on the GPU or the driver (glReadPixels without a
+//     pack buffer, glGet*, glGetUniformLocation, glFinish, synchronizing maps, ...).
+// KHR_debug messages are aggregated by id, together with the traced call they came from.
+//
+// Enabling and disabling take effect at the next NewFrame(); disabled, the real pointers are
+// back in place and debug output (synchronous while tracing) is turned off, so nothing is
+// paid. Building with RAMPAGE_GL_TRACE=0 leaves only the KHR_debug collection, under the
+// same switch. Everything here runs on the GL thread.
+
+#ifndef RAMPAGE_GL_TRACE
+#define RAMPAGE_GL_TRACE 1
+#endif
+
+class GlTrace {
+public:
+    enum Flags : uint8_t { Draw = 1, Upload = 2, State = 4, Query = 8 };
+
+    struct FunctionStats {
+        const char* name = nullptr;
+        uint8_t flags = 0;
+        uint64_t calls = 0;     // since the last Reset()
+        uint64_t ticks = 0;
+        uint64_t bytes = 0;
+        uint64_t redundant = 0;
+        uint64_t stalls = 0;
+        uint32_t frameCalls = 0; // current frame
+        uint32_t lastFrameCalls = 0;
+    };
+
+    struct DebugMessage {
+        GLenum source = 0, type = 0, severity = 0;
+        GLuint id = 0;
+        uint64_t count = 0;
+        std::string text;            // first occurrence
+        const char* during = nullptr; // traced call in progress, if any
+    };
+
+    static void Install();
+    static void SetEnabled(bool enabled) { s_Requested = enabled; }
+    static bool IsEnabled() { return s_Active; }
+    // Frame boundary: closes the frame's per-function counts and applies SetEnabled()
+    static void NewFrame();
+    static void Reset();
+
+    static const std::vector<FunctionStats>& GetFunctions();
+    static const std::vector<DebugMessage>& GetDebugMessages() { return s_Messages; }
+    static uint64_t GetFrameCount() { return s_Frames; }
+    static const char* GetDebugTypeName(GLenum type);
+    // Text report: most expensive calls, redundant calls, stall suspects and debug messages
+    static bool WriteReport(const std::string& path);
+
+private:
+    static void APIENTRY OnDebugMessage(GLenum source, GLenum type, GLuint id, GLenum severity,
+                                        GLsizei length, const GLchar* message, const void* user);
+    static void Swap(bool traced);
+
+    static bool s_Installed;
+    static bool s_Requested;
+    static bool s_Active;
+    static uint64_t s_Frames;
+    static std::vector<DebugMessage> s_Messages;
+};
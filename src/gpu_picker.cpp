@@ -0,0 +1,131 @@
+#include "gpu_picker.h"
+#include "framebuffer.h"
+#include <algorithm>
+
+namespace {
+    const int kRegionPixels = GpuPicker::kRegionSize * GpuPicker::kRegionSize;
+}
+
+GpuPicker::GpuPicker() {
+}
+
+GpuPicker::~GpuPicker() {
+    Release();
+}
+
+void GpuPicker::Release() {
+    if (!m_Created) return;
+    for (Slot& slot : m_Slots) {
+        if (slot.fence) glDeleteSync(slot.fence);
+        glDeleteBuffers(1, &slot.pbo);
+        slot = Slot();
+    }
+    m_Created = false;
+}
+
+// Buffers are created on first use so the picker can be constructed before a context exists
+void GpuPicker::CreateBuffers() {
+    for (Slot& slot : m_Slots) {
+        glGenBuffers(1, &slot.pbo);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+        glBufferData(GL_PIXEL_PACK_BUFFER, kRegionPixels * sizeof(GLuint), nullptr, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    m_Created = true;
+}
+
+bool GpuPicker::Request(const Framebuffer& framebuffer, int x, int y, uint32_t tag) {
+    if (!framebuffer.HasObjectIds()) return false;
+    if (!m_Created) CreateBuffers();
+
+    Slot* slot = nullptr;
+    for (Slot& candidate : m_Slots) {
+        if (!candidate.pending) { slot = &candidate; break; }
+    }
+    if (!slot) return false;
+
+    // Clamp the square to the render rectangle; the cursor's position inside it is kept for resolving
+    int width = static_cast<int>(framebuffer.GetRenderWidth());
+    int height = static_cast<int>(framebuffer.GetRenderHeight());
+    if (width < kRegionSize || height < kRegionSize) return false;
+    if (x < 0 || y < 0 || x >= width || y >= height) return false;
+    int half = kRegionSize / 2;
+    int left = std::min(std::max(x - half, 0), width - kRegionSize);
+    int bottom = std::min(std::max(y - half, 0), height - kRegionSize);
+
+    GLint previousRead = 0;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousRead);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer.GetFBO());
+    glReadBuffer(GL_COLOR_ATTACHMENT1);
+
+    // With a PACK buffer bound, glReadPixels only queues a copy into it and returns
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot->pbo);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(left, bottom, kRegionSize, kRegionSize, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, previousRead);
+
+    slot->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot->tag = tag;
+    slot->cursor = (y - bottom) * kRegionSize + (x - left);
+    slot->sequence = m_NextSequence++;
+    slot->pending = true;
+    return true;
+}
+
+bool GpuPicker::HasPending() const {
+    for (const Slot& slot : m_Slots) {
+        if (slot.pending) return true;
+    }
+    return false;
+}
+
+bool GpuPicker::Poll(Result& result, bool wait) {
+    // Oldest pending slot first, so results come back in request order
+    Slot* oldest = nullptr;
+    for (Slot& slot : m_Slots) {
+        if (slot.pending && (!oldest || slot.sequence < oldest->sequence)) oldest = &slot;
+    }
+    if (!oldest) return false;
+
+    // Zero timeout: only asks whether the copy has finished
+    GLenum status = wait ? glClientWaitSync(oldest->fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull)
+                         : glClientWaitSync(oldest->fence, 0, 0);
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) return false;
+
+    glDeleteSync(oldest->fence);
+    oldest->fence = nullptr;
+    oldest->pending = false;
+
+    GLuint ids[kRegionPixels] = {};
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, oldest->pbo);
+    if (const void* mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, sizeof(ids), GL_MAP_READ_BIT)) {
+        std::copy(static_cast<const GLuint*>(mapped), static_cast<const GLuint*>(mapped) + kRegionPixels, ids);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    // Exact pixel if it hit something, otherwise the closest hit in the square
+    // (makes thin or distant objects easier to click)
+    int center = oldest->cursor;
+    int cx = center % kRegionSize, cy = center / kRegionSize;
+    uint32_t id = ids[center];
+    int bestDistance = kRegionPixels * 2;
+    if (id == 0) {
+        for (int i = 0; i < kRegionPixels; ++i) {
+            if (ids[i] == 0) continue;
+            int dx = i % kRegionSize - cx, dy = i / kRegionSize - cy;
+            int distance = dx * dx + dy * dy;
+            if (distance < bestDistance) {
+                bestDistance = distance;
+                id = ids[i];
+            }
+        }
+    }
+
+    result.tag = oldest->tag;
+    result.id = id;
+    return true;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <glad/glad.h>
+#include <cstdint>
+
+class Framebuffer;
+
+// GpuPicker reads object IDs back from a Framebuffer's ID attachment without stalling.
+// Request() copies a small square around the cursor into a pixel buffer object and
+// drops a fence behind it; Poll() maps only the buffers whose fence has signaled, so
+// a result typically arrives one frame after the request.
+//
+// Each request carries a caller-defined tag (e.g. click vs hover) that is handed back
+// with the result.
+class GpuPicker {
+public:
+    static const int kRegionSize = 5; // pixels per side of the square read around the cursor
+
+    struct Result {
+        uint32_t tag = 0;
+        uint32_t id = 0; // 0 = no object under the cursor
+    };
+
+    GpuPicker();
+    ~GpuPicker();
+
+    GpuPicker(const GpuPicker&) = delete;
+    GpuPicker& operator=(const GpuPicker&) = delete;
+
+    // Deletes the buffers and fences (pending requests are dropped); needs the context current.
+    // The picker recreates them on the next Request().
+    void Release();
+
+    // x, y in framebuffer pixels with the origin at the bottom-left.
+    // Returns false if every slot is still in flight (the GPU is several frames behind).
+    bool Request(const Framebuffer& framebuffer, int x, int y, uint32_t tag);
+
+    // Returns one finished request per call, oldest first; false when none is ready.
+    // wait blocks on the oldest request instead, so results always arrive the frame after
+    // the request (input replay relies on that to select the same objects).
+    bool Poll(Result& result, bool wait = false);
+
+    bool HasPending() const;
+
+private:
+    static const int kSlotCount = 4;
+
+    struct Slot {
+        GLuint pbo = 0;
+        GLsync fence = nullptr;
+        uint32_t tag = 0;
+        int cursor = 0; // index of the cursor pixel inside the read square
+        uint64_t sequence = 0;
+        bool pending = false;
+    };
+
+    void CreateBuffers();
+
+    Slot m_Slots[kSlotCount];
+    uint64_t m_NextSequence = 0;
+    bool m_Created = false;
+};
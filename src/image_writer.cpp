@@ -0,0 +1,154 @@
+#include "image_writer.h"
+#include <cstdint>
+#include <cstring>
+
+namespace {
+    void PutBigEndian32(std::vector<unsigned char>& out, uint32_t value) {
+        out.push_back(static_cast<unsigned char>(value >> 24));
+        out.push_back(static_cast<unsigned char>(value >> 16));
+        out.push_back(static_cast<unsigned char>(value >> 8));
+        out.push_back(static_cast<unsigned char>(value));
+    }
+
+    bool WriteFile(const std::string& path, const std::vector<unsigned char>& bytes) {
+        FILE* file = std::fopen(path.c_str(), "wb");
+        if (!file) return false;
+        bool ok = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+        return std::fclose(file) == 0 && ok;
+    }
+
+    unsigned char ClampByte(int value) {
+        return static_cast<unsigned char>(value < 0 ? 0 : (value > 255 ? 255 : value));
+    }
+}
+
+// QOI ("Quite OK Image"), see qoiformat.org: each pixel becomes a run, an index into a
+// 64-entry cache of recent colors, a small delta from the previous pixel, or a literal.
+bool WriteQoi(const std::string& path, const unsigned char* pixels, int width, int height,
+              int channels, bool flipVertically) {
+    if (!pixels || width <= 0 || height <= 0 || (channels != 3 && channels != 4)) return false;
+
+    enum : unsigned char { OpIndex = 0x00, OpDiff = 0x40, OpLuma = 0x80, OpRun = 0xc0, OpRgb = 0xfe, OpRgba = 0xff };
+    struct Rgba { unsigned char r, g, b, a; };
+
+    std::vector<unsigned char> out;
+    out.reserve(14 + static_cast<size_t>(width) * height * (channels + 1) / 2 + 8);
+    out.insert(out.end(), { 'q', 'o', 'i', 'f' });
+    PutBigEndian32(out, static_cast<uint32_t>(width));
+    PutBigEndian32(out, static_cast<uint32_t>(height));
+    out.push_back(static_cast<unsigned char>(channels));
+    out.push_back(0); // sRGB with linear alpha
+
+    Rgba cache[64] = {};
+    Rgba previous = { 0, 0, 0, 255 };
+    int run = 0;
+    size_t rowBytes = static_cast<size_t>(width) * channels;
+
+    for (int y = 0; y < height; ++y) {
+        const unsigned char* row = pixels + rowBytes * (flipVertically ? height - 1 - y : y);
+        for (int x = 0; x < width; ++x) {
+            const unsigned char* p = row + static_cast<size_t>(x) * channels;
+            Rgba pixel = { p[0], p[1], p[2], channels == 4 ? p[3] : static_cast<unsigned char>(255) };
+
+            if (std::memcmp(&pixel, &previous, sizeof(Rgba)) == 0) {
+                if (++run == 62) {
+                    out.push_back(static_cast<unsigned char>(OpRun | (run - 1)));
+                    run = 0;
+                }
+                continue;
+            }
+            if (run > 0) {
+                out.push_back(static_cast<unsigned char>(OpRun | (run - 1)));
+                run = 0;
+            }
+
+            int hash = (pixel.r * 3 + pixel.g * 5 + pixel.b * 7 + pixel.a * 11) % 64;
+            if (std::memcmp(&cache[hash], &pixel, sizeof(Rgba)) == 0) {
+                out.push_back(static_cast<unsigned char>(OpIndex | hash));
+            } else {
+                cache[hash] = pixel;
+                if (pixel.a == previous.a) {
+                    // Channel differences wrap around as 8-bit values
+                    int dr = static_cast<signed char>(pixel.r - previous.r);
+                    int dg = static_cast<signed char>(pixel.g - previous.g);
+                    int db = static_cast<signed char>(pixel.b - previous.b);
+                    int drg = dr - dg, dbg = db - dg;
+                    if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+                        out.push_back(static_cast<unsigned char>(OpDiff | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2)));
+                    } else if (dg >= -32 && dg <= 31 && drg >= -8 && drg <= 7 && dbg >= -8 && dbg <= 7) {
+                        out.push_back(static_cast<unsigned char>(OpLuma | (dg + 32)));
+                        out.push_back(static_cast<unsigned char>((drg + 8) << 4 | (dbg + 8)));
+                    } else {
+                        out.insert(out.end(), { OpRgb, pixel.r, pixel.g, pixel.b });
+                    }
+                } else {
+                    out.insert(out.end(), { OpRgba, pixel.r, pixel.g, pixel.b, pixel.a });
+                }
+            }
+            previous = pixel;
+        }
+    }
+    if (run > 0) out.push_back(static_cast<unsigned char>(OpRun | (run - 1)));
+    out.insert(out.end(), { 0, 0, 0, 0, 0, 0, 0, 1 }); // end marker
+
+    return WriteFile(path, out);
+}
+
+bool Y4MWriter::Open(const std::string& path, int width, int height, int framesPerSecond) {
+    Close();
+    if (width <= 0 || height <= 0 || framesPerSecond <= 0) return false;
+    m_File = std::fopen(path.c_str(), "wb");
+    if (!m_File) return false;
+
+    m_Width = width;
+    m_Height = height;
+    int chromaWidth = (width + 1) / 2, chromaHeight = (height + 1) / 2;
+    m_Planes.resize(static_cast<size_t>(width) * height + 2 * static_cast<size_t>(chromaWidth) * chromaHeight);
+    std::fprintf(m_File, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg XYSCSS=420JPEG\n", width, height, framesPerSecond);
+    return true;
+}
+
+// Full-range BT.601 in 8.8 fixed point; chroma is the average of each 2x2 block
+bool Y4MWriter::WriteFrame(const unsigned char* rgba, bool flipVertically) {
+    if (!m_File || !rgba) return false;
+
+    int chromaWidth = (m_Width + 1) / 2, chromaHeight = (m_Height + 1) / 2;
+    unsigned char* planeY = m_Planes.data();
+    unsigned char* planeU = planeY + static_cast<size_t>(m_Width) * m_Height;
+    unsigned char* planeV = planeU + static_cast<size_t>(chromaWidth) * chromaHeight;
+    size_t rowBytes = static_cast<size_t>(m_Width) * 4;
+    auto sourceRow = [&](int y) { return rgba + rowBytes * (flipVertically ? m_Height - 1 - y : y); };
+
+    for (int y = 0; y < m_Height; ++y) {
+        const unsigned char* row = sourceRow(y);
+        unsigned char* outY = planeY + static_cast<size_t>(y) * m_Width;
+        for (int x = 0; x < m_Width; ++x) {
+            const unsigned char* p = row + x * 4;
+            outY[x] = static_cast<unsigned char>((77 * p[0] + 150 * p[1] + 29 * p[2] + 128) >> 8);
+        }
+    }
+    for (int cy = 0; cy < chromaHeight; ++cy) {
+        const unsigned char* row0 = sourceRow(cy * 2);
+        const unsigned char* row1 = sourceRow(cy * 2 + 1 < m_Height ? cy * 2 + 1 : cy * 2);
+        for (int cx = 0; cx < chromaWidth; ++cx) {
+            int x0 = cx * 2 * 4, x1 = (cx * 2 + 1 < m_Width ? cx * 2 + 1 : cx * 2) * 4;
+            int r = row0[x0] + row0[x1] + row1[x0] + row1[x1];
+            int g = row0[x0 + 1] + row0[x1 + 1] + row1[x0 + 1] + row1[x1 + 1];
+            int b = row0[x0 + 2] + row0[x1 + 2] + row1[x0 + 2] + row1[x1 + 2];
+            // Sums of 4 samples: divide by 4 * 256
+            planeU[static_cast<size_t>(cy) * chromaWidth + cx] = ClampByte(((-43 * r - 85 * g + 128 * b + 512) >> 10) + 128);
+            planeV[static_cast<size_t>(cy) * chromaWidth + cx] = ClampByte(((128 * r - 107 * g - 21 * b + 512) >> 10) + 128);
+        }
+    }
+
+    static const char kFrameHeader[] = "FRAME\n";
+    bool ok = std::fwrite(kFrameHeader, 1, sizeof(kFrameHeader) - 1, m_File) == sizeof(kFrameHeader) - 1;
+    ok = ok && std::fwrite(m_Planes.data(), 1, m_Planes.size(), m_File) == m_Planes.size();
+    return ok;
+}
+
+void Y4MWriter::Close() {
+    if (!m_File) return;
+    std::fclose(m_File);
+    m_File = nullptr;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Image and video file writers used for captures and debugging dumps.
+// No external dependencies: QOI for stills (lossless, fast to encode, readable by
+// common image tools) and uncompressed YUV4MPEG2 for sequences (ffmpeg/mpv read it).
+//
+// Pixels are tightly packed 8-bit RGB or RGBA rows. flipVertically writes the rows
+// bottom-up, which is the order glReadPixels returns them in.
+
+bool WriteQoi(const std::string& path, const unsigned char* pixels, int width, int height,
+              int channels, bool flipVertically = false);
+
+// Writes RGBA frames as 4:2:0 (JPEG range, BT.601) Y4M. Every frame must have the size
+// given to Open().
+class Y4MWriter {
+public:
+    ~Y4MWriter() { Close(); }
+
+    bool Open(const std::string& path, int width, int height, int framesPerSecond);
+    bool WriteFrame(const unsigned char* rgba, bool flipVertically = false);
+    void Close();
+
+    bool IsOpen() const { return m_File != nullptr; }
+    int GetWidth() const { return m_Width; }
+    int GetHeight() const { return m_Height; }
+
+private:
+    FILE* m_File = nullptr;
+    int m_Width = 0;
+    int m_Height = 0;
+    std::vector<unsigned char> m_Planes; // Y, then U and V at half resolution (rounded up)
+};
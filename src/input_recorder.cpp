@@ -0,0 +1,391 @@
+#include "input_recorder.h"
+#include "log.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+
+namespace {
+    const char kMagic[4] = { 'R', 'I', 'N', 'P' };
+    const uint64_t kVersion = 1;
+    const uint32_t kFirstFrameMicros = 16667; // ImGui's own first-frame delta
+
+    InputRecorder* s_Recorder = nullptr; // one window, one recorder
+
+    void WriteVarint(std::vector<uint8_t>& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    bool ReadVarint(const std::vector<uint8_t>& in, size_t& offset, uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64 && offset < in.size(); shift += 7) {
+            uint8_t byte = in[offset++];
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+
+    // Signed values as small unsigned ones (0, -1, 1, -2, ... -> 0, 1, 2, 3, ...)
+    uint64_t ZigZag(int64_t value) { return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63); }
+    int64_t UnZigZag(uint64_t value) { return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1); }
+
+    int32_t Quantize(double value, double scale) { return static_cast<int32_t>(std::lround(value * scale)); }
+
+    void WriteString(std::vector<uint8_t>& out, const std::string& text) {
+        WriteVarint(out, text.size());
+        out.insert(out.end(), text.begin(), text.end());
+    }
+
+    bool ReadString(const std::vector<uint8_t>& in, size_t& offset, std::string& text) {
+        uint64_t length;
+        if (!ReadVarint(in, offset, length) || length > in.size() - offset) return false;
+        text.assign(reinterpret_cast<const char*>(in.data() + offset), static_cast<size_t>(length));
+        offset += static_cast<size_t>(length);
+        return true;
+    }
+}
+
+void InputRecorder::Install(GLFWwindow* window) {
+    m_Window = window;
+    s_Recorder = this;
+    m_PrevCursorPos = glfwSetCursorPosCallback(window, OnCursorPos);
+    m_PrevMouseButton = glfwSetMouseButtonCallback(window, OnMouseButton);
+    m_PrevScroll = glfwSetScrollCallback(window, OnScroll);
+    m_PrevKey = glfwSetKeyCallback(window, OnKey);
+    m_PrevChar = glfwSetCharCallback(window, OnChar);
+    m_PrevFocus = glfwSetWindowFocusCallback(window, OnFocus);
+    m_PrevCursorEnter = glfwSetCursorEnterCallback(window, OnCursorEnter);
+}
+
+bool InputRecorder::StartRecording(const std::string& path, const std::string& layout, const std::string& note) {
+    Stop();
+    m_File.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_File) {
+        LOG_ERROR(General, "Falha ao criar o log de entrada %s", path);
+        return false;
+    }
+    glfwGetWindowSize(m_Window, &m_WindowWidth, &m_WindowHeight);
+
+    std::vector<uint8_t> header(std::begin(kMagic), std::end(kMagic));
+    WriteVarint(header, kVersion);
+    WriteVarint(header, static_cast<uint64_t>(m_WindowWidth));
+    WriteVarint(header, static_cast<uint64_t>(m_WindowHeight));
+    WriteString(header, layout);
+    WriteString(header, note);
+    m_File.write(reinterpret_cast<const char*>(header.data()), header.size());
+
+    m_Mode = Mode::Recording;
+    m_Layout = layout;
+    m_Note = note;
+    m_Bytes = header.size();
+    m_Frame = 0;
+    m_DeltaMicros = 0;
+    m_TimeMicros = 0;
+    m_CursorX = m_CursorY = 0;
+    m_FrameEvents.clear();
+    m_FrameEventCount = 0;
+    LOG_INFO(General, "Gravando entrada em %s", path);
+    return true;
+}
+
+bool InputRecorder::StartReplay(const std::string& path) {
+    Stop();
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        LOG_ERROR(General, "Falha ao abrir o log de entrada %s", path);
+        return false;
+    }
+    m_Buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+    size_t offset = sizeof(kMagic);
+    uint64_t version = 0, width = 0, height = 0;
+    if (m_Buffer.size() < sizeof(kMagic) || std::memcmp(m_Buffer.data(), kMagic, sizeof(kMagic)) != 0 ||
+        !ReadVarint(m_Buffer, offset, version) || version != kVersion ||
+        !ReadVarint(m_Buffer, offset, width) || !ReadVarint(m_Buffer, offset, height) ||
+        !ReadString(m_Buffer, offset, m_Layout) || !ReadString(m_Buffer, offset, m_Note)) {
+        LOG_ERROR(General, "Log de entrada invalido: %s", path);
+        m_Buffer.clear();
+        return false;
+    }
+
+    // A dry pass over the frames: counts them and rejects a truncated log before anything runs
+    m_ReadOffset = offset;
+    m_Frame = 0;
+    m_CursorX = m_CursorY = 0;
+    while (m_ReadOffset < m_Buffer.size()) {
+        if (!ReadFrame(false)) {
+            LOG_ERROR(General, "Log de entrada truncado no quadro %llu: %s", (unsigned long long)m_Frame, path);
+            m_Buffer.clear();
+            return false;
+        }
+    }
+    m_FrameCount = m_Frame;
+
+    m_Mode = Mode::Replaying;
+    m_ReadOffset = offset;
+    m_Bytes = m_Buffer.size();
+    m_Frame = 0;
+    m_DeltaMicros = 0;
+    m_TimeMicros = 0;
+    m_CursorX = m_CursorY = 0;
+    m_WindowWidth = static_cast<int>(width);
+    m_WindowHeight = static_cast<int>(height);
+    glfwSetWindowSize(m_Window, m_WindowWidth, m_WindowHeight);
+
+    // The backend reads the live cursor while it believes the cursor is outside the window;
+    // entering it up front keeps the replayed positions the only source
+    const int32_t one = 1;
+    Dispatch(Focus, &one);
+    Dispatch(CursorEnter, &one);
+    LOG_INFO(General, "Reproduzindo entrada de %s (%llu quadros, %zu bytes; gravado com: %s)",
+             path, (unsigned long long)m_FrameCount, m_Bytes, m_Note);
+    return true;
+}
+
+void InputRecorder::Stop() {
+    if (m_Mode == Mode::Recording) {
+        m_File.close();
+        LOG_INFO(General, "Gravacao de entrada encerrada: %llu quadros, %zu bytes", (unsigned long long)m_Frame, m_Bytes);
+    }
+    m_Mode = Mode::Off;
+    m_Buffer.clear();
+}
+
+// Frame: varint header = zigzag(delta micros - previous delta micros) << 4 | min(event count, 15),
+// a varint with the rest of the count when it is 15 or more, then the events
+bool InputRecorder::NextFrame() {
+    if (m_Mode == Mode::Replaying) {
+        if (m_ReadOffset < m_Buffer.size() && ReadFrame(true)) return true;
+        Stop();
+        return false;
+    }
+    if (m_Mode != Mode::Recording) return true;
+
+    double now = glfwGetTime();
+    uint32_t delta = m_Frame == 0 ? kFirstFrameMicros
+                                  : static_cast<uint32_t>(std::clamp((now - m_LastFrameTime) * 1e6, 1.0, 10e6));
+    m_LastFrameTime = now;
+
+    int width = 0, height = 0;
+    glfwGetWindowSize(m_Window, &width, &height);
+    if (width != m_WindowWidth || height != m_WindowHeight) {
+        const int32_t size[2] = { width, height };
+        Record(WindowSize, size, 2);
+        m_WindowWidth = width;
+        m_WindowHeight = height;
+    }
+
+    std::vector<uint8_t> frame;
+    uint64_t shortCount = std::min<uint32_t>(m_FrameEventCount, 15);
+    WriteVarint(frame, ZigZag(static_cast<int64_t>(delta) - m_DeltaMicros) << 4 | shortCount);
+    if (shortCount == 15) WriteVarint(frame, m_FrameEventCount - 15);
+    frame.insert(frame.end(), m_FrameEvents.begin(), m_FrameEvents.end());
+    m_File.write(reinterpret_cast<const char*>(frame.data()), frame.size());
+
+    m_Bytes += frame.size();
+    m_FrameEvents.clear();
+    m_FrameEventCount = 0;
+    m_DeltaMicros = delta;
+    m_TimeMicros += delta;
+    m_Frame++;
+    return true;
+}
+
+bool InputRecorder::ReadFrame(bool dispatch) {
+    uint64_t header, count;
+    if (!ReadVarint(m_Buffer, m_ReadOffset, header)) return false;
+    count = header & 15;
+    if (count == 15) {
+        uint64_t rest;
+        if (!ReadVarint(m_Buffer, m_ReadOffset, rest)) return false;
+        count += rest;
+    }
+    m_DeltaMicros = static_cast<uint32_t>(m_DeltaMicros + UnZigZag(header >> 4));
+    m_TimeMicros += m_DeltaMicros;
+    m_Frame++;
+
+    for (uint64_t i = 0; i < count; ++i) {
+        if (m_ReadOffset >= m_Buffer.size()) return false;
+        EventType type = static_cast<EventType>(m_Buffer[m_ReadOffset++]);
+        uint64_t a = 0, b = 0, c = 0;
+        int32_t values[4] = {};
+        switch (type) {
+            case CursorPos:
+                if (!ReadVarint(m_Buffer, m_ReadOffset, a) || !ReadVarint(m_Buffer, m_ReadOffset, b)) return false;
+                m_CursorX += static_cast<int32_t>(UnZigZag(a));
+                m_CursorY += static_cast<int32_t>(UnZigZag(b));
+                values[0] = m_CursorX;
+                values[1] = m_CursorY;
+                break;
+            case MouseButton:
+                if (!ReadVarint(m_Buffer, m_ReadOffset, a)) return false;
+                values[0] = static_cast<int32_t>(a & 7);
+                values[1] = static_cast<int32_t>((a >> 3) & 1);
+                values[2] = static_cast<int32_t>(a >> 4);
+                break;
+            case Scroll:
+            case WindowSize:
+                if (!ReadVarint(m_Buffer, m_ReadOffset, a) || !ReadVarint(m_Buffer, m_ReadOffset, b)) return false;
+                values[0] = static_cast<int32_t>(type == Scroll ? UnZigZag(a) : a);
+                values[1] = static_cast<int32_t>(type == Scroll ? UnZigZag(b) : b);
+                break;
+            case Key:
+                if (!ReadVarint(m_Buffer, m_ReadOffset, a) || !ReadVarint(m_Buffer, m_ReadOffset, b) ||
+                    !ReadVarint(m_Buffer, m_ReadOffset, c)) return false;
+                values[0] = static_cast<int32_t>(a) - 1; // GLFW_KEY_UNKNOWN is -1
+                values[1] = static_cast<int32_t>(UnZigZag(b));
+                values[2] = static_cast<int32_t>(c & 3);
+                values[3] = static_cast<int32_t>(c >> 2);
+                break;
+            case Char:
+            case Focus:
+            case CursorEnter:
+                if (!ReadVarint(m_Buffer, m_ReadOffset, a)) return false;
+                values[0] = static_cast<int32_t>(a);
+                break;
+            default:
+                LOG_ERROR(General, "Log de entrada corrompido no quadro %llu", (unsigned long long)m_Frame);
+                return false;
+        }
+        if (dispatch) Dispatch(type, values);
+    }
+    return true;
+}
+
+void InputRecorder::Record(EventType type, const int32_t* values, int count) {
+    (void)count;
+    m_FrameEvents.push_back(type);
+    switch (type) {
+        case CursorPos:
+            WriteVarint(m_FrameEvents, ZigZag(values[0] - m_CursorX));
+            WriteVarint(m_FrameEvents, ZigZag(values[1] - m_CursorY));
+            m_CursorX = values[0];
+            m_CursorY = values[1];
+            break;
+        case MouseButton: // button (0-7), press/release, modifiers in one varint
+            WriteVarint(m_FrameEvents, static_cast<uint64_t>(values[0] & 7) | static_cast<uint64_t>(values[1] & 1) << 3 |
+                                       static_cast<uint64_t>(values[2]) << 4);
+            break;
+        case Scroll:
+            WriteVarint(m_FrameEvents, ZigZag(values[0]));
+            WriteVarint(m_FrameEvents, ZigZag(values[1]));
+            break;
+        case WindowSize:
+            WriteVarint(m_FrameEvents, static_cast<uint64_t>(values[0]));
+            WriteVarint(m_FrameEvents, static_cast<uint64_t>(values[1]));
+            break;
+        case Key: // action (release, press, repeat) and modifiers share a varint
+            WriteVarint(m_FrameEvents, static_cast<uint64_t>(values[0] + 1));
+            WriteVarint(m_FrameEvents, ZigZag(values[1]));
+            WriteVarint(m_FrameEvents, static_cast<uint64_t>(values[2] & 3) | static_cast<uint64_t>(values[3]) << 2);
+            break;
+        default:
+            WriteVarint(m_FrameEvents, static_cast<uint64_t>(values[0]));
+            break;
+    }
+    m_FrameEventCount++;
+}
+
+void InputRecorder::Dispatch(EventType type, const int32_t* values) {
+    switch (type) {
+        case CursorPos: if (m_PrevCursorPos) m_PrevCursorPos(m_Window, values[0] / 8.0, values[1] / 8.0); break;
+        case MouseButton: if (m_PrevMouseButton) m_PrevMouseButton(m_Window, values[0], values[1], values[2]); break;
+        case Scroll: if (m_PrevScroll) m_PrevScroll(m_Window, values[0] / 120.0, values[1] / 120.0); break;
+        case Key: if (m_PrevKey) m_PrevKey(m_Window, values[0], values[1], values[2], values[3]); break;
+        case Char: if (m_PrevChar) m_PrevChar(m_Window, static_cast<unsigned int>(values[0])); break;
+        case Focus: if (m_PrevFocus) m_PrevFocus(m_Window, values[0]); break;
+        case CursorEnter: if (m_PrevCursorEnter) m_PrevCursorEnter(m_Window, values[0]); break;
+        case WindowSize: glfwSetWindowSize(m_Window, values[0], values[1]); break;
+    }
+}
+
+// Live events: quantized and recorded while recording, dropped while replaying, passed through otherwise
+
+void InputRecorder::OnCursorPos(GLFWwindow* window, double x, double y) {
+    InputRecorder* self = s_Recorder;
+    if (self->m_Mode == Mode::Off) {
+        if (self->m_PrevCursorPos) self->m_PrevCursorPos(window, x, y);
+        return;
+    }
+    if (self->m_Mode == Mode::Replaying) return;
+    const int32_t values[2] = { Quantize(x, 8.0), Quantize(y, 8.0) };
+    self->Record(CursorPos, values, 2);
+    self->Dispatch(CursorPos, values);
+}
+
+void InputRecorder::OnMouseButton(GLFWwindow* window, int button, int action, int mods) {
+    InputRecorder* self = s_Recorder;
+    if (self->m_Mode == Mode::Off) {
+        if (self->m_PrevMouseButton) self->m_PrevMouseButton(window, button, action, mods);
+        return;
+    }
+    if (self->m_Mode == Mode::Replaying) return;
+    const int32_t values[3] = { button, action, mods };
+    self->Record(MouseButton, values, 3);
+    self->Dispatch(MouseButton, values);
+}
+
+void InputRecorder::OnScroll(GLFWwindow* window, double x, double y) {
+    InputRecorder* self = s_Recorder;
+    if (self->m_Mode == Mode::Off) {
+        if (self->m_PrevScroll) self->m_PrevScroll(window, x, y);
+        return;
+    }
+    if (self->m_Mode == Mode::Replaying) return;
+    const int32_t values[2] = { Quantize(x, 120.0), Quantize(y, 120.0) };
+    self->Record(Scroll, values, 2);
+    self->Dispatch(Scroll, values);
+}
+
+void InputRecorder::OnKey(GLFWwindow* window, int key, int scancode, int action, int mods) {
+    InputRecorder* self = s_Recorder;
+    if (self->m_Mode == Mode::Off) {
+        if (self->m_PrevKey) self->m_PrevKey(window, key, scancode, action, mods);
+        return;
+    }
+    if (self->m_Mode == Mode::Replaying) return;
+    const int32_t values[4] = { key, scancode, action, mods };
+    self->Record(Key, values, 4);
+    self->Dispatch(Key, values);
+}
+
+void InputRecorder::OnChar(GLFWwindow* window, unsigned int codepoint) {
+    InputRecorder* self = s_Recorder;
+    if (self->m_Mode == Mode::Off) {
+        if (self->m_PrevChar) self->m_PrevChar(window, codepoint);
+        return;
+    }
+    if (self->m_Mode == Mode::Replaying) return;
+    const int32_t values[1] = { static_cast<int32_t>(codepoint) };
+    self->Record(Char, values, 1);
+    self->Dispatch(Char, values);
+}
+
+void InputRecorder::OnFocus(GLFWwindow* window, int focused) {
+    InputRecorder* self = s_Recorder;
+    if (self->m_Mode == Mode::Off) {
+        if (self->m_PrevFocus) self->m_PrevFocus(window, focused);
+        return;
+    }
+    if (self->m_Mode == Mode::Replaying) return;
+    const int32_t values[1] = { focused };
+    self->Record(Focus, values, 1);
+    self->Dispatch(Focus, values);
+}
+
+void InputRecorder::OnCursorEnter(GLFWwindow* window, int entered) {
+    InputRecorder* self = s_Recorder;
+    if (self->m_Mode == Mode::Off) {
+        if (self->m_PrevCursorEnter) self->m_PrevCursorEnter(window, entered);
+        return;
+    }
+    if (self->m_Mode == Mode::Replaying) return;
+    const int32_t values[1] = { entered };
+    self->Record(CursorEnter, values, 1);
+    self->Dispatch(CursorEnter, values);
+}
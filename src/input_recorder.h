@@ -0,0 +1,95 @@
+#pragma once
+#include <GLFW/glfw3.h>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Input recording and replay, for reproducing editor sessions (and their frame timings).
+//
+// Install() takes over the window's input callbacks and chains to the ones that were set
+// before (the ImGui GLFW backend), so every mouse, scroll, key, text, focus and cursor-enter
+// event goes through here. While recording, events are stored per frame together with the
+// frame's delta time; while replaying, live events are dropped and each NextFrame() feeds the
+// next recorded frame to the backend instead. The editor runs both modes with the recorded
+// delta time (EngineUI::SetDeltaTimeOverride), so ImGui timing (double clicks, key repeat)
+// and the scene time are identical on replay.
+//
+// The log is compact enough to attach to bug reports: varints throughout, the delta time
+// stored as a change from the previous frame, cursor positions as changes from the previous
+// position, and an idle frame costs one or two bytes. Floats are quantized (cursor to 1/8 px,
+// scroll to 1/120 of a notch) before they reach ImGui, also while recording, so what is
+// replayed is exactly what was seen.
+class InputRecorder {
+public:
+    enum class Mode : uint8_t { Off, Recording, Replaying };
+
+    ~InputRecorder() { Stop(); }
+
+    void Install(GLFWwindow* window);
+
+    // Both are meant to start before the first frame. layout is the UI layout (ImGui ini) to
+    // restore on replay; note is free text kept in the header (the command line).
+    bool StartRecording(const std::string& path, const std::string& layout, const std::string& note);
+    bool StartReplay(const std::string& path);
+    void Stop();
+
+    // Frame boundary, after events were polled. Recording: stores the frame. Replaying:
+    // dispatches the next recorded frame; returns false once the log is exhausted.
+    bool NextFrame();
+
+    Mode GetMode() const { return m_Mode; }
+    bool IsActive() const { return m_Mode != Mode::Off; }
+    bool IsReplaying() const { return m_Mode == Mode::Replaying; }
+    float GetDeltaTime() const { return m_DeltaMicros * 1e-6f; } // current frame
+    double GetTime() const { return m_TimeMicros * 1e-6; }       // sum of the delta times so far
+    uint64_t GetFrame() const { return m_Frame; }
+    uint64_t GetFrameCount() const { return m_FrameCount; } // replay: frames in the log
+    size_t GetByteCount() const { return m_Bytes; }
+    const std::string& GetLayout() const { return m_Layout; } // replay: layout stored in the log
+    const std::string& GetNote() const { return m_Note; }
+
+private:
+    enum EventType : uint8_t { CursorPos, MouseButton, Scroll, Key, Char, Focus, CursorEnter, WindowSize };
+
+    static void OnCursorPos(GLFWwindow* window, double x, double y);
+    static void OnMouseButton(GLFWwindow* window, int button, int action, int mods);
+    static void OnScroll(GLFWwindow* window, double x, double y);
+    static void OnKey(GLFWwindow* window, int key, int scancode, int action, int mods);
+    static void OnChar(GLFWwindow* window, unsigned int codepoint);
+    static void OnFocus(GLFWwindow* window, int focused);
+    static void OnCursorEnter(GLFWwindow* window, int entered);
+
+    // Forwards one (quantized) event to the previous callbacks
+    void Dispatch(EventType type, const int32_t* values);
+    void Record(EventType type, const int32_t* values, int count);
+    // Decodes the next frame; dispatch = false only validates it (used to count the frames)
+    bool ReadFrame(bool dispatch);
+
+    GLFWwindow* m_Window = nullptr;
+    GLFWcursorposfun m_PrevCursorPos = nullptr;
+    GLFWmousebuttonfun m_PrevMouseButton = nullptr;
+    GLFWscrollfun m_PrevScroll = nullptr;
+    GLFWkeyfun m_PrevKey = nullptr;
+    GLFWcharfun m_PrevChar = nullptr;
+    GLFWwindowfocusfun m_PrevFocus = nullptr;
+    GLFWcursorenterfun m_PrevCursorEnter = nullptr;
+
+    Mode m_Mode = Mode::Off;
+    std::ofstream m_File;
+    std::vector<uint8_t> m_Buffer;      // replay: the whole log
+    size_t m_ReadOffset = 0;
+    std::vector<uint8_t> m_FrameEvents; // recording: events of the frame being built
+    uint32_t m_FrameEventCount = 0;
+
+    std::string m_Layout;
+    std::string m_Note;
+    uint64_t m_Frame = 0;
+    uint64_t m_FrameCount = 0;
+    size_t m_Bytes = 0;
+    double m_LastFrameTime = 0.0;
+    uint32_t m_DeltaMicros = 0;
+    uint64_t m_TimeMicros = 0;
+    int32_t m_CursorX = 0, m_CursorY = 0; // last cursor position, 1/8 px (delta base)
+    int m_WindowWidth = 0, m_WindowHeight = 0;
+};
@@ -0,0 +1,102 @@
+#include "job_system.h"
+#include "profiler.h"
+#include <algorithm>
+#include <string>
+
+namespace {
+    // Set while a thread runs job chunks (workers, and the caller during a dispatch)
+    // so nested ParallelFor calls run inline
+    thread_local bool t_InsideJob = false;
+}
+
+JobSystem::JobSystem(unsigned int workerCount) {
+    if (workerCount == 0) {
+        unsigned int hw = std::thread::hardware_concurrency();
+        workerCount = hw > 1 ? hw - 1 : 0;
+    }
+
+    m_Workers.reserve(workerCount);
+    for (unsigned int i = 0; i < workerCount; ++i) {
+        m_Workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Quit = true;
+    }
+    m_WakeCv.notify_all();
+    for (std::thread& worker : m_Workers) {
+        worker.join();
+    }
+}
+
+void JobSystem::ParallelFor(size_t count, size_t chunkSize, const RangeJob& job) {
+    if (count == 0) return;
+    if (chunkSize == 0) chunkSize = 1;
+
+    size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+    if (m_Workers.empty() || chunkCount == 1 || t_InsideJob) {
+        job(0, count);
+        return;
+    }
+
+    std::lock_guard<std::mutex> dispatchLock(m_DispatchMutex);
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Job = &job;
+        m_Count = count;
+        m_ChunkSize = chunkSize;
+        m_ChunkCount = chunkCount;
+        m_NextChunk.store(0, std::memory_order_relaxed);
+        m_BusyWorkers = m_Workers.size();
+        ++m_Generation;
+    }
+    m_WakeCv.notify_all();
+
+    // The calling thread works too instead of just waiting
+    t_InsideJob = true;
+    RunChunks();
+    t_InsideJob = false;
+
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_DoneCv.wait(lock, [this] { return m_BusyWorkers == 0; });
+    m_Job = nullptr;
+}
+
+void JobSystem::WorkerLoop(unsigned int index) {
+    Profiler::SetThreadName(("Worker " + std::to_string(index)).c_str());
+    t_InsideJob = true;
+    uint64_t seenGeneration = 0;
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_WakeCv.wait(lock, [&] { return m_Quit || m_Generation != seenGeneration; });
+            if (m_Quit) return;
+            seenGeneration = m_Generation;
+        }
+
+        RunChunks();
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            if (--m_BusyWorkers == 0) {
+                m_DoneCv.notify_one();
+            }
+        }
+    }
+}
+
+void JobSystem::RunChunks() {
+    for (;;) {
+        size_t chunk = m_NextChunk.fetch_add(1, std::memory_order_relaxed);
+        if (chunk >= m_ChunkCount) break;
+
+        size_t begin = chunk * m_ChunkSize;
+        size_t end = std::min(begin + m_ChunkSize, m_Count);
+        PROFILE_SCOPE("Job");
+        (*m_Job)(begin, end);
+    }
+}
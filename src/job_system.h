@@ -0,0 +1,50 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Small fixed-size worker pool.
+// ParallelFor splits [0, count) into chunks that the workers and the calling thread
+// pull from a shared atomic counter; the call returns once every chunk has run.
+// Calls made from inside a job (on a worker or the dispatching thread) run inline to avoid deadlocks.
+class JobSystem {
+public:
+    using RangeJob = std::function<void(size_t begin, size_t end)>;
+
+    // workerCount = 0 uses hardware_concurrency - 1 (the caller is the extra thread)
+    explicit JobSystem(unsigned int workerCount = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    void ParallelFor(size_t count, size_t chunkSize, const RangeJob& job);
+
+    // Number of threads that take part in a ParallelFor (workers + caller)
+    unsigned int GetThreadCount() const { return static_cast<unsigned int>(m_Workers.size()) + 1; }
+
+private:
+    void WorkerLoop(unsigned int index);
+    void RunChunks();
+
+    std::vector<std::thread> m_Workers;
+
+    std::mutex m_DispatchMutex; // one ParallelFor in flight at a time
+    std::mutex m_Mutex;
+    std::condition_variable m_WakeCv;
+    std::condition_variable m_DoneCv;
+
+    const RangeJob* m_Job = nullptr;
+    size_t m_Count = 0;
+    size_t m_ChunkSize = 1;
+    size_t m_ChunkCount = 0;
+    std::atomic<size_t> m_NextChunk{ 0 };
+    size_t m_BusyWorkers = 0;
+    uint64_t m_Generation = 0;
+    bool m_Quit = false;
+};
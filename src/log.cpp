@@ -0,0 +1,265 @@
+#include "log.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+    const char* const kLevelNames[] = { "TRACE", "DEBUG", "INFO", "WARN", "ERROR" };
+    const char* const kCategoryNames[] = { "General", "Render", "Assets", "Scene", "Editor" };
+
+    int64_t NowNanoseconds() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Small per-thread number for the log prefix (0 is whoever logged first, usually main)
+    uint32_t GetThreadNumber() {
+        static std::atomic<uint32_t> next{ 0 };
+        thread_local uint32_t number = next.fetch_add(1, std::memory_order_relaxed);
+        return number;
+    }
+}
+
+const char* GetLogLevelName(LogLevel level) {
+    return level < LogLevel::Count ? kLevelNames[static_cast<int>(level)] : "?";
+}
+
+const char* GetLogCategoryName(LogCategory category) {
+    return category < LogCategory::Count ? kCategoryNames[static_cast<int>(category)] : "?";
+}
+
+struct Logger::State {
+    State() {
+        for (size_t i = 0; i < kRingSize; ++i) ring[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    // Bounded MPMC queue (Vyukov) used with a single consumer: each slot's sequence says
+    // whether it is free for the producer at position p (== p) or ready for the consumer (== p + 1)
+    Record ring[kRingSize];
+    alignas(64) std::atomic<size_t> enqueuePos{ 0 };
+    alignas(64) size_t dequeuePos = 0; // drain thread only
+
+    // Formatted lines for the Console panel (ring of kHistorySize)
+    std::mutex historyMutex;
+    std::vector<LogLine> history;
+    uint64_t historyCount = 0; // lines ever appended
+
+    std::thread thread;
+    std::atomic<bool> running{ false };
+    std::ofstream file;
+    int64_t startTime = NowNanoseconds();
+};
+
+Logger::State Logger::s_State;
+std::atomic<uint8_t> Logger::s_MinLevel{ static_cast<uint8_t>(RAMPAGE_LOG_LEVEL) };
+std::atomic<uint64_t> Logger::s_Dropped{ 0 };
+
+void Logger::Init(const char* filePath) {
+    if (s_State.running.load()) return;
+    if (filePath) {
+        s_State.file.open(filePath, std::ios::out | std::ios::trunc);
+        if (!s_State.file) std::cerr << "Failed to open log file: " << filePath << std::endl;
+    }
+    s_State.history.reserve(kHistorySize);
+    s_State.running.store(true);
+    s_State.thread = std::thread(&Logger::DrainThread);
+}
+
+void Logger::Shutdown() {
+    if (!s_State.running.exchange(false)) return;
+    s_State.thread.join();
+    Drain(); // anything logged while the thread was stopping
+    if (s_State.file.is_open()) s_State.file.close();
+}
+
+Logger::Record* Logger::BeginRecord() {
+    size_t pos = s_State.enqueuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        Record& record = s_State.ring[pos & (kRingSize - 1)];
+        size_t sequence = record.sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            if (s_State.enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                record.timestamp = NowNanoseconds();
+                record.thread = GetThreadNumber();
+                return &record;
+            }
+        } else if (diff < 0) {
+            // The consumer hasn't freed this slot yet: the ring is full
+            s_Dropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        } else {
+            pos = s_State.enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void Logger::CommitRecord(Record* record) {
+    size_t pos = record->sequence.load(std::memory_order_relaxed);
+    record->sequence.store(pos + 1, std::memory_order_release);
+}
+
+void Logger::EncodeString(Record& record, const char* text, size_t length) {
+    Arg& arg = record.args[record.argCount++];
+    arg.type = Arg::String;
+    arg.stringOffset = record.stringBytes;
+
+    // Truncate to what is left of the record (keeping room for the terminator)
+    size_t available = kStringBytes - record.stringBytes;
+    if (available == 0) {
+        arg.stringOffset = kStringBytes - 1; // points at the last terminator
+        return;
+    }
+    length = length < available - 1 ? length : available - 1;
+    std::memcpy(record.strings + record.stringBytes, text, length);
+    record.strings[record.stringBytes + length] = '\0';
+    record.stringBytes += static_cast<uint32_t>(length + 1);
+}
+
+// printf-style formatting of a deferred record: every conversion is handed to snprintf on
+// its own with the stored argument, after replacing the length modifier with the 64-bit one
+void Logger::Format(const Record& record, std::string& out) {
+    char buffer[512];
+    double seconds = (record.timestamp - s_State.startTime) * 1e-9;
+    int prefix = std::snprintf(buffer, sizeof(buffer), "[%9.3f] [%s] [%s] [T%u] ", seconds,
+                               GetLogLevelName(record.level), GetLogCategoryName(record.category), record.thread);
+    out.assign(buffer, prefix > 0 ? static_cast<size_t>(prefix) : 0);
+
+    int argIndex = 0;
+    for (const char* c = record.format; *c; ++c) {
+        if (*c != '%') {
+            out += *c;
+            continue;
+        }
+        if (c[1] == '%') {
+            out += '%';
+            ++c;
+            continue;
+        }
+
+        // Copy flags, width and precision; skip length modifiers
+        char spec[32];
+        size_t length = 0;
+        spec[length++] = '%';
+        ++c;
+        while (*c && std::strchr("-+ #0123456789.", *c) && length < sizeof(spec) - 4) spec[length++] = *c++;
+        while (*c && std::strchr("hljztL", *c)) ++c;
+        if (!*c) break;
+        char conversion = *c;
+
+        if (argIndex >= record.argCount) {
+            out += "<missing>";
+            continue;
+        }
+        const Arg& arg = record.args[argIndex++];
+        int written = 0;
+        switch (conversion) {
+        case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'c': {
+            if (conversion == 'c') {
+                spec[length++] = 'c';
+                spec[length] = '\0';
+                written = std::snprintf(buffer, sizeof(buffer), spec, static_cast<int>(arg.i));
+                break;
+            }
+            spec[length++] = 'l';
+            spec[length++] = 'l';
+            spec[length++] = conversion;
+            spec[length] = '\0';
+            if (arg.type == Arg::Double) {
+                written = std::snprintf(buffer, sizeof(buffer), spec, static_cast<long long>(arg.d));
+            } else {
+                written = std::snprintf(buffer, sizeof(buffer), spec, static_cast<long long>(arg.i));
+            }
+            break;
+        }
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': {
+            spec[length++] = conversion;
+            spec[length] = '\0';
+            double value = arg.type == Arg::Double ? arg.d : arg.type == Arg::UInt ? static_cast<double>(arg.u) : static_cast<double>(arg.i);
+            written = std::snprintf(buffer, sizeof(buffer), spec, value);
+            break;
+        }
+        case 's': {
+            spec[length++] = 's';
+            spec[length] = '\0';
+            const char* text = arg.type == Arg::String ? record.strings + arg.stringOffset : "<not a string>";
+            written = std::snprintf(buffer, sizeof(buffer), spec, text);
+            break;
+        }
+        case 'p': {
+            written = std::snprintf(buffer, sizeof(buffer), "%p", arg.p);
+            break;
+        }
+        default:
+            out += '%';
+            out += conversion;
+            continue;
+        }
+        if (written > 0) out.append(buffer, std::min(static_cast<size_t>(written), sizeof(buffer) - 1));
+    }
+}
+
+// Consumes every committed record; returns how many were processed
+size_t Logger::Drain() {
+    std::string text;
+    std::string consoleBatch;
+    size_t processed = 0;
+
+    for (;;) {
+        Record& record = s_State.ring[s_State.dequeuePos & (kRingSize - 1)];
+        size_t sequence = record.sequence.load(std::memory_order_acquire);
+        if (sequence != s_State.dequeuePos + 1) break; // not committed yet
+
+        LogLine line;
+        line.level = record.level;
+        line.category = record.category;
+        Format(record, line.text);
+
+        // Hand the slot back to the producers (one lap later)
+        record.sequence.store(s_State.dequeuePos + kRingSize, std::memory_order_release);
+        ++s_State.dequeuePos;
+        ++processed;
+
+        consoleBatch += line.text;
+        consoleBatch += '\n';
+        if (s_State.file.is_open()) {
+            s_State.file << line.text << '\n';
+        }
+
+        std::lock_guard<std::mutex> lock(s_State.historyMutex);
+        if (s_State.history.size() < kHistorySize) {
+            s_State.history.push_back(std::move(line));
+        } else {
+            s_State.history[s_State.historyCount % kHistorySize] = std::move(line);
+        }
+        ++s_State.historyCount;
+    }
+
+    if (processed > 0) {
+        std::cout << consoleBatch << std::flush;
+        if (s_State.file.is_open()) s_State.file.flush();
+    }
+    return processed;
+}
+
+void Logger::DrainThread() {
+    while (s_State.running.load(std::memory_order_acquire)) {
+        if (Drain() == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+    }
+}
+
+void Logger::ReadHistory(uint64_t& cursor, void (*append)(void* user, const LogLine& line), void* user) {
+    std::lock_guard<std::mutex> lock(s_State.historyMutex);
+    uint64_t oldest = s_State.historyCount > kHistorySize ? s_State.historyCount - kHistorySize : 0;
+    if (cursor < oldest) cursor = oldest;
+    for (; cursor < s_State.historyCount; ++cursor) {
+        append(user, s_State.history[cursor % kHistorySize]);
+    }
+}
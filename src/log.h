@@ -0,0 +1,169 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+// Asynchronous logger.
+//
+// LOG_INFO(Render, "Loaded %s (%d vertices)", path, count) does not format anything on the
+// calling thread: it copies the format pointer and the raw arguments (strings by value) into a
+// slot of a bounded lock-free MPSC ring and returns. A background thread drains the ring,
+// formats the records and writes them to the console, the log file and the history read by
+// the editor's Console panel. When the ring is full the record is dropped and counted, so a
+// producer never blocks.
+//
+// The format must be a string literal (only its pointer is kept) using printf conversions;
+// length modifiers are ignored since every integer travels as 64 bits.
+//
+// Levels below RAMPAGE_LOG_LEVEL are stripped at compile time (arguments are not evaluated).
+
+enum class LogLevel : uint8_t { Trace = 0, Debug, Info, Warning, Error, Count };
+enum class LogCategory : uint8_t { General = 0, Render, Assets, Scene, Editor, Count };
+
+const char* GetLogLevelName(LogLevel level);
+const char* GetLogCategoryName(LogCategory category);
+
+#ifndef RAMPAGE_LOG_LEVEL
+#ifdef NDEBUG
+#define RAMPAGE_LOG_LEVEL 2 // Info
+#else
+#define RAMPAGE_LOG_LEVEL 1 // Debug
+#endif
+#endif
+
+// One formatted line, as kept in the history
+struct LogLine {
+    LogLevel level = LogLevel::Info;
+    LogCategory category = LogCategory::General;
+    std::string text;
+};
+
+class Logger {
+public:
+    static const size_t kRingSize = 4096;     // records in flight (power of two)
+    static const size_t kHistorySize = 4096;  // formatted lines kept for the Console panel
+    static const int kMaxArgs = 8;
+    static const size_t kStringBytes = 192;   // per-record storage for string arguments
+
+    // Starts the drain thread; filePath may be null to log to the console only
+    static void Init(const char* filePath = "rampage.log");
+    // Drains what is left, then stops the thread and closes the file
+    static void Shutdown();
+
+    // Runtime filter on top of the compile-time one
+    static void SetMinLevel(LogLevel level) { s_MinLevel.store(static_cast<uint8_t>(level), std::memory_order_relaxed); }
+    static bool IsEnabled(LogLevel level) { return static_cast<uint8_t>(level) >= s_MinLevel.load(std::memory_order_relaxed); }
+
+    template <typename... Args>
+    static void Write(LogLevel level, LogCategory category, const char* format, const Args&... args) {
+        static_assert(sizeof...(Args) <= kMaxArgs, "too many log arguments");
+        if (!IsEnabled(level)) return;
+
+        Record* record = BeginRecord();
+        if (!record) return; // ring full: dropped
+        record->level = level;
+        record->category = category;
+        record->format = format;
+        record->argCount = 0;
+        record->stringBytes = 0;
+        (Encode(*record, args), ...);
+        CommitRecord(record);
+    }
+
+    // Appends the history lines produced since cursor (a running line number) and advances it.
+    // Lines that already fell out of the history are skipped.
+    static void ReadHistory(uint64_t& cursor, void (*append)(void* user, const LogLine& line), void* user);
+    static uint64_t GetDroppedCount() { return s_Dropped.load(std::memory_order_relaxed); }
+
+private:
+    struct Arg {
+        enum Type : uint8_t { Int, UInt, Double, String, Pointer } type;
+        union {
+            int64_t i;
+            uint64_t u;
+            double d;
+            const void* p;
+            uint32_t stringOffset; // into Record::strings
+        };
+    };
+
+    struct Record {
+        std::atomic<size_t> sequence;
+        int64_t timestamp; // steady clock, nanoseconds
+        const char* format;
+        uint32_t thread;
+        LogLevel level;
+        LogCategory category;
+        uint8_t argCount;
+        uint32_t stringBytes;
+        Arg args[kMaxArgs];
+        char strings[kStringBytes];
+    };
+
+    static Record* BeginRecord();
+    static void CommitRecord(Record* record);
+
+    static void EncodeString(Record& record, const char* text, size_t length);
+    static void Encode(Record& record, const char* value) { EncodeString(record, value ? value : "(null)", value ? std::strlen(value) : 6); }
+    static void Encode(Record& record, char* value) { Encode(record, static_cast<const char*>(value)); }
+    static void Encode(Record& record, const std::string& value) { EncodeString(record, value.data(), value.size()); }
+    template <size_t N>
+    static void Encode(Record& record, const char (&value)[N]) { Encode(record, static_cast<const char*>(value)); }
+    template <typename T>
+    static void Encode(Record& record, const T& value) {
+        Arg& arg = record.args[record.argCount++];
+        if constexpr (std::is_enum<T>::value) {
+            arg.type = Arg::Int;
+            arg.i = static_cast<int64_t>(value);
+        } else if constexpr (std::is_floating_point<T>::value) {
+            arg.type = Arg::Double;
+            arg.d = static_cast<double>(value);
+        } else if constexpr (std::is_integral<T>::value && std::is_signed<T>::value) {
+            arg.type = Arg::Int;
+            arg.i = static_cast<int64_t>(value);
+        } else if constexpr (std::is_integral<T>::value) {
+            arg.type = Arg::UInt;
+            arg.u = static_cast<uint64_t>(value);
+        } else {
+            static_assert(std::is_pointer<T>::value, "unsupported log argument type");
+            arg.type = Arg::Pointer;
+            arg.p = static_cast<const void*>(value);
+        }
+    }
+
+    static void DrainThread();
+    static size_t Drain();
+    static void Format(const Record& record, std::string& out);
+
+    struct State; // ring, history and drain thread (log.cpp)
+    static State s_State;
+    static std::atomic<uint8_t> s_MinLevel;
+    static std::atomic<uint64_t> s_Dropped;
+};
+
+#define RAMPAGE_LOG(level, category, ...) Logger::Write(level, LogCategory::category, __VA_ARGS__)
+
+#if RAMPAGE_LOG_LEVEL <= 0
+#define LOG_TRACE(category, ...) RAMPAGE_LOG(LogLevel::Trace, category, __VA_ARGS__)
+#else
+#define LOG_TRACE(category, ...) ((void)0)
+#endif
+#if RAMPAGE_LOG_LEVEL <= 1
+#define LOG_DEBUG(category, ...) RAMPAGE_LOG(LogLevel::Debug, category, __VA_ARGS__)
+#else
+#define LOG_DEBUG(category, ...) ((void)0)
+#endif
+#if RAMPAGE_LOG_LEVEL <= 2
+#define LOG_INFO(category, ...) RAMPAGE_LOG(LogLevel::Info, category, __VA_ARGS__)
+#else
+#define LOG_INFO(category, ...) ((void)0)
+#endif
+#if RAMPAGE_LOG_LEVEL <= 3
+#define LOG_WARN(category, ...) RAMPAGE_LOG(LogLevel::Warning, category, __VA_ARGS__)
+#else
+#define LOG_WARN(category, ...) ((void)0)
+#endif
+#define LOG_ERROR(category, ...) RAMPAGE_LOG(LogLevel::Error, category, __VA_ARGS__)
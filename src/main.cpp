@@ -9,128 +9,606 @@
 #include "framebuffer.h"
 #include "shader.h"
 #include "mesh.h"
-#include "gameobject.h"
+#include "ecs.h"
+#include "components.h"
 #include "texture.h"
 #include "material.h"
 #include "texture_generator.h"
+#include "frame_stats.h"
+#include "gl_trace.h"
+#include "dynamic_resolution.h"
+#include "frame_capture.h"
+#include "job_system.h"
+#include "transform_system.h"
+#include "system_scheduler.h"
+#include "pool.h"
+#include "arena.h"
+#include "spatial_index.h"
+#include "debug_draw.h"
+#include "log.h"
+#include "profiler.h"
+#include "stress_scene.h"
+#include "benchmark.h"
+#include "input_recorder.h"
+#include "shader_cache.h"
+#include "shader_watcher.h"
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <imgui.h> // Make sure imgui is included
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+// Command line options.
+// --headless renders a fixed camera orbit offscreen (no window, no ImGui) and writes
+// images and per-frame timings; it is meant for render farm / CI performance runs.
+// --benchmark flies the same camera path in the editor window and exits after --frames.
+// --stress replaces the default scene with a generated one (see StressScene); with a fixed
+// seed, runs of different builds render exactly the same content.
+// --gl-trace requests a debug context and traces GL calls from the first frame (see GlTrace).
+// --record saves the session's input and frame times (see InputRecorder); --replay plays such a
+// log back with the profiler capturing and writes the same report as --benchmark, plus trace.json.
+struct LaunchOptions {
+    bool headless = false;
+    bool benchmark = false;
+    bool glTrace = false;
+    bool stressScene = false;
+    StressSceneOptions stress;
+    int width = 1280;
+    int height = 720;
+    int frames = 240;        // headless/benchmark: frames rendered (one full camera path)
+    int imageEvery = 0;      // headless: save every Nth frame as QOI (0 = only the last one)
+    std::string outputDir = "headless_output";
+    std::string recordPath;  // input log written by --record
+    std::string replayPath;  // input log played back by --replay
+
+    bool IsScripted() const { return headless || benchmark; }
+    bool WritesReport() const { return IsScripted() || !replayPath.empty(); }
+};
+
+static void PrintUsage() {
+    std::cout << "Uso: Rampage_Engine_Alpha [--headless | --benchmark] [--frames N] [--size LARGURAxALTURA]\n"
+                 "                          [--output DIRETORIO] [--image-every N] [--gl-trace]\n"
+                 "                          [--stress] [--seed N] [--objects N] [--meshes N] [--materials N]\n"
+                 "                          [--layout grid|cluster|random] [--moving FRACAO]\n"
+                 "                          [--record ARQUIVO | --replay ARQUIVO]\n";
+}
+
+static bool ParseLaunchOptions(int argc, char** argv, LaunchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (std::strcmp(arg, "--headless") == 0) {
+            options.headless = true;
+        } else if (std::strcmp(arg, "--benchmark") == 0) {
+            options.benchmark = true;
+        } else if (std::strcmp(arg, "--gl-trace") == 0) {
+            options.glTrace = true;
+        } else if (std::strcmp(arg, "--stress") == 0) {
+            options.stressScene = true;
+        } else if (std::strcmp(arg, "--seed") == 0 && value) {
+            options.stress.seed = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+            ++i;
+        } else if (std::strcmp(arg, "--objects") == 0 && value) {
+            options.stress.objects = std::max(0, std::atoi(value));
+            ++i;
+        } else if (std::strcmp(arg, "--meshes") == 0 && value) {
+            options.stress.meshes = std::max(1, std::atoi(value));
+            ++i;
+        } else if (std::strcmp(arg, "--materials") == 0 && value) {
+            options.stress.materials = std::max(1, std::atoi(value));
+            ++i;
+        } else if (std::strcmp(arg, "--layout") == 0 && value) {
+            if (!StressScene::ParseLayout(value, options.stress.layout)) return false;
+            ++i;
+        } else if (std::strcmp(arg, "--moving") == 0 && value) {
+            options.stress.movingFraction = std::min(1.0f, std::max(0.0f, (float)std::atof(value)));
+            ++i;
+        } else if (std::strcmp(arg, "--frames") == 0 && value) {
+            options.frames = std::max(1, std::atoi(value));
+            ++i;
+        } else if (std::strcmp(arg, "--size") == 0 && value) {
+            if (std::sscanf(value, "%dx%d", &options.width, &options.height) != 2 ||
+                options.width <= 0 || options.height <= 0) return false;
+            ++i;
+        } else if (std::strcmp(arg, "--output") == 0 && value) {
+            options.outputDir = value;
+            ++i;
+        } else if (std::strcmp(arg, "--image-every") == 0 && value) {
+            options.imageEvery = std::max(0, std::atoi(value));
+            ++i;
+        } else if (std::strcmp(arg, "--record") == 0 && value) {
+            options.recordPath = value;
+            ++i;
+        } else if (std::strcmp(arg, "--replay") == 0 && value) {
+            options.replayPath = value;
+            ++i;
+        } else {
+            return false;
+        }
+    }
+    if (options.headless && options.benchmark) return false;
+    // Recording and replay drive the editor window with their own input
+    bool inputLog = !options.recordPath.empty() || !options.replayPath.empty();
+    if (inputLog && (options.IsScripted() || (!options.recordPath.empty() && !options.replayPath.empty()))) return false;
+    return true;
+}
+
+// Headless: GLFW's null platform (no display server) with an EGL context, which Mesa
+// provides surfaceless on llvmpipe; OSMesa is the fallback. The window is never shown
+// and all rendering goes to the Framebuffer.
+static GLFWwindow* CreateHeadlessContext(const LaunchOptions& options) {
+    const int contextApis[] = { GLFW_EGL_CONTEXT_API, GLFW_OSMESA_CONTEXT_API };
+    for (int api : contextApis) {
+        glfwDefaultWindowHints();
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, api);
+        if (options.glTrace) glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);
+        if (GLFWwindow* window = glfwCreateWindow(options.width, options.height, "Rampage Engine (headless)", nullptr, nullptr)) {
+            LOG_INFO(Render, "Contexto headless: %s", api == GLFW_EGL_CONTEXT_API ? "EGL" : "OSMesa");
+            return window;
+        }
+    }
+    return nullptr;
+}
+
+int main(int argc, char** argv) {
+    // --- Logging (drain thread writes rampage.log, stdout and the Console panel) ---
+    Logger::Init("rampage.log");
+    Profiler::SetThreadName("Main");
+
+    LaunchOptions options;
+    if (!ParseLaunchOptions(argc, argv, options)) {
+        PrintUsage();
+        Logger::Shutdown();
+        return 1;
+    }
 
-int main() {
     // --- Initialization (GLFW, Window, GLAD) ---
+    if (options.headless) glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
     if (!glfwInit()) {
-        std::cerr << "Falha ao inicializar GLFW\n";
+        LOG_ERROR(General, "Falha ao inicializar GLFW");
+        Logger::Shutdown();
         return -1;
     }
-    GLFWwindow* window = glfwCreateWindow(1280, 720, "Rampage Engine", nullptr, nullptr);
+    if (options.glTrace) glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE); // more KHR_debug messages
+    GLFWwindow* window = options.headless ? CreateHeadlessContext(options)
+                                          : glfwCreateWindow(1280, 720, "Rampage Engine", nullptr, nullptr);
     if (!window) {
-        std::cerr << "Falha ao criar janela\n";
+        LOG_ERROR(General, "Falha ao criar janela");
         glfwTerminate();
+        Logger::Shutdown();
         return -1;
     }
     glfwMakeContextCurrent(window);
-    glfwSwapInterval(1); // Enable VSync
+    // VSync, except when measuring (or nothing is presented)
+    glfwSwapInterval(options.IsScripted() || !options.replayPath.empty() ? 0 : 1);
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
-        std::cerr << "Falha ao inicializar GLAD\n";
+        LOG_ERROR(General, "Falha ao inicializar GLAD");
         glfwDestroyWindow(window); // Clean up window if GLAD fails
         glfwTerminate();
+        Logger::Shutdown();
         return -1;
     }
+    // GL call accounting and driver messages ("Chamadas GL" panel)
+    GlTrace::Install();
+    GlTrace::SetEnabled(options.glTrace);
+    // Linked program binaries from earlier runs (shader_cache/), so warm starts compile nothing
+    ShaderCache::Init();
+    Shader::InitParallelCompile((GLADloadproc)glfwGetProcAddress);
 
     // --- Initialization (Engine Systems) ---
     EngineUI engineUI;
-    engineUI.Initialize(window);
+    if (!options.headless) engineUI.Initialize(window);
+    // Sits between GLFW and the ImGui backend's callbacks; passes everything through unless recording or replaying
+    InputRecorder inputRecorder;
+    if (!options.headless) inputRecorder.Install(window);
 
-    Framebuffer framebuffer(1280, 720);
+    Framebuffer framebuffer(options.width, options.height, true); // with object ID attachment for GPU picking
     engineUI.SetFramebuffer(&framebuffer); // Link framebuffer to UI
 
     Camera camera(10.0f); // Initial camera distance
+    camera.SetPerspective(45.0f, 0.1f, 100.0f); // shared by the renderer and the editor picking rays
     engineUI.SetCamera(&camera); // Link camera to UI for object selection
     
-    // Try to load textured shader, fallback to basic if it fails
-    Shader shader("shaders/textured.vert", "shaders/textured.frag");
-    if (!shader.IsValid()) {
-        std::cout << "Falling back to basic shaders..." << std::endl;
-        shader = Shader("shaders/basic.vert", "shaders/basic.frag");
+    // --- Shaders: every program is submitted up front and compiles in parallel on the driver's threads ---
+    // The scene draws with the basic program until the textured one is ready (or if it fails)
+    Shader shader("shaders/textured.vert", "shaders/textured.frag", Shader::Compile::Async);
+    Shader basicShader("shaders/basic.vert", "shaders/basic.frag", Shader::Compile::Async);
+
+    // Reference shader that still computes inverse(model) per vertex.
+    // Only used when the comparison toggle in the "Visualizar" menu is on.
+    Shader legacyNormalShader("shaders/textured_inverse.vert", "shaders/textured.frag", Shader::Compile::Async);
+
+    // Batched debug lines (gizmos, selection bounds), flushed once per frame into the viewport
+    Shader gizmoShader("shaders/gizmo.vert", "shaders/gizmo.frag", Shader::Compile::Async);
+    DebugDraw debugDraw;
+
+    Shader* programs[] = { &shader, &basicShader, &legacyNormalShader, &gizmoShader };
+    basicShader.Poll(true); // the fallback is needed from the first frame
+    // Measured runs never draw with a fallback
+    if (options.WritesReport()) {
+        for (Shader* program : programs) program->Poll(true);
     }
+    // Edits under shaders/ recompile the programs that use the file, in the background
+    ShaderWatcher shaderWatcher;
+    if (!options.WritesReport()) shaderWatcher.Start("shaders");
+
+    if (ShaderCache::IsEnabled()) {
+        const ShaderCache::Stats& shaderCacheStats = ShaderCache::GetStats();
+        LOG_INFO(Render, "Cache de shaders: %u carregados, %u compilados (%u binarios rejeitados)",
+                 shaderCacheStats.hits, shaderCacheStats.misses, shaderCacheStats.rejected);
+    }
+
+    // Per-frame CPU/GPU pass timings and render counters (GPU times read back a few frames late)
+    FrameStats frameStats;
+    engineUI.SetFrameStats(&frameStats);
+    DynamicResolution dynamicResolution; // render scale of the viewport, from the scene pass GPU time
+
+    // Viewport screenshots and recordings, read back through a PBO ring and encoded off-thread
+    FrameCapture frameCapture;
+    engineUI.SetFrameCapture(&frameCapture);
     
-    std::cout << "Shader loaded successfully. Using material-based highlighting." << std::endl;
-    
+    // --- ASSET POOLS ---
+    // Meshes, textures and materials live in typed pools; everything else refers to them by handle
+    Pool<Mesh> meshes;
+    Pool<Texture> textures;
+    Pool<Material> materials;
+
     // --- MESH LOADING (Load meshes ONCE that can be shared) ---
-    Mesh cubeMesh; // Create a Mesh object
-    if (!cubeMesh.LoadFromOBJ("assets/Cube.obj")) { // Load into the Mesh object
-         std::cerr << "Falha ao carregar assets/Cube.obj. Saindo." << std::endl;
+    Handle<Mesh> cubeMesh = meshes.Create(); // Create a Mesh object
+    if (!meshes.Get(cubeMesh)->LoadFromOBJ("assets/Cube.obj")) { // Load into the Mesh object
+         LOG_ERROR(Assets, "Falha ao carregar assets/Cube.obj. Saindo.");
+         meshes.Clear();
+         debugDraw.Release();
+         frameStats.Release();
+         for (Shader* program : programs) program->Release();
          engineUI.Shutdown();
          glfwDestroyWindow(window);
          glfwTerminate();
+         Logger::Shutdown();
          return -1;
     }
     // You can load more distinct meshes here if needed:
-    // Mesh sphereMesh;
-    // if (!sphereMesh.LoadFromOBJ("assets/Sphere.obj")) { /* ... */ }
+    // Handle<Mesh> sphereMesh = meshes.Create();
+    // if (!meshes.Get(sphereMesh)->LoadFromOBJ("assets/Sphere.obj")) { /* ... */ }
 
     // --- TEXTURE AND MATERIAL SETUP ---
     // Create procedural textures
     auto checkerboardData = TextureGenerator::GenerateCheckerboard(256, 256, 32);
-    Texture* checkerboardTexture = new Texture();
-    checkerboardTexture->LoadFromData(checkerboardData, 256, 256, 3);
+    Handle<Texture> checkerboardTexture = textures.Create();
+    textures.Get(checkerboardTexture)->LoadFromData(checkerboardData, 256, 256, 3);
     
     auto redTextureData = TextureGenerator::GenerateColorTexture(256, 256, 200, 50, 50);
-    Texture* redTexture = new Texture();
-    redTexture->LoadFromData(redTextureData, 256, 256, 3);
+    Handle<Texture> redTexture = textures.Create();
+    textures.Get(redTexture)->LoadFromData(redTextureData, 256, 256, 3);
     
     auto blueTextureData = TextureGenerator::GenerateColorTexture(256, 256, 50, 50, 200);
-    Texture* blueTexture = new Texture();
-    blueTexture->LoadFromData(blueTextureData, 256, 256, 3);
+    Handle<Texture> blueTexture = textures.Create();
+    textures.Get(blueTexture)->LoadFromData(blueTextureData, 256, 256, 3);
     
     // Create materials
-    Material* redMaterial = new Material("RedMaterial");
+    // Pool addresses are stable, so materials keep plain texture pointers
+    Handle<Material> redMaterialHandle = materials.Create("RedMaterial");
+    Material* redMaterial = materials.Get(redMaterialHandle);
     redMaterial->diffuse = glm::vec3(0.8f, 0.2f, 0.2f);
     redMaterial->ambient = glm::vec3(0.1f, 0.05f, 0.05f);
     redMaterial->specular = glm::vec3(1.0f, 1.0f, 1.0f);
     redMaterial->shininess = 32.0f;
-    redMaterial->SetDiffuseTexture(redTexture);
+    redMaterial->SetDiffuseTexture(textures.Get(redTexture));
     
-    Material* blueMaterial = new Material("BlueMaterial");
+    Handle<Material> blueMaterialHandle = materials.Create("BlueMaterial");
+    Material* blueMaterial = materials.Get(blueMaterialHandle);
     blueMaterial->diffuse = glm::vec3(0.2f, 0.2f, 0.8f);
     blueMaterial->ambient = glm::vec3(0.05f, 0.05f, 0.1f);
     blueMaterial->specular = glm::vec3(1.0f, 1.0f, 1.0f);
     blueMaterial->shininess = 64.0f;
-    blueMaterial->SetDiffuseTexture(blueTexture);
+    blueMaterial->SetDiffuseTexture(textures.Get(blueTexture));
 
-    // --- SCENE SETUP (GameObjects) ---
-    std::vector<GameObject*> sceneObjects; // Our list of game objects in the scene
+    // --- SCENE SETUP (Entities) ---
+    // Worker threads for batched engine work (transform updates, ...)
+    JobSystem jobSystem;
+    // All transforms live here in SoA form; entities only keep a handle
+    TransformSystem transformSystem(&jobSystem);
+    engineUI.SetTransformSystem(&transformSystem);
 
-    GameObject* cubeObject1 = new GameObject("MyFirstCube", &cubeMesh);
-    cubeObject1->transform.position = glm::vec3(0.0f, 0.0f, 0.0f);
-    cubeObject1->SetMaterial(redMaterial); // Assign red material to first cube
-    sceneObjects.push_back(cubeObject1);
+    // Per-scene memory: ECS chunks are carved out of this arena and the whole scene is
+    // unloaded with World::Clear() + Arena::Reset() instead of one free per object
+    Arena sceneArena;
 
-    GameObject* cubeObject2 = new GameObject("AnotherCube", &cubeMesh);
-    cubeObject2->transform.position = glm::vec3(2.5f, 0.5f, -1.0f);
-    cubeObject2->transform.rotation = glm::vec3(0.0f, 45.0f, 0.0f);
-    cubeObject2->transform.scale    = glm::vec3(0.75f);
-    cubeObject2->SetMaterial(blueMaterial); // Assign blue material to second cube
-    sceneObjects.push_back(cubeObject2);
+    // Entities and their components, stored per archetype in 16 KB chunks
+    World world(&sceneArena);
 
-    // GameObject* sphereObject = new GameObject("MySphere", &sphereMesh); // If you had a sphere mesh
-    // sphereObject->transform.position = glm::vec3(-2.0f, 0.0f, 0.0f);
-    // sceneObjects.push_back(sphereObject);
+    // Creates a named entity with a transform (optionally parented) and a mesh renderer
+    auto spawnEntity = [&](const char* name, const Transform& local, Handle<Mesh> mesh, Handle<Material> material,
+                           TransformHandle parent = TransformHandle()) {
+        TransformHandle handle = transformSystem.Create(local, parent);
+        Entity entity = world.Spawn(NameComponent(name), TransformComponent{ handle }, MeshRenderer{ mesh, material });
+        transformSystem.SetUserData(handle, entity.ToUint64()); // Lets the hierarchy map transforms back to entities
+        return entity;
+    };
 
-    engineUI.SetSceneObjects(&sceneObjects); // <<< --- PASS THE SCENE TO THE UI ---
+    StressScene::Result stressResult;
+    if (options.stressScene) {
+        // Generated benchmark content; the camera backs off far enough to see all of it
+        stressResult = StressScene::Generate(options.stress, world, transformSystem, meshes, textures, materials);
+        float radius = std::max(stressResult.radius, 5.0f);
+        camera.SetPerspective(45.0f, 0.1f, std::max(100.0f, radius * 4.0f));
+        camera.SetOrbit(camera.GetYaw(), camera.GetPitch(), radius * 1.6f);
+    } else {
+        Transform cube1Transform;
+        cube1Transform.position = glm::vec3(0.0f, 0.0f, 0.0f);
+        Entity cubeEntity1 = spawnEntity("MyFirstCube", cube1Transform, cubeMesh, redMaterialHandle); // Red material on first cube
 
+        Transform cube2Transform;
+        cube2Transform.position = glm::vec3(2.5f, 0.5f, -1.0f);
+        cube2Transform.rotation = glm::vec3(0.0f, 45.0f, 0.0f);
+        cube2Transform.scale    = glm::vec3(0.75f);
+        // Child of the first cube: its transform is relative to MyFirstCube
+        spawnEntity("AnotherCube", cube2Transform, cubeMesh, blueMaterialHandle,
+                    world.Get<TransformComponent>(cubeEntity1)->handle);
+    }
+
+    // spawnEntity("MySphere", sphereTransform, &sphereMesh, someMaterial); // If you had a sphere mesh
+
+    engineUI.SetWorld(&world); // <<< --- PASS THE SCENE TO THE UI ---
+
+    // Per-frame systems. Each declares what it reads/writes so independent ones can share a batch.
+    SystemScheduler scheduler(&jobSystem);
+    // Scene time of the moving stress objects: frame-based in scripted runs, so every run
+    // animates the same poses, and wall-clock time in the editor
+    float sceneTime = 0.0f;
+    if (stressResult.moving > 0) {
+        scheduler.Add("StressMotion", MakeComponentMask<StressMotion>(), MakeComponentMask<TransformComponent>(), [&](World& w) {
+            StressScene::Animate(w, transformSystem, sceneTime);
+        });
+    }
+    scheduler.Add("TransformUpdate", 0, MakeComponentMask<TransformComponent>(), [&](World&) {
+        // Update dirty local matrices (batched, multithreaded) and propagate to children
+        transformSystem.Update();
+    });
+
+    // Scene BVH over world bounds; broad phase for picking
+    SpatialIndex spatialIndex;
+    engineUI.SetSpatialIndex(&spatialIndex);
+    engineUI.SetMeshPool(&meshes);
+    scheduler.Add("SpatialIndexUpdate", MakeComponentMask<TransformComponent, MeshRenderer>(), 0, [&](World& w) {
+        spatialIndex.Update(w, transformSystem, meshes);
+    });
+
+
+    // Draws every entity with a mesh into the bound framebuffer with the given program; returns the draw count.
+    // Shared by the editor loop and headless runs.
+    auto drawScene = [&](Shader& activeShader, const glm::mat4& view, const glm::mat4& projection, Entity hoveredEntity) {
+        bool hasNormalMatrix = activeShader.GetUniformLocation("normalMatrix") != -1;
+        // Object IDs for GPU picking (only shaders that write the ID output have the uniform)
+        bool hasObjectId = activeShader.GetUniformLocation("objectId") != -1;
+        bool hasHighlight = activeShader.GetUniformLocation("highlight") != -1;
+        int drawCount = 0;
+
+        activeShader.Use();
+        activeShader.SetMat4("view", view);
+        activeShader.SetMat4("projection", projection);
+
+        // Check if we're using textured shader (has lighting uniforms)
+        bool useLighting = activeShader.IsValid() && 
+                          (activeShader.GetUniformLocation("light.position") != -1);
+
+        if (useLighting) {
+            // Set lighting uniforms for textured shader
+            activeShader.SetVec3("light.position", glm::vec3(5.0f, 5.0f, 5.0f));
+            activeShader.SetVec3("light.ambient", glm::vec3(0.2f, 0.2f, 0.2f));
+            activeShader.SetVec3("light.diffuse", glm::vec3(0.8f, 0.8f, 0.8f));
+            activeShader.SetVec3("light.specular", glm::vec3(1.0f, 1.0f, 1.0f));
+            activeShader.SetVec3("viewPos", camera.GetCameraPosition());
+
+            // Enable depth testing for proper 3D rendering
+            glEnable(GL_DEPTH_TEST);
+            glDepthFunc(GL_LESS);
+        }
+
+        // --- RENDER ALL ENTITIES WITH A MESH ---
+        world.Each<TransformComponent, MeshRenderer>([&](Entity entity, TransformComponent& transform, MeshRenderer& renderer) {
+            Mesh* mesh = meshes.Get(renderer.mesh);
+            if (!mesh) return;
+
+            if (hasObjectId) activeShader.SetUInt("objectId", entity.index + 1);
+            if (hasHighlight) activeShader.SetFloat("highlight", entity == hoveredEntity ? 0.25f : 0.0f);
+
+            activeShader.SetMat4("model", transformSystem.GetWorldMatrix(transform.handle));
+            if (hasNormalMatrix) {
+                // Cached per object by the TransformSystem instead of a 4x4 inverse per vertex
+                activeShader.SetMat3("normalMatrix", transformSystem.GetNormalMatrix(transform.handle));
+            }
+
+            if (useLighting) {
+                // Draw with material support for textured shader
+                mesh->Draw(&activeShader, materials.Get(renderer.material));
+            } else {
+                // Draw without material for basic shader
+                mesh->Draw();
+            }
+            drawCount++;
+        });
+        return drawCount;
+    };
 
     // --- Variables for Camera Control ---
     static bool isDraggingOrbit = false;
     static bool isDraggingPan = false;
     static ImVec2 lastMousePos = {0, 0};
 
+    // --- Render on demand ---
+    // When nothing the viewport shows has changed (camera, scene, size, editor overlays), the
+    // loop blocks in glfwWaitEventsTimeout and UI frames just recomposite the cached viewport texture.
+    const double kIdleRefreshSeconds = 0.25; // the UI (console, stats) still refreshes a few times per second
+    const int kUiSettleFrames = 3;           // frames ImGui needs to finish reacting to an input event
+    int uiFramesLeft = kUiSettleFrames;
+    bool viewportValid = false;
+    uint64_t renderedCameraVersion = 0;
+    uint64_t renderedWorldVersion = 0;
+    uint64_t renderedViewportVersion = 0;
+    float renderedScale = 1.0f;
+
+    // --- Scripted runs (headless and --benchmark): the same camera path and the same report ---
+    const float pathYaw = camera.GetYaw(), pathPitch = camera.GetPitch(), pathDistance = camera.GetDistance();
+    bool outputReady = true;
+    if (options.WritesReport()) {
+        frameStats.SetHistorySize(options.frames);
+        std::error_code error;
+        std::filesystem::create_directories(options.outputDir, error);
+        if (error) {
+            LOG_ERROR(General, "Falha ao criar o diretorio de saida %s", options.outputDir);
+            outputReady = false;
+        }
+    }
+    const std::filesystem::path outputDir(options.outputDir);
+
+    // Per-frame CSV for regression tooling, and the summary (percentiles, CPU/GPU split, memory)
+    auto writeRunReport = [&](int width, int height) {
+        frameStats.WaitForGpu();
+        GlTrace::NewFrame(); // closes the last frame's call counts
+        if (options.glTrace) GlTrace::WriteReport((outputDir / "gl_report.txt").string());
+
+        Benchmark::RunInfo info;
+        info.scene = options.stressScene ? StressScene::Describe(options.stress) : "default";
+        info.width = width;
+        info.height = height;
+        info.entities = world.GetEntityCount();
+        meshes.Each([&](Handle<Mesh>, Mesh& mesh) {
+            info.meshBytes += mesh.GetVertexCount() * sizeof(Vertex) + mesh.GetIndexCount() * sizeof(unsigned int);
+        });
+        textures.Each([&](Handle<Texture>, Texture& texture) {
+            info.textureBytes += (uint64_t)texture.GetWidth() * texture.GetHeight() * texture.GetChannels();
+        });
+
+        bool csvWritten = frameStats.ExportCsv((outputDir / "timings.csv").string());
+        bool summaryWritten = Benchmark::WriteSummary((outputDir / "summary.txt").string(), frameStats, info);
+        StatSummary frameMs = frameStats.Summarize(FrameMetric::CpuMs);
+        LOG_INFO(General, "Benchmark: media %.3f ms, p50 %.3f, p95 %.3f, p99 %.3f, max %.3f (%s)",
+                 frameMs.average, frameMs.p50, frameMs.p95, frameMs.p99, frameMs.max, (outputDir / "summary.txt").string());
+        return csvWritten && summaryWritten;
+    };
+
+    // --- Headless run: the camera path rendered offscreen, images and timings written to disk ---
+    auto runHeadless = [&]() -> int {
+        if (!outputReady) return 1;
+
+        camera.SetAspect((float)options.width / (float)options.height);
+        LOG_INFO(General, "Headless: %d quadros %dx%d -> %s", options.frames, options.width, options.height, options.outputDir);
+
+        for (int frame = 0; frame < options.frames; ++frame) {
+            PROFILE_FRAME();
+            GlTrace::NewFrame();
+            frameStats.BeginFrame();
+            // The same path every run, so timings are comparable between builds
+            Benchmark::ApplyCameraPath(camera, (float)frame / options.frames, pathYaw, pathPitch, pathDistance);
+            sceneTime = frame / 60.0f;
+            {
+                PROFILE_SCOPE("Sistemas");
+                scheduler.Run(world);
+            }
+
+            PROFILE_SCOPE("Cena");
+            framebuffer.Bind();
+            glEnable(GL_DEPTH_TEST);
+            glClearColor(0.2f, 0.25f, 0.3f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            framebuffer.ClearObjectIds();
+            frameStats.BeginPass(GpuPass::Scene);
+            int drawCount = drawScene(shader.IsValid() ? shader : basicShader, camera.GetViewMatrix(), camera.GetProjectionMatrix(), Entity());
+            frameStats.EndPass(GpuPass::Scene);
+            PROFILE_COUNTER("Draws", drawCount);
+            framebuffer.Unbind();
+
+            if (frame + 1 == options.frames || (options.imageEvery > 0 && frame % options.imageEvery == 0)) {
+                char name[32];
+                std::snprintf(name, sizeof(name), "frame_%05d.qoi", frame);
+                frameCapture.RequestScreenshot((outputDir / name).string());
+                frameCapture.Capture(framebuffer);
+            }
+            frameCapture.Update();
+
+            // Nothing is presented, so wait for the GPU: the frame time then covers all of its work
+            glFinish();
+            frameStats.EndFrame();
+        }
+        frameCapture.Shutdown(); // writes the pending images
+        return writeRunReport(options.width, options.height) ? 0 : 1;
+    };
+    int exitCode = options.headless ? runHeadless() : 0;
+    if (options.benchmark && !outputReady) exitCode = 1;
+    int benchmarkFrame = 0;
+    if (options.benchmark && outputReady) LOG_INFO(General, "Benchmark: %d quadros -> %s", options.frames, options.outputDir);
+
+    // --- Input recording / replay: the editor runs on the logged frame times ---
+    if (!options.recordPath.empty()) {
+        std::string commandLine;
+        for (int i = 0; i < argc; ++i) commandLine += std::string(i ? " " : "") + argv[i];
+        if (!inputRecorder.StartRecording(options.recordPath, engineUI.GetLayoutSettings(), commandLine)) exitCode = 1;
+    } else if (!options.replayPath.empty()) {
+        if (!outputReady || !inputRecorder.StartReplay(options.replayPath)) {
+            exitCode = 1;
+        } else {
+            engineUI.UseLayoutSettings(inputRecorder.GetLayout());
+            frameStats.SetHistorySize(static_cast<size_t>(inputRecorder.GetFrameCount()));
+            Profiler::SetCapturing(true);
+        }
+    }
+    engineUI.SetWaitForGpuPicks(inputRecorder.IsActive()); // picks resolve on the same frame every run
+
     // --- Main Loop ---
-    while (!glfwWindowShouldClose(window)) {
-        glfwPollEvents(); // Process window events
+    while (!options.headless && exitCode == 0 && !glfwWindowShouldClose(window)) {
+        PROFILE_FRAME();
+        GlTrace::NewFrame();
+        // --- Shaders: hot reload of edited files, and compiles finishing on the driver's threads ---
+        bool shadersPending = false;
+        {
+            PROFILE_SCOPE("Shaders");
+            for (const std::string& file : shaderWatcher.TakeChanges()) {
+                for (Shader* program : programs) {
+                    if (!program->UsesFile(file)) continue;
+                    LOG_INFO(Render, "Shader alterado: %s, recompilando", file);
+                    program->Reload();
+                }
+            }
+            for (Shader* program : programs) {
+                if (program->Poll()) viewportValid = false; // new program swapped in (or the old one kept)
+                shadersPending = shadersPending || program->IsPending();
+            }
+        }
+        bool viewportStale = !viewportValid || camera.GetVersion() != renderedCameraVersion ||
+                             world.GetStructureVersion() != renderedWorldVersion ||
+                             engineUI.GetViewportVersion() != renderedViewportVersion ||
+                             transformSystem.GetDirtyCount() > 0;
+        bool busy = !engineUI.IsRenderOnDemand() || viewportStale || uiFramesLeft > 0 || engineUI.HasPendingGpuPicks() ||
+                    frameCapture.IsRecording() || frameCapture.HasPending() || options.benchmark || stressResult.moving > 0 ||
+                    inputRecorder.IsReplaying() || shadersPending;
+        if (busy) {
+            PROFILE_SCOPE("Eventos");
+            glfwPollEvents(); // Process window events
+            if (uiFramesLeft > 0) --uiFramesLeft;
+        } else {
+            // Woken before the timeout means an input/window event arrived: let ImGui settle on it
+            double waitStart = glfwGetTime();
+            glfwWaitEventsTimeout(kIdleRefreshSeconds);
+            if (glfwGetTime() - waitStart < kIdleRefreshSeconds) uiFramesLeft = kUiSettleFrames;
+        }
+        // Replay: the next logged frame's events replace the live ones
+        if (!inputRecorder.NextFrame()) {
+            if (!writeRunReport(framebuffer.GetWidth(), framebuffer.GetHeight())) exitCode = 1;
+            Profiler::SetCapturing(false);
+            if (!Profiler::ExportChromeTrace((outputDir / "trace.json").string())) exitCode = 1;
+            LOG_INFO(General, "Reproducao concluida: %llu quadros -> %s", (unsigned long long)inputRecorder.GetFrame(), options.outputDir);
+            glfwSetWindowShouldClose(window, GLFW_TRUE);
+            break;
+        }
+        engineUI.SetDeltaTimeOverride(inputRecorder.IsActive() ? inputRecorder.GetDeltaTime() : 0.0f);
+        frameStats.BeginFrame();
         engineUI.BeginFrame(); // Start the ImGui frame
 
         // --- Camera Control Logic (Using ImGui state) ---
@@ -157,6 +635,14 @@ int main() {
             } else { isDraggingPan = false; }
         } else { isDraggingOrbit = false; isDraggingPan = false; }
         // --- End Camera Control Logic ---
+        if (options.benchmark) {
+            Benchmark::ApplyCameraPath(camera, (float)benchmarkFrame / options.frames, pathYaw, pathPitch, pathDistance);
+            sceneTime = benchmarkFrame / 60.0f;
+        } else if (inputRecorder.IsActive()) {
+            sceneTime = (float)inputRecorder.GetTime();
+        } else {
+            sceneTime = (float)glfwGetTime();
+        }
 
 
         // --- Framebuffer Resizing ---
@@ -164,103 +650,136 @@ int main() {
         if (viewportSize.x > 0 && viewportSize.y > 0 &&
             ((int)viewportSize.x != framebuffer.GetWidth() || (int)viewportSize.y != framebuffer.GetHeight())) {
             framebuffer.Resize((unsigned int)viewportSize.x, (unsigned int)viewportSize.y);
+            viewportValid = false;
         }
 
-        // --- Render Scene to Framebuffer ---
-        framebuffer.Bind();
-        glEnable(GL_DEPTH_TEST);
-        int fbWidth = framebuffer.GetWidth();
-        int fbHeight = framebuffer.GetHeight();
+        // --- Run scene systems (transform update, ...) ---
+        {
+            PROFILE_SCOPE("Sistemas");
+            scheduler.Run(world);
+        }
 
-        // Calculate matrices for both framebuffer and gizmo rendering
-        glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)fbWidth / (float)fbHeight, 0.1f, 100.0f);
-        glm::mat4 view = camera.GetViewMatrix();
+        // --- Render Scene to Framebuffer (only when its image would change) ---
+        bool renderViewport = !engineUI.IsRenderOnDemand() || options.benchmark || !viewportValid ||
+                              transformSystem.GetLastUpdatedCount() > 0 ||
+                              camera.GetVersion() != renderedCameraVersion ||
+                              world.GetStructureVersion() != renderedWorldVersion ||
+                              engineUI.GetViewportVersion() != renderedViewportVersion;
 
-        if (fbWidth > 0 && fbHeight > 0) {
-            glViewport(0, 0, fbWidth, fbHeight);
-            // Using a more neutral clear color for better visibility of objects
-            glClearColor(0.2f, 0.25f, 0.3f, 1.0f);
-            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        // --- Dynamic resolution: the scene is drawn into a scaled sub-rectangle of the framebuffer ---
+        // (held at full size while recording: a Y4M stream cannot change size)
+        // (and during --benchmark and input recording/replay, whose frames must all cost the same resolution)
+        dynamicResolution.SetEnabled(engineUI.IsDynamicResolutionEnabled() && !frameCapture.IsRecording() &&
+                                     !options.benchmark && !inputRecorder.IsActive());
+        dynamicResolution.SetTargetMs(engineUI.GetDynamicResolutionTargetMs());
+        float renderScale = dynamicResolution.GetScale();
+        // Once the editor goes idle, redraw the last reduced-resolution image once at full size
+        bool refineViewport = engineUI.IsRenderOnDemand() && !renderViewport && renderedScale < 1.0f;
+        if (refineViewport) renderScale = 1.0f;
+        framebuffer.SetRenderSize((unsigned int)(framebuffer.GetWidth() * renderScale + 0.5f),
+                                  (unsigned int)(framebuffer.GetHeight() * renderScale + 0.5f));
+        engineUI.SetRenderScale(renderScale);
 
-            shader.Use();
-            shader.SetMat4("view", view);
-            shader.SetMat4("projection", projection);
-            
-            // Check if we're using textured shader (has lighting uniforms)
-            bool useLighting = shader.IsValid() && 
-                              (shader.GetUniformLocation("light.position") != -1);
-            
-            if (useLighting) {
-                // Set lighting uniforms for textured shader
-                shader.SetVec3("light.position", glm::vec3(5.0f, 5.0f, 5.0f));
-                shader.SetVec3("light.ambient", glm::vec3(0.2f, 0.2f, 0.2f));
-                shader.SetVec3("light.diffuse", glm::vec3(0.8f, 0.8f, 0.8f));
-                shader.SetVec3("light.specular", glm::vec3(1.0f, 1.0f, 1.0f));
-                shader.SetVec3("viewPos", camera.GetCameraPosition());
-                
-                // Enable depth testing for proper 3D rendering
-                glEnable(GL_DEPTH_TEST);
-                glDepthFunc(GL_LESS);
-            }
+        if (renderViewport || refineViewport) {
+            PROFILE_SCOPE("Cena");
+            framebuffer.Bind();
+            glEnable(GL_DEPTH_TEST);
+            int fbWidth = framebuffer.GetRenderWidth();
+            int fbHeight = framebuffer.GetRenderHeight();
 
-            // --- RENDER ALL GAMEOBJECTS ---
-            for (GameObject* obj : sceneObjects) {
-                if (obj && obj->mesh) {
-                    glm::mat4 model = obj->transform.GetModelMatrix();
-                    shader.SetMat4("model", model);
-                    
-                    // Debug: Show what object is selected
-                    GameObject* selectedObj = engineUI.GetSelectedObject();
-                    if (selectedObj) {
-                        std::cout << "Currently selected object: " << selectedObj->name << std::endl;
-                    } else {
-                        std::cout << "No object selected" << std::endl;
-                    }
-                    
-                    if (useLighting) {
-                        // Draw with material support for textured shader
-                        Material* material = obj->GetMaterial();
-                        obj->mesh->Draw(&shader, material);
-                    } else {
-                        // Draw without material for basic shader
-                        obj->mesh->Draw();
-                    }
-                }
+            // Calculate matrices for both framebuffer and gizmo rendering
+            if (fbHeight > 0) camera.SetAspect((float)fbWidth / (float)fbHeight);
+            const glm::mat4& projection = camera.GetProjectionMatrix();
+            const glm::mat4& view = camera.GetViewMatrix();
+
+            if (fbWidth > 0 && fbHeight > 0) {
+                glViewport(0, 0, fbWidth, fbHeight);
+                // Using a more neutral clear color for better visibility of objects
+                glClearColor(0.2f, 0.25f, 0.3f, 1.0f);
+                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                framebuffer.ClearObjectIds();
+
+                // Pick the program for this frame: the normal matrix path or the per-vertex inverse reference
+                Shader& sceneShader = shader.IsValid() ? shader : basicShader;
+                Shader& activeShader = (engineUI.UseLegacyNormalMatrix() && legacyNormalShader.IsValid())
+                                       ? legacyNormalShader : sceneShader;
+                // Object IDs for GPU picking (only shaders that write the ID output have the uniform)
+                engineUI.SetGpuPickingAvailable(activeShader.GetUniformLocation("objectId") != -1);
+                Entity hoveredEntity = engineUI.GetHoveredEntity();
+
+                frameStats.BeginPass(GpuPass::Scene);
+                int drawCount = drawScene(activeShader, view, projection, hoveredEntity);
+                frameStats.EndPass(GpuPass::Scene);
+                PROFILE_COUNTER("Draws", drawCount);
+                engineUI.SetScenePassStats(frameStats.GetLastGpuMs(GpuPass::Scene), drawCount);
+                // The one-off full-size refinement is not a sample of the interactive cost
+                if (!refineViewport) dynamicResolution.Update(frameStats.GetLastGpuMs(GpuPass::Scene));
+
+                // --- Gizmos and debug lines, into the same framebuffer as the scene ---
+                frameStats.BeginPass(GpuPass::Gizmos);
+                engineUI.RenderGizmos(debugDraw);
+                if (gizmoShader.IsValid()) debugDraw.Flush(gizmoShader, view, projection);
+                frameStats.EndPass(GpuPass::Gizmos);
             }
+            debugDraw.Clear(); // nothing queued survives a frame that wasn't drawn
+            framebuffer.Unbind();
+
+            viewportValid = fbWidth > 0 && fbHeight > 0;
+            renderedCameraVersion = camera.GetVersion();
+            renderedWorldVersion = world.GetStructureVersion();
+            renderedViewportVersion = engineUI.GetViewportVersion();
+            renderedScale = renderScale;
+            engineUI.NotifyViewportRendered();
+            uiFramesLeft = kUiSettleFrames; // e.g. the hover pick on the new image
         }
-        framebuffer.Unbind();
 
-        // --- Render gizmos in main OpenGL context (after framebuffer) ---
-        engineUI.RenderGizmos(&shader, view, projection);
+        // --- Capture the viewport (screenshot request or every frame while recording) ---
+        if (viewportValid && frameCapture.IsCaptureRequested()) frameCapture.Capture(framebuffer);
+        frameCapture.Update();
 
         // --- Render ImGui UI ---
-        engineUI.Render();
-        engineUI.EndFrame();
+        {
+            PROFILE_SCOPE("UI");
+            engineUI.Render();
+            frameStats.BeginPass(GpuPass::UI);
+            engineUI.EndFrame();
+            frameStats.EndPass(GpuPass::UI);
+        }
 
         // --- Swap Buffers ---
+        PROFILE_SCOPE("Swap");
         glfwSwapBuffers(window);
+        frameStats.EndFrame();
+
+        if (options.benchmark && ++benchmarkFrame == options.frames) {
+            if (!writeRunReport(framebuffer.GetWidth(), framebuffer.GetHeight())) exitCode = 1;
+            glfwSetWindowShouldClose(window, GLFW_TRUE);
+        }
     }
 
     // --- Cleanup ---
+    inputRecorder.Stop(); // flushes an input recording
+    shaderWatcher.Stop();
+    frameCapture.Shutdown(); // finishes the recording while the context still exists
     engineUI.Shutdown();
 
-    // Clean up dynamically allocated GameObjects
-    for (GameObject* obj : sceneObjects) {
-        delete obj;
-    }
-    sceneObjects.clear();
-    
-    // Clean up dynamically allocated textures and materials
-    delete checkerboardTexture;
-    delete redTexture;
-    delete blueTexture;
-    delete redMaterial;
-    delete blueMaterial;
+    // Unload the scene: components are trivially destructible, so this just drops the chunks
+    world.Clear();
+    sceneArena.Reset();
+
+    // Release GPU assets while the context still exists
+    materials.Clear();
+    textures.Clear();
+    meshes.Clear();
+    debugDraw.Release();
+    frameStats.Release();
+    for (Shader* program : programs) program->Release();
     
-    // Meshes (like cubeMesh), Shader, Framebuffer will be cleaned up by their destructors
-    // as they are stack-allocated in main.
+    // Framebuffer will be cleaned up by its destructor
+    // as it is stack-allocated in main.
 
     glfwDestroyWindow(window);
     glfwTerminate();
-    return 0;
+    Logger::Shutdown();
+    return exitCode;
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "material.h"
 #include "shader.h"
+#include "profiler.h"
 
 Material::Material() : m_Name("Default") {
 }
@@ -25,6 +26,7 @@ void Material::SetNormalTexture(Texture* texture) {
 }
 
 void Material::Bind(Shader* shader) const {
+    PROFILE_SCOPE("Material::Bind");
     if (!shader) return;
 
     // Set material properties with error checking
@@ -3,9 +3,12 @@
 #include "shader.h"
 #include <fstream>
 #include <sstream>
-#include <iostream>
+#include "log.h"
+#include "profiler.h"
+#include "frame_stats.h"
 #include <vector> // Needed for std::vector
 #include <string> // Needed for std::string and std::getline
+#include <utility>
 
 Mesh::~Mesh() {
     // Keep this cleanup code as is
@@ -15,9 +18,10 @@ Mesh::~Mesh() {
 }
 
 bool Mesh::LoadFromOBJ(const std::string& path) {
+    PROFILE_SCOPE("Mesh::LoadFromOBJ");
     std::ifstream file(path);
     if (!file.is_open()) {
-        std::cerr << "Erro ao abrir o arquivo " << path << "\n";
+        LOG_ERROR(Assets, "Erro ao abrir o arquivo %s", path);
         return false;
     }
 
@@ -131,14 +135,29 @@ bool Mesh::LoadFromOBJ(const std::string& path) {
 
     // Check if we loaded any geometry
     if (m_Vertices.empty() || m_Indices.empty()) {
-        std::cerr << "Warning: Mesh data not loaded correctly (Vertices: "
-                  << m_Vertices.size() << ", Indices: " << m_Indices.size() << ") from " << path << std::endl;
+        LOG_WARN(Assets, "Mesh data not loaded correctly (Vertices: %zu, Indices: %zu) from %s",
+                 m_Vertices.size(), m_Indices.size(), path);
         glDeleteVertexArrays(1, &m_VAO); m_VAO = 0;
         glDeleteBuffers(1, &m_VBO); m_VBO = 0;
         glDeleteBuffers(1, &m_EBO); m_EBO = 0;
         return false;
     }
 
+    Upload();
+    LOG_INFO(Assets, "Loaded mesh: %s (Vertices: %zu, Indices: %zu, BVH nodes: %zu)",
+             path, m_Vertices.size(), m_Indices.size(), m_BVH.GetNodeCount());
+    return true;
+}
+
+bool Mesh::LoadFromData(std::vector<Vertex> vertices, std::vector<unsigned int> indices) {
+    if (vertices.empty() || indices.empty() || m_VAO != 0) return false;
+    m_Vertices = std::move(vertices);
+    m_Indices = std::move(indices);
+    Upload();
+    return true;
+}
+
+void Mesh::Upload() {
     // Create VAO, VBO, EBO and upload data
     glGenVertexArrays(1, &m_VAO);
     glGenBuffers(1, &m_VBO);
@@ -151,6 +170,7 @@ bool Mesh::LoadFromOBJ(const std::string& path) {
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_Indices.size() * sizeof(unsigned int), m_Indices.data(), GL_STATIC_DRAW);
+    FrameStats::CountUpload(m_Vertices.size() * sizeof(Vertex) + m_Indices.size() * sizeof(unsigned int));
 
     // Setup vertex attributes
     // Position attribute
@@ -167,9 +187,11 @@ bool Mesh::LoadFromOBJ(const std::string& path) {
 
     glBindVertexArray(0);
     
-    std::cout << "Loaded mesh: " << path << " (Vertices: " << m_Vertices.size() 
-              << ", Indices: " << m_Indices.size() << ")" << std::endl;
-    return true;
+    // Triangle BVH for picking; kept with the mesh so it is built only once
+    std::vector<glm::vec3> bvhPositions;
+    bvhPositions.reserve(m_Vertices.size());
+    for (const Vertex& vertex : m_Vertices) bvhPositions.push_back(vertex.Position);
+    m_BVH.Build(bvhPositions, m_Indices);
 }
 
 void Mesh::Draw() const {
@@ -184,6 +206,8 @@ void Mesh::Draw() const {
     // Use GLsizei cast for size, which is technically more correct for glDrawElements count
     glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(m_Indices.size()), GL_UNSIGNED_INT, 0);
     glBindVertexArray(0);
+    FrameStats::CountStateChange();
+    FrameStats::CountDraw(m_Indices.size() / 3);
 }
 
 void Mesh::Draw(Shader* shader, Material* material) const {
@@ -200,4 +224,6 @@ void Mesh::Draw(Shader* shader, Material* material) const {
     glBindVertexArray(m_VAO);
     glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(m_Indices.size()), GL_UNSIGNED_INT, 0);
     glBindVertexArray(0);
+    FrameStats::CountStateChange();
+    FrameStats::CountDraw(m_Indices.size() / 3);
 }
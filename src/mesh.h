@@ -3,6 +3,7 @@
 #include <glm/glm.hpp>
 #include <string>
 #include <vector>
+#include "bvh.h"
 
 struct Vertex {
     glm::vec3 Position;
@@ -16,14 +17,30 @@ public:
     ~Mesh();
 
     bool LoadFromOBJ(const std::string& path);
+    // Procedural geometry (e.g. StressScene); same upload and BVH as an OBJ
+    bool LoadFromData(std::vector<Vertex> vertices, std::vector<unsigned int> indices);
     void Draw() const;
     void Draw(class Shader* shader, class Material* material) const;
 
+    // Mesh-local bounds and triangle BVH for precise picking (built once at load)
+    const AABB& GetBounds() const { return m_BVH.GetBounds(); }
+    const TriangleBVH& GetBVH() const { return m_BVH; }
+    size_t GetVertexCount() const { return m_Vertices.size(); }
+    size_t GetIndexCount() const { return m_Indices.size(); }
+    // CPU copy of the uploaded geometry
+    const std::vector<Vertex>& GetVertices() const { return m_Vertices; }
+    const std::vector<unsigned int>& GetIndices() const { return m_Indices; }
+
 private:
+    // Creates the VAO/VBO/EBO from m_Vertices/m_Indices and builds the BVH
+    void Upload();
+
     std::vector<Vertex> m_Vertices;
     std::vector<unsigned int> m_Indices;
 
     GLuint m_VAO = 0;
     GLuint m_VBO = 0;
     GLuint m_EBO = 0;
+
+    TriangleBVH m_BVH;
 };
\ No newline at end of file
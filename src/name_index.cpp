@@ -0,0 +1,208 @@
+#include "name_index.h"
+#include "components.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+namespace {
+    char Lower(char c) {
+        return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+
+    uint32_t Trigram(const char* text) {
+        return static_cast<uint32_t>(static_cast<unsigned char>(text[0])) |
+               (static_cast<uint32_t>(static_cast<unsigned char>(text[1])) << 8) |
+               (static_cast<uint32_t>(static_cast<unsigned char>(text[2])) << 16);
+    }
+
+    // Lowercases at most maxLength characters of text into out; returns the length
+    size_t LowerCopy(const char* text, char* out, size_t maxLength) {
+        size_t length = 0;
+        while (text[length] && length < maxLength) {
+            out[length] = Lower(text[length]);
+            ++length;
+        }
+        out[length] = '\0';
+        return length;
+    }
+
+    // Whether the indexed lowercase name equals text once lowercased
+    bool SameName(const char* indexed, const char* text, size_t maxLength) {
+        size_t i = 0;
+        for (; i < maxLength && text[i]; ++i) {
+            if (indexed[i] != Lower(text[i])) return false;
+        }
+        return indexed[i] == '\0';
+    }
+}
+
+void NameIndex::Sync(World& world) {
+    if (world.GetStructureVersion() == m_WorldVersion) return;
+    m_WorldVersion = world.GetStructureVersion();
+
+    if (m_NeedsRescan || m_LogPosition < world.GetChangeLogStart()) {
+        Rescan(world);
+    } else {
+        // Replayed in order, so a destroyed entity is erased before a reuse of its slot is inserted
+        for (uint64_t position = m_LogPosition; position < world.GetChangeLogEnd(); ++position) {
+            SyncEntity(world, world.GetLoggedChange(position));
+        }
+    }
+    m_LogPosition = world.GetChangeLogEnd();
+    m_NeedsRescan = false;
+}
+
+void NameIndex::SyncEntity(World& world, Entity entity) {
+    NameComponent* name = world.Get<NameComponent>(entity); // nullptr once destroyed or unnamed
+    uint32_t slot = entity.index;
+    bool indexed = slot < m_Entries.size() && m_Entries[slot].alive && m_Entries[slot].entity == entity;
+    if (!name) {
+        if (indexed) Erase(slot);
+        return;
+    }
+    if (indexed && SameName(m_Entries[slot].name, name->value, kMaxNameLength)) return;
+    Insert(entity, name->value);
+}
+
+void NameIndex::Rescan(World& world) {
+    ++m_SyncPass;
+
+    world.EachChunk<NameComponent>([&](size_t count, const Entity* entities, NameComponent* names) {
+        for (size_t i = 0; i < count; ++i) {
+            uint32_t slot = entities[i].index;
+            if (slot < m_Entries.size()) {
+                Entry& entry = m_Entries[slot];
+                if (entry.alive && entry.entity == entities[i] && SameName(entry.name, names[i].value, kMaxNameLength)) {
+                    entry.seen = m_SyncPass;
+                    continue;
+                }
+            }
+            Insert(entities[i], names[i].value);
+            m_Entries[slot].seen = m_SyncPass;
+        }
+    });
+
+    // Whatever wasn't visited has been destroyed (or lost its NameComponent)
+    for (uint32_t slot = 0; slot < m_Entries.size(); ++slot) {
+        if (m_Entries[slot].alive && m_Entries[slot].seen != m_SyncPass) Erase(slot);
+    }
+}
+
+void NameIndex::Rename(Entity entity, const char* name) {
+    if (entity.index < m_Entries.size()) {
+        const Entry& entry = m_Entries[entity.index];
+        if (entry.alive && entry.entity == entity && SameName(entry.name, name, kMaxNameLength)) return;
+    }
+    uint32_t seen = entity.index < m_Entries.size() ? m_Entries[entity.index].seen : 0;
+    Insert(entity, name);
+    m_Entries[entity.index].seen = seen;
+}
+
+void NameIndex::Clear() {
+    m_Entries.clear();
+    m_Postings.clear();
+    m_QueryStamp.clear();
+    m_Count = 0;
+    m_LivePostings = 0;
+    m_StalePostings = 0;
+    m_WorldVersion = ~0ull;
+    m_NeedsRescan = true;
+    ++m_Version;
+}
+
+void NameIndex::Insert(Entity entity, const char* name) {
+    uint32_t slot = entity.index;
+    if (slot >= m_Entries.size()) m_Entries.resize(slot + 1);
+    if (m_Entries[slot].alive) Erase(slot);
+
+    Entry& entry = m_Entries[slot];
+    entry.entity = entity;
+    entry.alive = true;
+    entry.length = static_cast<uint32_t>(LowerCopy(name, entry.name, kMaxNameLength));
+    ++m_Count;
+    ++m_Version;
+    AddPostings(slot);
+}
+
+void NameIndex::Erase(uint32_t slot) {
+    Entry& entry = m_Entries[slot];
+    if (!entry.alive) return;
+    entry.alive = false;
+    --m_Count;
+    ++m_Version;
+
+    // Its postings stay behind until the next rebuild
+    size_t postings = entry.length >= 3 ? entry.length - 2 : 0;
+    m_LivePostings -= postings;
+    m_StalePostings += postings;
+    if (m_StalePostings > m_LivePostings + 4096) RebuildPostings();
+}
+
+void NameIndex::AddPostings(uint32_t slot) {
+    const Entry& entry = m_Entries[slot];
+    for (uint32_t i = 0; i + 3 <= entry.length; ++i) {
+        m_Postings[Trigram(entry.name + i)].push_back(slot);
+    }
+    m_LivePostings += entry.length >= 3 ? entry.length - 2 : 0;
+}
+
+void NameIndex::RebuildPostings() {
+    for (auto& posting : m_Postings) posting.second.clear();
+    m_LivePostings = 0;
+    m_StalePostings = 0;
+    for (uint32_t slot = 0; slot < m_Entries.size(); ++slot) {
+        if (m_Entries[slot].alive) AddPostings(slot);
+    }
+    // Drop trigrams nobody uses anymore
+    for (auto it = m_Postings.begin(); it != m_Postings.end();) {
+        if (it->second.empty()) it = m_Postings.erase(it);
+        else ++it;
+    }
+}
+
+bool NameIndex::Matches(const Entry& entry, const char* query, size_t length) const {
+    return entry.alive && entry.length >= length && std::strstr(entry.name, query) != nullptr;
+}
+
+void NameIndex::Find(const char* query, std::vector<Entity>& out) const {
+    char lowered[kMaxNameLength + 1];
+    size_t length = LowerCopy(query, lowered, kMaxNameLength);
+    if (length == 0) return;
+    size_t first = out.size();
+
+    if (length < 3) {
+        for (const Entry& entry : m_Entries) {
+            if (Matches(entry, lowered, length)) out.push_back(entry.entity);
+        }
+        return;
+    }
+
+    // The rarest trigram of the query bounds the candidates
+    const std::vector<uint32_t>* shortest = nullptr;
+    for (size_t i = 0; i + 3 <= length; ++i) {
+        auto it = m_Postings.find(Trigram(lowered + i));
+        if (it == m_Postings.end()) return; // some trigram appears in no name
+        if (!shortest || it->second.size() < shortest->size()) shortest = &it->second;
+    }
+
+    // A slot can be listed more than once (repeated trigram, stale + live entries)
+    if (m_QueryStamp.size() < m_Entries.size()) m_QueryStamp.resize(m_Entries.size(), 0);
+    uint32_t stamp = ++m_QueryCount;
+    for (uint32_t slot : *shortest) {
+        if (m_QueryStamp[slot] == stamp) continue;
+        m_QueryStamp[slot] = stamp;
+        const Entry& entry = m_Entries[slot];
+        if (Matches(entry, lowered, length)) out.push_back(entry.entity);
+    }
+    std::sort(out.begin() + first, out.end(), [](const Entity& a, const Entity& b) { return a.index < b.index; });
+}
+
+void NameIndex::Filter(const char* query, std::vector<Entity>& entities) const {
+    char lowered[kMaxNameLength + 1];
+    size_t length = LowerCopy(query, lowered, kMaxNameLength);
+    entities.erase(std::remove_if(entities.begin(), entities.end(), [&](const Entity& entity) {
+        if (entity.index >= m_Entries.size()) return true;
+        const Entry& entry = m_Entries[entity.index];
+        return entry.entity != entity || !Matches(entry, lowered, length);
+    }), entities.end());
+}
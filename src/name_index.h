@@ -0,0 +1,70 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "ecs.h"
+
+// Case-insensitive substring search over entity names (NameComponent).
+//
+// Every name is broken into trigrams, and each trigram keeps a posting list of the entity
+// slots whose name contains it. A query of three or more characters walks only the shortest
+// posting list among its trigrams and checks each candidate's name, so its cost depends on
+// how rare the query is, not on the number of entities. Shorter queries scan the names.
+//
+// Removing a name doesn't touch the posting lists: stale entries are skipped when queried
+// (the candidate's current name no longer matches) and the lists are rebuilt once stale
+// entries outnumber live ones.
+class NameIndex {
+public:
+    static constexpr size_t kMaxNameLength = 63; // NameComponent::value without the terminator
+
+    // Catches up with the World when its structure changed (entities created or destroyed):
+    // only the entities in the World's change log since the last Sync are looked at, so an
+    // edit costs the same whatever the scene size. The whole World is rescanned the first
+    // time and when the log was dropped before it was read.
+    void Sync(World& world);
+    // In-place edits of a NameComponent don't change the World's structure; report them here
+    void Rename(Entity entity, const char* name);
+    void Clear();
+
+    // Appends the live entities whose name contains query, ordered by entity index
+    void Find(const char* query, std::vector<Entity>& out) const;
+    // Keeps only the entities in 'entities' whose name contains query (refining a previous result)
+    void Filter(const char* query, std::vector<Entity>& entities) const;
+
+    size_t GetCount() const { return m_Count; }
+    // Bumped whenever the indexed names change
+    uint64_t GetVersion() const { return m_Version; }
+
+private:
+    struct Entry {
+        Entity entity;
+        uint32_t length = 0;
+        uint32_t seen = 0; // Sync pass that last found this entity
+        bool alive = false;
+        char name[kMaxNameLength + 1] = {}; // lowercase
+    };
+
+    void Rescan(World& world);
+    void SyncEntity(World& world, Entity entity);
+    void Insert(Entity entity, const char* name);
+    void Erase(uint32_t slot);
+    void AddPostings(uint32_t slot);
+    void RebuildPostings();
+    bool Matches(const Entry& entry, const char* query, size_t length) const;
+
+    std::vector<Entry> m_Entries; // indexed by Entity::index
+    std::unordered_map<uint32_t, std::vector<uint32_t>> m_Postings; // trigram -> slots (may be stale)
+    size_t m_Count = 0;
+    size_t m_LivePostings = 0;
+    size_t m_StalePostings = 0;
+    uint32_t m_SyncPass = 0;
+    uint64_t m_WorldVersion = ~0ull;
+    uint64_t m_LogPosition = 0; // World change log read up to here
+    bool m_NeedsRescan = true;
+    uint64_t m_Version = 0;
+    mutable std::vector<uint32_t> m_QueryStamp; // per slot, dedupes candidates within a query
+    mutable uint32_t m_QueryCount = 0;
+};
@@ -0,0 +1,131 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Generation-checked handle into a Pool<T>. A handle to a destroyed object
+// (or to a slot that has since been reused) simply resolves to nullptr.
+template <typename T>
+struct Handle {
+    static constexpr uint32_t kInvalidIndex = 0xFFFFFFFFu;
+
+    uint32_t index = kInvalidIndex;
+    uint32_t generation = 0;
+
+    bool IsValid() const { return index != kInvalidIndex; }
+    bool operator==(const Handle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const Handle& other) const { return !(*this == other); }
+};
+
+// Typed object pool.
+// Objects live in fixed-size pages, so their addresses stay stable while they are alive
+// (other objects may keep plain pointers, e.g. a Material to its Textures) and iteration
+// walks contiguous memory. Freed slots are reused through a free list and bump the
+// slot's generation so stale handles are detected.
+template <typename T>
+class Pool {
+public:
+    static constexpr uint32_t kPageSize = 256; // objects per page
+
+    Pool() = default;
+    ~Pool() { Clear(); }
+
+    Pool(const Pool&) = delete;
+    Pool& operator=(const Pool&) = delete;
+
+    template <typename... Args>
+    Handle<T> Create(Args&&... args) {
+        uint32_t index;
+        if (!m_FreeIndices.empty()) {
+            index = m_FreeIndices.back();
+            m_FreeIndices.pop_back();
+        } else {
+            index = static_cast<uint32_t>(m_Generations.size());
+            if (index / kPageSize == m_Pages.size()) m_Pages.emplace_back(new Page());
+            m_Generations.push_back(m_GenerationBase);
+            m_Alive.push_back(0);
+        }
+
+        new (Slot(index)) T(std::forward<Args>(args)...);
+        m_Alive[index] = 1;
+        ++m_Count;
+
+        Handle<T> handle;
+        handle.index = index;
+        handle.generation = m_Generations[index];
+        return handle;
+    }
+
+    void Destroy(Handle<T> handle) {
+        if (!IsAlive(handle)) return;
+        Slot(handle.index)->~T();
+        m_Alive[handle.index] = 0;
+        m_GenerationCeiling = std::max(m_GenerationCeiling, ++m_Generations[handle.index]);
+        m_FreeIndices.push_back(handle.index);
+        --m_Count;
+    }
+
+    bool IsAlive(Handle<T> handle) const {
+        return handle.index < m_Generations.size() &&
+               m_Alive[handle.index] &&
+               m_Generations[handle.index] == handle.generation;
+    }
+
+    // nullptr if the handle is stale or invalid
+    T* Get(Handle<T> handle) { return IsAlive(handle) ? Slot(handle.index) : nullptr; }
+    const T* Get(Handle<T> handle) const { return IsAlive(handle) ? Slot(handle.index) : nullptr; }
+
+    size_t GetCount() const { return m_Count; }
+
+    // Calls fn(Handle<T>, T&) for every live object, in slot order
+    template <typename Fn>
+    void Each(Fn&& fn) {
+        for (uint32_t index = 0; index < m_Generations.size(); ++index) {
+            if (!m_Alive[index]) continue;
+            Handle<T> handle;
+            handle.index = index;
+            handle.generation = m_Generations[index];
+            fn(handle, *Slot(index));
+        }
+    }
+
+    // Destroys every object but keeps the pages for reuse. Only objects with destructors
+    // (GL resources) are visited; the slot bookkeeping is dropped as a whole, with slots
+    // created afterwards starting above every generation handed out so far.
+    void Clear() {
+        if (!std::is_trivially_destructible<T>::value) {
+            for (uint32_t index = 0; index < m_Generations.size(); ++index) {
+                if (m_Alive[index]) Slot(index)->~T();
+            }
+        }
+
+        m_Generations.clear();
+        m_Alive.clear();
+        m_FreeIndices.clear();
+        m_GenerationBase = m_GenerationCeiling + 1;
+        m_GenerationCeiling = m_GenerationBase;
+        m_Count = 0;
+    }
+
+private:
+    struct Page {
+        alignas(T) unsigned char storage[sizeof(T) * kPageSize];
+    };
+
+    T* Slot(uint32_t index) const {
+        return reinterpret_cast<T*>(m_Pages[index / kPageSize]->storage) + (index % kPageSize);
+    }
+
+    std::vector<std::unique_ptr<Page>> m_Pages;
+    std::vector<uint32_t> m_Generations;
+    std::vector<uint8_t> m_Alive;
+    std::vector<uint32_t> m_FreeIndices;
+    uint32_t m_GenerationBase = 0;    // generation of slots created from scratch
+    uint32_t m_GenerationCeiling = 0; // highest generation any handle may carry
+    size_t m_Count = 0;
+};
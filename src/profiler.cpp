@@ -0,0 +1,229 @@
+#include "profiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <mutex>
+#include <unordered_set>
+
+namespace {
+    int64_t NowNanoseconds() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void WriteJsonString(FILE* file, const char* text) {
+        std::fputc('"', file);
+        for (const char* c = text ? text : ""; *c; ++c) {
+            if (*c == '"' || *c == '\\') std::fputc('\\', file);
+            if (static_cast<unsigned char>(*c) < 0x20) std::fprintf(file, "\\u%04x", *c);
+            else std::fputc(*c, file);
+        }
+        std::fputc('"', file);
+    }
+}
+
+// Single-producer ring owned by one thread; only NewFrame() (main thread) consumes it
+struct Profiler::ThreadBuffer {
+    ProfileEvent ring[kRingSize];
+    std::atomic<size_t> head{ 0 }; // next write, owner thread
+    std::atomic<size_t> tail{ 0 }; // next read, NewFrame()
+    uint16_t index = 0;
+};
+
+struct Profiler::State {
+    // Thread buffers are never freed: a thread may exit with events still in its ring
+    std::mutex registryMutex;
+    ThreadBuffer* threads[kMaxThreads] = {};
+    std::string threadNames[kMaxThreads];
+    std::atomic<int> threadCount{ 0 };
+
+    std::mutex internMutex;
+    std::unordered_set<std::string> interned; // node-based: element addresses are stable
+
+    // Main thread only
+    std::deque<ProfileFrame> frames;
+    uint64_t frameStart = 0;
+    std::vector<ProfileEvent> capture;
+    std::vector<uint64_t> captureFrames; // frame marker ticks
+
+    // rdtsc calibration against the steady clock
+    uint64_t calibrationTicks = Profiler::Now();
+    int64_t calibrationNanoseconds = NowNanoseconds();
+};
+
+Profiler::State Profiler::s_State;
+std::atomic<bool> Profiler::s_Capturing{ false };
+std::atomic<uint64_t> Profiler::s_Dropped{ 0 };
+#if RAMPAGE_PROFILER_RDTSC
+double Profiler::s_MsPerTick = 1.0 / 3.0e6; // assume 3 GHz until calibrated
+#else
+double Profiler::s_MsPerTick = 1.0e-6;      // ticks are nanoseconds
+#endif
+thread_local uint16_t Profiler::t_Depth = 0;
+
+void Profiler::SetCapturing(bool capturing) {
+    s_Capturing.store(capturing, std::memory_order_relaxed);
+}
+
+Profiler::ThreadBuffer* Profiler::GetThreadBuffer() {
+    static thread_local ThreadBuffer* t_Buffer = nullptr;
+    static thread_local bool t_Registered = false;
+    if (t_Registered) return t_Buffer;
+    t_Registered = true;
+
+    std::lock_guard<std::mutex> lock(s_State.registryMutex);
+    int index = s_State.threadCount.load(std::memory_order_relaxed);
+    if (index >= kMaxThreads) return nullptr;
+    ThreadBuffer* buffer = new ThreadBuffer();
+    buffer->index = static_cast<uint16_t>(index);
+    s_State.threads[index] = buffer;
+    if (s_State.threadNames[index].empty()) s_State.threadNames[index] = "Thread " + std::to_string(index);
+    s_State.threadCount.store(index + 1, std::memory_order_release);
+    t_Buffer = buffer;
+    return buffer;
+}
+
+void Profiler::SetThreadName(const char* name) {
+    ThreadBuffer* buffer = GetThreadBuffer();
+    if (!buffer) return;
+    std::lock_guard<std::mutex> lock(s_State.registryMutex);
+    s_State.threadNames[buffer->index] = name ? name : "";
+}
+
+std::string Profiler::GetThreadName(uint16_t thread) {
+    std::lock_guard<std::mutex> lock(s_State.registryMutex);
+    return thread < kMaxThreads ? s_State.threadNames[thread] : std::string();
+}
+
+const char* Profiler::InternName(const std::string& name) {
+    std::lock_guard<std::mutex> lock(s_State.internMutex);
+    return s_State.interned.insert(name).first->c_str();
+}
+
+void Profiler::Record(const ProfileEvent& event) {
+    ThreadBuffer* buffer = GetThreadBuffer();
+    if (!buffer) {
+        s_Dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    size_t head = buffer->head.load(std::memory_order_relaxed);
+    if (head - buffer->tail.load(std::memory_order_acquire) >= kRingSize) {
+        s_Dropped.fetch_add(1, std::memory_order_relaxed); // NewFrame() hasn't drained for a while
+        return;
+    }
+    ProfileEvent& slot = buffer->ring[head % kRingSize];
+    slot = event;
+    slot.thread = buffer->index;
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+void Profiler::Counter(const char* name, double value) {
+    if (!IsCapturing()) return;
+    ProfileEvent event;
+    event.type = ProfileEvent::Counter;
+    event.name = name;
+    event.start = event.end = Now();
+    event.value = value;
+    Record(event);
+}
+
+void Profiler::Calibrate() {
+#if RAMPAGE_PROFILER_RDTSC
+    uint64_t ticks = Now() - s_State.calibrationTicks;
+    int64_t nanoseconds = NowNanoseconds() - s_State.calibrationNanoseconds;
+    if (nanoseconds > 50000000 && ticks > 0) // 50 ms baseline before trusting the ratio
+        s_MsPerTick = static_cast<double>(nanoseconds) / 1.0e6 / static_cast<double>(ticks);
+#endif
+}
+
+void Profiler::NewFrame() {
+    uint64_t now = Now();
+    Calibrate();
+
+    // Recycle the oldest frame's storage
+    ProfileFrame frame;
+    if (s_State.frames.size() >= kFrameHistory) {
+        frame = std::move(s_State.frames.front());
+        s_State.frames.pop_front();
+        frame.events.clear();
+    }
+    frame.start = s_State.frameStart ? s_State.frameStart : now;
+    frame.end = now;
+    s_State.frameStart = now;
+
+    int threadCount = s_State.threadCount.load(std::memory_order_acquire);
+    for (int i = 0; i < threadCount; ++i) {
+        ThreadBuffer& buffer = *s_State.threads[i];
+        size_t tail = buffer.tail.load(std::memory_order_relaxed);
+        size_t head = buffer.head.load(std::memory_order_acquire);
+        for (size_t position = tail; position != head; ++position) frame.events.push_back(buffer.ring[position % kRingSize]);
+        buffer.tail.store(head, std::memory_order_release);
+    }
+
+    // Events only exist while capturing (or for zones that straddled turning it off)
+    if (!frame.events.empty()) {
+        size_t room = kMaxCaptureEvents - std::min(kMaxCaptureEvents, s_State.capture.size());
+        if (frame.events.size() > room) s_Dropped.fetch_add(frame.events.size() - room, std::memory_order_relaxed);
+        s_State.capture.insert(s_State.capture.end(), frame.events.begin(),
+                               frame.events.begin() + std::min(room, frame.events.size()));
+    }
+    if (IsCapturing()) s_State.captureFrames.push_back(now);
+    // Idle frames (capture off) are not kept so the history keeps the last frames that had data
+    if (!frame.events.empty()) s_State.frames.push_back(std::move(frame));
+}
+
+const std::deque<ProfileFrame>& Profiler::GetFrames() {
+    return s_State.frames;
+}
+
+size_t Profiler::GetCaptureEventCount() {
+    return s_State.capture.size();
+}
+
+void Profiler::ClearCapture() {
+    s_State.capture.clear();
+    s_State.captureFrames.clear();
+    s_Dropped.store(0, std::memory_order_relaxed);
+}
+
+bool Profiler::ExportChromeTrace(const std::string& path) {
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) return false;
+
+    uint64_t base = !s_State.captureFrames.empty() ? s_State.captureFrames.front() : 0;
+    for (const ProfileEvent& event : s_State.capture) base = std::min(base ? base : event.start, event.start);
+    auto micros = [&](uint64_t ticks) { return TicksToMs(ticks - base) * 1000.0; };
+
+    std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+    auto separator = [&]() {
+        if (!first) std::fputs(",\n", file);
+        first = false;
+    };
+
+    int threadCount = s_State.threadCount.load(std::memory_order_acquire);
+    for (int i = 0; i < threadCount; ++i) {
+        separator();
+        std::fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":", i);
+        WriteJsonString(file, GetThreadName(static_cast<uint16_t>(i)).c_str());
+        std::fputs("}}", file);
+    }
+    for (uint64_t frame : s_State.captureFrames) {
+        if (frame < base) continue;
+        separator();
+        std::fprintf(file, "{\"name\":\"Frame\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":0,\"ts\":%.3f}", micros(frame));
+    }
+    for (const ProfileEvent& event : s_State.capture) {
+        separator();
+        std::fputs("{\"name\":", file);
+        WriteJsonString(file, event.name);
+        if (event.type == ProfileEvent::Counter) {
+            std::fprintf(file, ",\"ph\":\"C\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"args\":{\"value\":%.6g}}",
+                         static_cast<int>(event.thread), micros(event.start), event.value);
+        } else {
+            std::fprintf(file, ",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                         static_cast<int>(event.thread), micros(event.start), TicksToMs(event.end - event.start) * 1000.0);
+        }
+    }
+    std::fputs("\n]}\n", file);
+    return std::fclose(file) == 0;
+}
@@ -0,0 +1,151 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define RAMPAGE_PROFILER_RDTSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define RAMPAGE_PROFILER_RDTSC 1
+#else
+#define RAMPAGE_PROFILER_RDTSC 0
+#endif
+
+// CPU profiler.
+//
+// PROFILE_SCOPE("Name") / PROFILE_FUNCTION() time the enclosing scope, PROFILE_COUNTER records
+// a value and PROFILE_FRAME() marks a frame boundary (once per main loop iteration).
+// Zone names must outlive the program (literals, __func__ or Profiler::InternName).
+//
+// Each thread appends finished zones to its own single-producer ring, so recording takes no
+// lock; NewFrame() drains the rings on the main thread into a short frame history (for the
+// editor's flame graph) and, while capturing, into the capture exported as Chrome trace JSON
+// (chrome://tracing, ui.perfetto.dev). Timestamps are rdtsc ticks where available.
+//
+// Nothing is recorded unless capturing is on; then a zone costs one relaxed load. Building with
+// RAMPAGE_PROFILER=0 removes the macros entirely.
+
+#ifndef RAMPAGE_PROFILER
+#define RAMPAGE_PROFILER 1
+#endif
+
+struct ProfileEvent {
+    enum Type : uint8_t { Zone, Counter };
+
+    const char* name = nullptr;
+    uint64_t start = 0; // ticks
+    uint64_t end = 0;   // ticks (== start for counters)
+    double value = 0.0; // counters only
+    uint16_t thread = 0;
+    uint16_t depth = 0; // nesting level on its thread (0 = outermost)
+    Type type = Zone;
+};
+
+// One main loop iteration: the zones that finished between two PROFILE_FRAME() markers
+struct ProfileFrame {
+    uint64_t start = 0;
+    uint64_t end = 0;
+    std::vector<ProfileEvent> events;
+};
+
+class Profiler {
+public:
+    static const size_t kRingSize = 1 << 15;          // events per thread between two frames
+    static const size_t kFrameHistory = 120;          // frames kept for the editor
+    static const size_t kMaxCaptureEvents = 1 << 20;  // events kept for export
+    static const int kMaxThreads = 64;
+
+    static uint64_t Now() {
+#if RAMPAGE_PROFILER_RDTSC
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    static void SetCapturing(bool capturing);
+    static bool IsCapturing() { return s_Capturing.load(std::memory_order_relaxed); }
+
+    // Shown in the flame graph and the trace (call once on each thread that records zones)
+    static void SetThreadName(const char* name);
+    // Stable copy of a runtime string, for zone names that are not literals
+    static const char* InternName(const std::string& name);
+
+    static void Counter(const char* name, double value);
+    // Frame marker: drains every thread's ring. Main thread only, like everything below.
+    static void NewFrame();
+
+    static const std::deque<ProfileFrame>& GetFrames();
+    static std::string GetThreadName(uint16_t thread);
+    static size_t GetCaptureEventCount();
+    static uint64_t GetDroppedCount() { return s_Dropped.load(std::memory_order_relaxed); }
+    static void ClearCapture();
+    // Writes the capture as Chrome trace-event JSON; returns false if the file can't be written
+    static bool ExportChromeTrace(const std::string& path);
+
+    static double TicksToMs(uint64_t ticks) { return static_cast<double>(ticks) * s_MsPerTick; }
+
+private:
+    friend class ProfileZone;
+
+    struct ThreadBuffer;
+    static ThreadBuffer* GetThreadBuffer(); // null once kMaxThreads threads have registered
+    static void Record(const ProfileEvent& event);
+    static void Calibrate();
+
+    struct State; // thread registry, history and capture (profiler.cpp)
+    static State s_State;
+    static std::atomic<bool> s_Capturing;
+    static std::atomic<uint64_t> s_Dropped;
+    static double s_MsPerTick;
+    static thread_local uint16_t t_Depth;
+};
+
+// Times its own lifetime; use through PROFILE_SCOPE
+class ProfileZone {
+public:
+    explicit ProfileZone(const char* name) : m_Name(name) {
+        if (!Profiler::IsCapturing()) return;
+        m_Depth = Profiler::t_Depth++;
+        m_Start = Profiler::Now();
+    }
+    ~ProfileZone() {
+        if (m_Start == 0) return;
+        ProfileEvent event;
+        event.name = m_Name;
+        event.start = m_Start;
+        event.end = Profiler::Now();
+        event.depth = m_Depth;
+        Profiler::Record(event);
+        --Profiler::t_Depth;
+    }
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    const char* m_Name;
+    uint64_t m_Start = 0;
+    uint16_t m_Depth = 0;
+};
+
+#if RAMPAGE_PROFILER
+#define RAMPAGE_PROFILE_CONCAT_INNER(a, b) a##b
+#define RAMPAGE_PROFILE_CONCAT(a, b) RAMPAGE_PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileZone RAMPAGE_PROFILE_CONCAT(profileZone_, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__func__)
+#define PROFILE_COUNTER(name, value) Profiler::Counter(name, static_cast<double>(value))
+#define PROFILE_FRAME() Profiler::NewFrame()
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_FUNCTION() ((void)0)
+#define PROFILE_COUNTER(name, value) ((void)0)
+#define PROFILE_FRAME() ((void)0)
+#endif
@@ -0,0 +1,100 @@
+#pragma once
+#include <algorithm>
+#include <vector>
+#include "ecs.h"
+
+// Set of selected entities kept as an array sorted by entity index, so membership is a
+// binary search and merging a marquee result is a linear pass. The primary entity is
+// the one gizmos and the single-object Inspector fields act on (the last one clicked).
+class Selection {
+public:
+    bool IsEmpty() const { return m_Entities.empty(); }
+    size_t GetCount() const { return m_Entities.size(); }
+    const std::vector<Entity>& GetEntities() const { return m_Entities; }
+    Entity GetPrimary() const { return m_Primary; }
+    // Bumped by every modification (views that cache on the selection compare it)
+    uint64_t GetVersion() const { return m_Version; }
+
+    bool Contains(Entity entity) const {
+        auto it = LowerBound(entity);
+        return it != m_Entities.end() && *it == entity;
+    }
+
+    void Clear() {
+        m_Entities.clear();
+        m_Primary = Entity();
+        ++m_Version;
+    }
+
+    // Replace the selection with a single entity (or nothing if invalid)
+    void Set(Entity entity) {
+        Clear();
+        if (entity.IsValid()) Add(entity);
+    }
+
+    void Add(Entity entity) {
+        auto it = LowerBound(entity);
+        if (it == m_Entities.end() || *it != entity) m_Entities.insert(it, entity);
+        m_Primary = entity;
+        ++m_Version;
+    }
+
+    void Remove(Entity entity) {
+        auto it = LowerBound(entity);
+        if (it != m_Entities.end() && *it == entity) m_Entities.erase(it);
+        if (m_Primary == entity) m_Primary = m_Entities.empty() ? Entity() : m_Entities.back();
+        ++m_Version;
+    }
+
+    void Toggle(Entity entity) {
+        if (Contains(entity)) Remove(entity);
+        else Add(entity);
+    }
+
+    enum class Mode { Replace, Add, Subtract };
+
+    // Merge a batch (e.g. a marquee query result, any order) in one sort + linear pass
+    void Apply(std::vector<Entity> entities, Mode mode) {
+        std::sort(entities.begin(), entities.end(), Less);
+        entities.erase(std::unique(entities.begin(), entities.end()), entities.end());
+
+        std::vector<Entity> merged;
+        merged.reserve(mode == Mode::Subtract ? m_Entities.size() : m_Entities.size() + entities.size());
+        if (mode == Mode::Replace) {
+            merged.swap(entities);
+        } else if (mode == Mode::Add) {
+            std::set_union(m_Entities.begin(), m_Entities.end(), entities.begin(), entities.end(),
+                           std::back_inserter(merged), Less);
+        } else {
+            std::set_difference(m_Entities.begin(), m_Entities.end(), entities.begin(), entities.end(),
+                                std::back_inserter(merged), Less);
+        }
+        m_Entities.swap(merged);
+
+        if (!Contains(m_Primary)) m_Primary = m_Entities.empty() ? Entity() : m_Entities.front();
+        ++m_Version;
+    }
+
+    // Drop entities that no longer exist
+    void Prune(const World& world) {
+        size_t count = m_Entities.size();
+        m_Entities.erase(std::remove_if(m_Entities.begin(), m_Entities.end(),
+                                        [&](Entity e) { return !world.IsAlive(e); }),
+                         m_Entities.end());
+        if (!world.IsAlive(m_Primary)) m_Primary = m_Entities.empty() ? Entity() : m_Entities.front();
+        if (m_Entities.size() != count) ++m_Version;
+    }
+
+private:
+    static bool Less(const Entity& a, const Entity& b) {
+        return a.index != b.index ? a.index < b.index : a.generation < b.generation;
+    }
+
+    std::vector<Entity>::const_iterator LowerBound(Entity entity) const {
+        return std::lower_bound(m_Entities.begin(), m_Entities.end(), entity, Less);
+    }
+
+    std::vector<Entity> m_Entities; // sorted by (index, generation)
+    Entity m_Primary;
+    uint64_t m_Version = 0;
+};
@@ -1,65 +1,163 @@
 #include "shader.h"
 #include <fstream>
 #include <sstream>
-#include <iostream>
 #include <glm/gtc/type_ptr.hpp>
+#include "log.h"
+#include "frame_stats.h"
+#include "shader_cache.h"
 #include "shader.h"
 #include <glad/glad.h> // Para OpenGL
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <cstring>
+
 
 
+namespace {
+    // GL_KHR_parallel_shader_compile is not in the generated loader
+    const GLenum kCompletionStatusKHR = 0x91B1;
+    typedef void (APIENTRYP MaxShaderCompilerThreadsProc)(GLuint count);
+}
+
+bool Shader::s_ParallelCompile = false;
 
-Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath) {
-    const std::string vertexCode = LoadShaderSource(vertexPath.c_str());
-    const std::string fragmentCode = LoadShaderSource(fragmentPath.c_str());
+void Shader::InitParallelCompile(GLADloadproc load) {
+    s_ParallelCompile = false;
+    GLint extensionCount = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+    for (GLint i = 0; i < extensionCount && !s_ParallelCompile; ++i) {
+        const char* name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+        if (name && (std::strcmp(name, "GL_KHR_parallel_shader_compile") == 0 ||
+                     std::strcmp(name, "GL_ARB_parallel_shader_compile") == 0)) {
+            s_ParallelCompile = true;
+        }
+    }
+    if (!s_ParallelCompile) {
+        LOG_INFO(Render, "Compilacao paralela de shaders indisponivel; programas compilam em serie");
+        return;
+    }
+    // Let the driver pick the thread count (0xFFFFFFFF = implementation-defined maximum)
+    MaxShaderCompilerThreadsProc maxThreads = reinterpret_cast<MaxShaderCompilerThreadsProc>(load("glMaxShaderCompilerThreadsKHR"));
+    if (!maxThreads) maxThreads = reinterpret_cast<MaxShaderCompilerThreadsProc>(load("glMaxShaderCompilerThreadsARB"));
+    if (maxThreads) maxThreads(0xFFFFFFFFu);
+    LOG_INFO(Render, "Compilacao paralela de shaders ativa");
+}
+
+Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath, Compile mode)
+    : m_VertexPath(vertexPath), m_FragmentPath(fragmentPath) {
+    if (Submit() && mode == Compile::Blocking) Poll(true);
+}
+
+void Shader::Release() {
+    DiscardPending();
+    if (ID) glDeleteProgram(ID);
+    ID = 0;
+    m_IsValid = false;
+}
+
+bool Shader::Reload() {
+    DiscardPending(); // a newer edit replaces a compile still in flight
+    return Submit();
+}
+
+bool Shader::UsesFile(const std::string& fileName) const {
+    auto endsWith = [&](const std::string& path) {
+        return path.size() >= fileName.size() && path.compare(path.size() - fileName.size(), fileName.size(), fileName) == 0 &&
+               (path.size() == fileName.size() || path[path.size() - fileName.size() - 1] == '/' ||
+                path[path.size() - fileName.size() - 1] == '\\');
+    };
+    return endsWith(m_VertexPath) || endsWith(m_FragmentPath);
+}
+
+bool Shader::Submit() {
+    const std::string vertexCode = LoadShaderSource(m_VertexPath.c_str());
+    const std::string fragmentCode = LoadShaderSource(m_FragmentPath.c_str());
 
     // Check if shader files were loaded successfully
     if (vertexCode.empty() || fragmentCode.empty()) {
-        std::cerr << "Failed to load shader files. Shader compilation aborted." << std::endl;
-        m_IsValid = false;
-        return;
+        LOG_ERROR(Render, "Failed to load shader files. Shader compilation aborted.");
+        return false;
     }
 
+    // Warm start: the linked binary from a previous run, no compilation at all
+    const std::string sources[] = { vertexCode, fragmentCode };
+    m_Pending.cacheKey = ShaderCache::ComputeKey(sources, 2);
+    m_Pending.program = glCreateProgram();
+    if (ShaderCache::Load(m_Pending.program, m_Pending.cacheKey)) {
+        Swap();
+        LOG_INFO(Render, "Shader loaded from cache: %s, %s", m_VertexPath, m_FragmentPath);
+        return true;
+    }
+
+    // No status query between the steps: with parallel compile the driver works on its own
+    // threads until Poll() sees GL_COMPLETION_STATUS_KHR
     const char* vShaderCode = vertexCode.c_str();
     const char* fShaderCode = fragmentCode.c_str();
 
-    // Compile Vertex Shader
-    unsigned int vertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertex, 1, &vShaderCode, nullptr);
-    glCompileShader(vertex);
-    bool vertexSuccess = CheckCompileErrors(vertex, "VERTEX");
-
-    // Compile Fragment Shader
-    unsigned int fragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragment, 1, &fShaderCode, nullptr);
-    glCompileShader(fragment);
-    bool fragmentSuccess = CheckCompileErrors(fragment, "FRAGMENT");
-
-    // Link shaders into program
-    ID = glCreateProgram();
-    glAttachShader(ID, vertex);
-    glAttachShader(ID, fragment);
-    glLinkProgram(ID);
-    bool linkSuccess = CheckCompileErrors(ID, "PROGRAM");
+    m_Pending.vertex = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(m_Pending.vertex, 1, &vShaderCode, nullptr);
+    glCompileShader(m_Pending.vertex);
+
+    m_Pending.fragment = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(m_Pending.fragment, 1, &fShaderCode, nullptr);
+    glCompileShader(m_Pending.fragment);
+
+    // Link shaders into program (a program the cache failed to fill can still be linked from source)
+    if (ShaderCache::IsEnabled()) glProgramParameteri(m_Pending.program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glAttachShader(m_Pending.program, m_Pending.vertex);
+    glAttachShader(m_Pending.program, m_Pending.fragment);
+    glLinkProgram(m_Pending.program);
+    return true;
+}
+
+bool Shader::Poll(bool wait) {
+    if (!IsPending()) return false;
+    if (!wait && s_ParallelCompile) {
+        GLint done = GL_FALSE;
+        glGetProgramiv(m_Pending.program, kCompletionStatusKHR, &done);
+        if (!done) return false;
+    }
+
+    bool vertexSuccess = CheckCompileErrors(m_Pending.vertex, "VERTEX");
+    bool fragmentSuccess = CheckCompileErrors(m_Pending.fragment, "FRAGMENT");
+    bool linkSuccess = CheckCompileErrors(m_Pending.program, "PROGRAM");
 
     // Delete individual shaders after linking
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
-
-    // Set validity based on compilation and linking success
-    m_IsValid = vertexSuccess && fragmentSuccess && linkSuccess;
-    
-    if (m_IsValid) {
-        std::cout << "Shader compiled successfully: " << vertexPath << ", " << fragmentPath << std::endl;
+    glDeleteShader(m_Pending.vertex);
+    glDeleteShader(m_Pending.fragment);
+    m_Pending.vertex = m_Pending.fragment = 0;
+
+    if (vertexSuccess && fragmentSuccess && linkSuccess) {
+        ShaderCache::Store(m_Pending.program, m_Pending.cacheKey);
+        Swap();
+        LOG_INFO(Render, "Shader compiled successfully: %s, %s", m_VertexPath, m_FragmentPath);
     } else {
-        std::cerr << "Shader compilation failed: " << vertexPath << ", " << fragmentPath << std::endl;
+        // A broken edit keeps the program that was running
+        DiscardPending();
+        LOG_ERROR(Render, "Shader compilation failed: %s, %s", m_VertexPath, m_FragmentPath);
     }
+    return true;
+}
+
+// The new program replaces the old one between draws; GL defers deleting a program still in use
+void Shader::Swap() {
+    if (ID) glDeleteProgram(ID);
+    ID = m_Pending.program;
+    m_Pending = PendingProgram();
+    m_IsValid = true;
+}
+
+void Shader::DiscardPending() {
+    if (m_Pending.vertex) glDeleteShader(m_Pending.vertex);
+    if (m_Pending.fragment) glDeleteShader(m_Pending.fragment);
+    if (m_Pending.program) glDeleteProgram(m_Pending.program);
+    m_Pending = PendingProgram();
 }
 
 void Shader::Use() const {
     glUseProgram(ID);
+    FrameStats::CountStateChange();
 }
 
 void Shader::SetMat4(const std::string& name, const glm::mat4& mat) const {
@@ -67,7 +165,16 @@ void Shader::SetMat4(const std::string& name, const glm::mat4& mat) const {
     if (location != -1) {
         glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(mat));
     } else {
-        std::cerr << "Warning: Uniform '" << name << "' not found in shader" << std::endl;
+        LOG_WARN(Render, "Uniform '%s' not found in shader", name);
+    }
+}
+
+void Shader::SetMat3(const std::string& name, const glm::mat3& mat) const {
+    GLint location = glGetUniformLocation(ID, name.c_str());
+    if (location != -1) {
+        glUniformMatrix3fv(location, 1, GL_FALSE, glm::value_ptr(mat));
+    } else {
+        LOG_WARN(Render, "Uniform '%s' not found in shader", name);
     }
 }
 
@@ -76,7 +183,7 @@ void Shader::SetVec3(const std::string& name, const glm::vec3& value) const {
     if (location != -1) {
         glUniform3fv(location, 1, glm::value_ptr(value));
     } else {
-        std::cerr << "Warning: Uniform '" << name << "' not found in shader" << std::endl;
+        LOG_WARN(Render, "Uniform '%s' not found in shader", name);
     }
 }
 
@@ -85,7 +192,7 @@ void Shader::SetFloat(const std::string& name, float value) const {
     if (location != -1) {
         glUniform1f(location, value);
     } else {
-        std::cerr << "Warning: Uniform '" << name << "' not found in shader" << std::endl;
+        LOG_WARN(Render, "Uniform '%s' not found in shader", name);
     }
 }
 
@@ -94,7 +201,16 @@ void Shader::SetInt(const std::string& name, int value) const {
     if (location != -1) {
         glUniform1i(location, value);
     } else {
-        std::cerr << "Warning: Uniform '" << name << "' not found in shader" << std::endl;
+        LOG_WARN(Render, "Uniform '%s' not found in shader", name);
+    }
+}
+
+void Shader::SetUInt(const std::string& name, unsigned int value) const {
+    GLint location = glGetUniformLocation(ID, name.c_str());
+    if (location != -1) {
+        glUniform1ui(location, value);
+    } else {
+        LOG_WARN(Render, "Uniform '%s' not found in shader", name);
     }
 }
 
@@ -103,7 +219,7 @@ void Shader::SetBool(const std::string& name, bool value) const {
     if (location != -1) {
         glUniform1i(location, (int)value);
     } else {
-        std::cerr << "Warning: Uniform '" << name << "' not found in shader" << std::endl;
+        LOG_WARN(Render, "Uniform '%s' not found in shader", name);
     }
 }
 
@@ -117,7 +233,7 @@ std::string Shader::LoadShaderSource(const char* filePath)
     std::stringstream buffer;
 
     if (!file.is_open()) {
-        std::cerr << "Erro ao abrir o shader: " << filePath << std::endl;
+        LOG_ERROR(Render, "Erro ao abrir o shader: %s", filePath);
         return "";
     }
 
@@ -125,6 +241,15 @@ std::string Shader::LoadShaderSource(const char* filePath)
     return buffer.str();
 }
 
+// Driver info logs can be long: log them one line per record so nothing gets truncated
+static void LogInfoLog(const char* infoLog) {
+    std::istringstream lines(infoLog);
+    std::string line;
+    while (std::getline(lines, line)) {
+        if (!line.empty()) LOG_ERROR(Render, "  %s", line);
+    }
+}
+
 bool Shader::CheckCompileErrors(GLuint shader, std::string type) {
     GLint success;
     GLchar infoLog[1024];
@@ -133,14 +258,16 @@ bool Shader::CheckCompileErrors(GLuint shader, std::string type) {
         glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
         if (!success) {
             glGetShaderInfoLog(shader, 1024, NULL, infoLog);
-            std::cerr << "Shader compilation error (" << type << "):\n" << infoLog << std::endl;
+            LOG_ERROR(Render, "Shader compilation error (%s):", type);
+            LogInfoLog(infoLog);
             return false;
         }
     } else {
         glGetProgramiv(shader, GL_LINK_STATUS, &success);
         if (!success) {
             glGetProgramInfoLog(shader, 1024, NULL, infoLog);
-            std::cerr << "Shader program linking error:\n" << infoLog << std::endl;
+            LOG_ERROR(Render, "Shader program linking error:");
+            LogInfoLog(infoLog);
             return false;
         }
     }
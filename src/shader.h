@@ -1,27 +1,73 @@
 #pragma once
+#include <cstdint>
 #include <string>
 #include <glm/glm.hpp>
 #include <glad/glad.h>
 
-
-
-
+// A vertex + fragment program loaded from two files.
+//
+// Compile::Async submits the compile and link without waiting on the driver; Poll() finishes
+// it once GL_KHR_parallel_shader_compile reports completion (or, without the extension, at the
+// first Poll). Until then IsValid() is false and callers draw with a fallback. Reload() compiles
+// the files again in the same way while the current program stays in use; the new program is
+// swapped in by the Poll() that sees it linked, and a failed compile keeps the old one.
 class Shader {
 public:
-    unsigned int ID;
+    enum class Compile : uint8_t { Blocking, Async };
+
+    unsigned int ID = 0;
     bool IsValid() const { return m_IsValid; }
-    
-    Shader(const std::string& vertexPath, const std::string& fragmentPath);
+    bool IsPending() const { return m_Pending.program != 0; }
+
+    Shader(const std::string& vertexPath, const std::string& fragmentPath, Compile mode = Compile::Blocking);
+    ~Shader() { Release(); }
+
+    Shader(const Shader&) = delete;
+    Shader& operator=(const Shader&) = delete;
+
+    // Deletes the program (and one still compiling); call while the context is current
+    void Release();
+
+    // Detects KHR_parallel_shader_compile (after gladLoadGLLoader, with the same loader)
+    static void InitParallelCompile(GLADloadproc load);
+    static bool HasParallelCompile() { return s_ParallelCompile; }
+
+    bool Reload();
+    // Returns true when a pending compile finished in this call (linked or not);
+    // wait blocks until the driver is done instead of asking
+    bool Poll(bool wait = false);
+    // True if fileName (e.g. "textured.frag") is one of this program's files
+    bool UsesFile(const std::string& fileName) const;
+
     void Use() const;
     void SetMat4(const std::string& name, const glm::mat4& matrix) const;
+    void SetMat3(const std::string& name, const glm::mat3& matrix) const;
     void SetVec3(const std::string& name, const glm::vec3& value) const;
     void SetFloat(const std::string& name, float value) const;
     void SetInt(const std::string& name, int value) const;
+    void SetUInt(const std::string& name, unsigned int value) const;
     void SetBool(const std::string& name, bool value) const;
     GLint GetUniformLocation(const std::string& name) const;
 
 private:
+    // Program being compiled, not yet visible through ID
+    struct PendingProgram {
+        GLuint program = 0;
+        GLuint vertex = 0;
+        GLuint fragment = 0;
+        uint64_t cacheKey = 0;
+    };
+
+    bool Submit();
+    void Swap();
+    void DiscardPending();
+
+    static bool s_ParallelCompile;
+
+    std::string m_VertexPath;
+    std::string m_FragmentPath;
+    PendingProgram m_Pending;
     bool m_IsValid = false;
     std::string LoadShaderSource(const char* filePath);
     bool CheckCompileErrors(GLuint shader, std::string type);
-};
\ No newline at end of file
+};
@@ -0,0 +1,163 @@
+#include "shader_cache.h"
+#include "log.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+bool ShaderCache::s_Enabled = false;
+uint64_t ShaderCache::s_DriverHash = 0;
+std::string ShaderCache::s_Directory;
+ShaderCache::Stats ShaderCache::s_Stats;
+
+namespace {
+    const char kMagic[4] = { 'R', 'S', 'H', 'C' };
+    const uint32_t kFormatVersion = 1;
+
+    // Entry header; the binary follows
+    struct EntryHeader {
+        char magic[4];
+        uint32_t version;
+        uint64_t key;
+        uint32_t binaryFormat;
+        uint32_t length;
+    };
+
+    // FNV-1a, with the length mixed in so that ("ab", "c") and ("a", "bc") differ
+    uint64_t Hash(uint64_t hash, const void* data, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    uint64_t HashString(uint64_t hash, const std::string& text) {
+        uint64_t length = text.size();
+        return Hash(Hash(hash, &length, sizeof(length)), text.data(), text.size());
+    }
+
+    std::string GetGlString(GLenum name) {
+        const GLubyte* text = glGetString(name);
+        return text ? reinterpret_cast<const char*>(text) : "";
+    }
+}
+
+void ShaderCache::Init(const std::string& directory) {
+    s_Directory = directory;
+    s_Enabled = false;
+
+    GLint formats = 0;
+    if (glad_glGetProgramBinary && glad_glProgramBinary && glad_glProgramParameteri) {
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    }
+    if (formats <= 0) {
+        LOG_INFO(Render, "Cache de shaders desativado: o driver nao oferece binarios de programa");
+        return;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error) {
+        LOG_WARN(Render, "Cache de shaders desativado: falha ao criar %s", directory);
+        return;
+    }
+
+    uint64_t hash = 14695981039346656037ull;
+    hash = Hash(hash, &kFormatVersion, sizeof(kFormatVersion));
+    hash = HashString(hash, GetGlString(GL_VENDOR));
+    hash = HashString(hash, GetGlString(GL_RENDERER));
+    hash = HashString(hash, GetGlString(GL_VERSION));
+    s_DriverHash = hash;
+    s_Enabled = true;
+}
+
+uint64_t ShaderCache::ComputeKey(const std::string* sources, size_t count) {
+    uint64_t hash = s_DriverHash;
+    for (size_t i = 0; i < count; ++i) hash = HashString(hash, sources[i]);
+    return hash;
+}
+
+std::string ShaderCache::GetEntryPath(uint64_t key) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)key);
+    return (std::filesystem::path(s_Directory) / name).string();
+}
+
+bool ShaderCache::Load(GLuint program, uint64_t key) {
+    if (!s_Enabled) return false;
+
+    std::ifstream file(GetEntryPath(key), std::ios::binary);
+    EntryHeader header = {};
+    if (!file || !file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kFormatVersion ||
+        header.key != key || header.length == 0) {
+        s_Stats.misses++;
+        return false;
+    }
+    std::vector<char> binary(header.length);
+    if (!file.read(binary.data(), binary.size())) {
+        s_Stats.misses++;
+        return false;
+    }
+
+    glProgramBinary(program, header.binaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        LOG_WARN(Render, "Binario de shader rejeitado pelo driver (%s); recompilando", GetEntryPath(key));
+        s_Stats.rejected++;
+        s_Stats.misses++;
+        return false;
+    }
+    s_Stats.hits++;
+    return true;
+}
+
+bool ShaderCache::Store(GLuint program, uint64_t key) {
+    if (!s_Enabled) return false;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return false;
+    std::vector<char> binary(static_cast<size_t>(length));
+    GLenum binaryFormat = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(program, length, &written, &binaryFormat, binary.data());
+    if (written <= 0) return false;
+
+    EntryHeader header = {};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kFormatVersion;
+    header.key = key;
+    header.binaryFormat = binaryFormat;
+    header.length = static_cast<uint32_t>(written);
+
+    // Temporary name unique to this write, renamed over the entry once complete
+    const std::string path = GetEntryPath(key);
+    const std::string temporary = path + "." +
+        std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(binary.data(), written);
+        if (!file.flush()) {
+            file.close();
+            std::remove(temporary.c_str());
+            LOG_WARN(Render, "Falha ao gravar o cache de shader %s", path);
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::remove(temporary.c_str());
+        LOG_WARN(Render, "Falha ao gravar o cache de shader %s", path);
+        return false;
+    }
+    s_Stats.stored++;
+    return true;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <glad/glad.h>
+#include <cstdint>
+#include <string>
+
+// Program binary cache (glGetProgramBinary / glProgramBinary), so warm starts skip shader
+// compilation entirely.
+//
+// Entries are keyed by a 64-bit hash of the shader sources and the driver's vendor, renderer
+// and version strings: a driver update or an edited shader is simply a miss. Each entry is one
+// file in the cache directory, written to a temporary file and renamed into place, so a crash
+// or a second instance never leaves a half-written binary behind. A binary the driver rejects
+// (e.g. a format it no longer accepts) counts as a miss; Shader then compiles from source and
+// overwrites the entry.
+//
+// Init() must run on the GL thread after gladLoadGLLoader; without it, or on drivers without
+// program binary formats, Load() always misses and Store() does nothing.
+class ShaderCache {
+public:
+    struct Stats {
+        uint32_t hits = 0;
+        uint32_t misses = 0;
+        uint32_t rejected = 0; // binaries found but refused by the driver
+        uint32_t stored = 0;
+    };
+
+    static void Init(const std::string& directory = "shader_cache");
+    static bool IsEnabled() { return s_Enabled; }
+
+    // sources: every stage's code (and anything else that changes the program), in a fixed order
+    static uint64_t ComputeKey(const std::string* sources, size_t count);
+
+    // Fills program (created, not linked) from the cached binary; true when it linked
+    static bool Load(GLuint program, uint64_t key);
+    // Saves a linked program (linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT set)
+    static bool Store(GLuint program, uint64_t key);
+
+    static const Stats& GetStats() { return s_Stats; }
+
+private:
+    static std::string GetEntryPath(uint64_t key);
+
+    static bool s_Enabled;
+    static uint64_t s_DriverHash;
+    static std::string s_Directory;
+    static Stats s_Stats;
+};
@@ -0,0 +1,122 @@
+#include "shader_watcher.h"
+#include "log.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <map>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#if !defined(__linux__)
+namespace {
+    // File name -> modification time, for the platforms without per-file events
+    using FileTimes = std::map<std::string, std::filesystem::file_time_type>;
+
+    FileTimes ScanDirectory(const std::string& directory) {
+        FileTimes times;
+        std::error_code error;
+        for (std::filesystem::directory_iterator it(directory, error), end; !error && it != end; it.increment(error)) {
+            std::error_code timeError;
+            auto time = it->last_write_time(timeError);
+            if (!timeError && it->is_regular_file(timeError)) times[it->path().filename().string()] = time;
+        }
+        return times;
+    }
+}
+#endif
+
+bool ShaderWatcher::Start(const std::string& directory) {
+    Stop();
+    m_Directory = directory;
+#if defined(__linux__)
+    m_Fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_Fd < 0 || inotify_add_watch(m_Fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        LOG_WARN(Render, "Recarga de shaders desativada: falha ao observar %s", directory);
+        if (m_Fd >= 0) close(m_Fd);
+        m_Fd = -1;
+        return false;
+    }
+#endif
+    m_Running = true;
+    m_Thread = std::thread(&ShaderWatcher::Run, this);
+    LOG_INFO(Render, "Recarga de shaders: observando %s", directory);
+    return true;
+}
+
+void ShaderWatcher::Stop() {
+    if (!m_Running) return;
+    m_Running = false;
+    m_Thread.join();
+#if defined(__linux__)
+    close(m_Fd);
+    m_Fd = -1;
+#endif
+}
+
+std::vector<std::string> ShaderWatcher::TakeChanges() {
+    std::vector<std::string> changes;
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    changes.swap(m_Changes);
+    return changes;
+}
+
+void ShaderWatcher::AddChange(const std::string& fileName) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (std::find(m_Changes.begin(), m_Changes.end(), fileName) == m_Changes.end()) m_Changes.push_back(fileName);
+}
+
+// Every wait times out after a short while so Stop() is noticed
+void ShaderWatcher::Run() {
+#if defined(__linux__)
+    alignas(inotify_event) char buffer[4096];
+    while (m_Running) {
+        pollfd descriptor = { m_Fd, POLLIN, 0 };
+        if (poll(&descriptor, 1, 100) <= 0) continue;
+        ssize_t length;
+        while ((length = read(m_Fd, buffer, sizeof(buffer))) > 0) {
+            for (char* at = buffer; at < buffer + length;) {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(at);
+                if (event->len > 0) AddChange(event->name);
+                at += sizeof(inotify_event) + event->len;
+            }
+        }
+    }
+#else
+    FileTimes known = ScanDirectory(m_Directory);
+    auto collect = [&] {
+        FileTimes current = ScanDirectory(m_Directory);
+        for (const auto& file : current) {
+            auto previous = known.find(file.first);
+            if (previous == known.end() || previous->second != file.second) AddChange(file.first);
+        }
+        known.swap(current);
+    };
+#if defined(_WIN32)
+    HANDLE notification = FindFirstChangeNotificationA(m_Directory.c_str(), FALSE,
+                                                       FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME);
+    while (m_Running) {
+        if (notification == INVALID_HANDLE_VALUE) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+            collect();
+        } else if (WaitForSingleObject(notification, 100) == WAIT_OBJECT_0) {
+            collect();
+            FindNextChangeNotification(notification);
+        }
+    }
+    if (notification != INVALID_HANDLE_VALUE) FindCloseChangeNotification(notification);
+#else
+    while (m_Running) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        collect();
+    }
+#endif
+#endif
+}
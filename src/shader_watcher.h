@@ -0,0 +1,35 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Watches a shader directory for edits on a background thread, for hot reload.
+//
+// Linux uses inotify (files closed after writing, or renamed into place as editors do on
+// save); Windows a change notification followed by a scan of the modification times;
+// elsewhere the scan runs every half second. The render thread collects the changed file
+// names with TakeChanges() once per frame and reloads the programs that use them, so the
+// watcher itself never touches GL.
+class ShaderWatcher {
+public:
+    ~ShaderWatcher() { Stop(); }
+
+    bool Start(const std::string& directory);
+    void Stop();
+
+    // File names (without the directory) changed since the last call, each once
+    std::vector<std::string> TakeChanges();
+
+private:
+    void Run();
+    void AddChange(const std::string& fileName);
+
+    std::string m_Directory;
+    std::thread m_Thread;
+    std::atomic<bool> m_Running{ false };
+    std::mutex m_Mutex;
+    std::vector<std::string> m_Changes;
+    int m_Fd = -1; // inotify descriptor (Linux)
+};
@@ -0,0 +1,177 @@
+#include "spatial_index.h"
+#include "components.h"
+#include "mesh.h"
+#include "profiler.h"
+#include "transform_system.h"
+#include <limits>
+#include <utility>
+
+namespace {
+    const uint32_t kMaxEntitiesPerLeaf = 2;
+}
+
+void SpatialIndex::Update(World& world, TransformSystem& transforms, Pool<Mesh>& meshes) {
+    PROFILE_SCOPE("SpatialIndex::Update");
+    bool structureChanged = m_NeedsRebuild || world.GetStructureVersion() != m_WorldVersion;
+    if (!structureChanged && transforms.GetLastUpdatedCount() == 0) return;
+
+    bool entitiesChanged = Gather(world, transforms, meshes);
+    if (structureChanged || entitiesChanged) {
+        m_Depth = BuildBvh(m_Bounds, kMaxEntitiesPerLeaf, m_Nodes, m_Order);
+    } else {
+        Refit();
+    }
+
+    m_WorldVersion = world.GetStructureVersion();
+    m_NeedsRebuild = false;
+}
+
+bool SpatialIndex::Gather(World& world, TransformSystem& transforms, Pool<Mesh>& meshes) {
+    size_t item = 0;
+    bool changed = false;
+
+    world.Each<TransformComponent, MeshRenderer>([&](Entity entity, TransformComponent& transform, MeshRenderer& renderer) {
+        const Mesh* mesh = meshes.Get(renderer.mesh);
+        if (!mesh || !transforms.IsAlive(transform.handle)) return;
+
+        AABB bounds = mesh->GetBounds().Transformed(transforms.GetWorldMatrix(transform.handle));
+        if (item < m_Entities.size()) {
+            if (m_Entities[item] != entity) {
+                m_Entities[item] = entity;
+                changed = true;
+            }
+            m_Bounds[item] = bounds;
+        } else {
+            m_Entities.push_back(entity);
+            m_Bounds.push_back(bounds);
+            changed = true;
+        }
+        ++item;
+    });
+
+    if (item != m_Entities.size()) {
+        m_Entities.resize(item);
+        m_Bounds.resize(item);
+        changed = true;
+    }
+    return changed;
+}
+
+void SpatialIndex::Refit() {
+    // Children always follow their parent, so a reverse walk is bottom-up
+    for (size_t i = m_Nodes.size(); i-- > 0;) {
+        BvhNode& node = m_Nodes[i];
+        AABB bounds;
+        if (node.IsLeaf()) {
+            for (uint32_t p = node.first; p < node.first + node.count; ++p) {
+                bounds.Grow(m_Bounds[m_Order[p]]);
+            }
+        } else {
+            bounds.Grow(m_Nodes[node.first].bounds);
+            bounds.Grow(m_Nodes[node.first + 1].bounds);
+        }
+        node.bounds = bounds;
+    }
+}
+
+void SpatialIndex::Raycast(const glm::vec3& origin, const glm::vec3& direction, float tMax, const RayVisitor& visit) const {
+    PROFILE_SCOPE("SpatialIndex::Raycast");
+    if (m_Nodes.empty()) return;
+
+    Ray ray(origin, direction);
+    BvhTraversalStack stack(m_Depth);
+    if (IntersectAABB(ray, m_Nodes[0].bounds, tMax) < tMax) stack.Push(0);
+
+    while (!stack.IsEmpty()) {
+        const BvhNode& node = m_Nodes[stack.Pop()];
+        if (IntersectAABB(ray, node.bounds, tMax) >= tMax) continue; // tMax may have shrunk since the push
+
+        if (node.IsLeaf()) {
+            for (uint32_t p = node.first; p < node.first + node.count; ++p) {
+                uint32_t item = m_Order[p];
+                if (IntersectAABB(ray, m_Bounds[item], tMax) < tMax) {
+                    visit(m_Entities[item], tMax);
+                }
+            }
+            continue;
+        }
+
+        uint32_t a = node.first, b = node.first + 1;
+        float ta = IntersectAABB(ray, m_Nodes[a].bounds, tMax);
+        float tb = IntersectAABB(ray, m_Nodes[b].bounds, tMax);
+        if (ta > tb) { std::swap(ta, tb); std::swap(a, b); }
+        if (tb < tMax) stack.Push(b);
+        if (ta < tMax) stack.Push(a);
+    }
+}
+
+PickResult SpatialIndex::Pick(const glm::vec3& origin, const glm::vec3& direction, World& world,
+                              const TransformSystem& transforms, const Pool<Mesh>& meshes) const {
+    PickResult result;
+    Raycast(origin, direction, std::numeric_limits<float>::max(), [&](Entity entity, float& tMax) {
+        TransformComponent* transform = world.Get<TransformComponent>(entity);
+        MeshRenderer* renderer = world.Get<MeshRenderer>(entity);
+        const Mesh* mesh = renderer ? meshes.Get(renderer->mesh) : nullptr;
+        if (!transform || !mesh) return;
+
+        // The direction is transformed without renormalizing, so the hit t stays a world distance
+        glm::mat4 worldToLocal = glm::inverse(transforms.GetWorldMatrix(transform->handle));
+        glm::vec3 localOrigin = glm::vec3(worldToLocal * glm::vec4(origin, 1.0f));
+        glm::vec3 localDirection = glm::vec3(worldToLocal * glm::vec4(direction, 0.0f));
+
+        RayHit hit;
+        if (mesh->GetBVH().Raycast(localOrigin, localDirection, tMax, hit)) {
+            tMax = hit.t;
+            result.entity = entity;
+            result.triangle = hit.triangle;
+            result.distance = hit.t;
+        }
+    });
+    return result;
+}
+
+void SpatialIndex::QueryFrustum(const Frustum& frustum, std::vector<Entity>& out) const {
+    PROFILE_SCOPE("SpatialIndex::QueryFrustum");
+    if (m_Nodes.empty()) return;
+
+    std::vector<uint32_t> stack;
+    stack.push_back(0);
+    while (!stack.empty()) {
+        const uint32_t nodeIndex = stack.back();
+        stack.pop_back();
+        const BvhNode& node = m_Nodes[nodeIndex];
+
+        Frustum::Containment containment = frustum.Classify(node.bounds);
+        if (containment == Frustum::Containment::Outside) continue;
+        if (containment == Frustum::Containment::Inside) {
+            CollectSubtree(nodeIndex, out);
+            continue;
+        }
+
+        if (node.IsLeaf()) {
+            for (uint32_t p = node.first; p < node.first + node.count; ++p) {
+                uint32_t item = m_Order[p];
+                if (frustum.Classify(m_Bounds[item]) != Frustum::Containment::Outside) {
+                    out.push_back(m_Entities[item]);
+                }
+            }
+        } else {
+            stack.push_back(node.first);
+            stack.push_back(node.first + 1);
+        }
+    }
+}
+
+// Leaves under one node cover a contiguous range of m_Order, found via the
+// leftmost and rightmost leaves
+void SpatialIndex::CollectSubtree(uint32_t nodeIndex, std::vector<Entity>& out) const {
+    uint32_t left = nodeIndex, right = nodeIndex;
+    while (!m_Nodes[left].IsLeaf()) left = m_Nodes[left].first;
+    while (!m_Nodes[right].IsLeaf()) right = m_Nodes[right].first + 1;
+
+    uint32_t begin = m_Nodes[left].first;
+    uint32_t end = m_Nodes[right].first + m_Nodes[right].count;
+    for (uint32_t p = begin; p < end; ++p) {
+        out.push_back(m_Entities[m_Order[p]]);
+    }
+}
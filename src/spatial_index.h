@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "bvh.h"
+#include "ecs.h"
+#include "pool.h"
+
+class TransformSystem;
+class Mesh;
+
+// Result of a precise pick (SpatialIndex::Pick)
+struct PickResult {
+    Entity entity;         // invalid if nothing was hit
+    uint32_t triangle = 0; // triangle index within the entity's mesh
+    float distance = 0.0f; // world-space distance from the ray origin
+};
+
+// Scene broad phase: a BVH over the world-space bounds of every entity that has a
+// TransformComponent and a MeshRenderer (mesh-local bounds transformed by the world matrix).
+//
+// Update() rebuilds the tree (binned SAH) when the World's structure changed, refits it
+// bottom-up when only transforms moved, and returns immediately when neither happened.
+class SpatialIndex {
+public:
+    void Update(World& world, TransformSystem& transforms, Pool<Mesh>& meshes);
+    // Forces a rebuild on the next Update (e.g. after pointing a MeshRenderer at another mesh)
+    void Invalidate() { m_NeedsRebuild = true; }
+
+    // Calls visit for every entity whose bounds the ray enters before tMax, nearer subtrees
+    // first. The visitor may lower tMax (to its exact hit distance) to cull the rest.
+    using RayVisitor = std::function<void(Entity entity, float& tMax)>;
+    void Raycast(const glm::vec3& origin, const glm::vec3& direction, float tMax, const RayVisitor& visit) const;
+
+    // Nearest entity the ray hits, tested against the triangle BVH of each candidate's mesh
+    PickResult Pick(const glm::vec3& origin, const glm::vec3& direction, World& world,
+                    const TransformSystem& transforms, const Pool<Mesh>& meshes) const;
+
+    // Appends every entity whose bounds overlap the frustum. Subtrees entirely inside are
+    // taken whole without testing their entities one by one.
+    void QueryFrustum(const Frustum& frustum, std::vector<Entity>& out) const;
+
+    const AABB& GetEntityBounds(size_t item) const { return m_Bounds[item]; }
+    size_t GetEntityCount() const { return m_Entities.size(); }
+    size_t GetNodeCount() const { return m_Nodes.size(); }
+
+private:
+    // Collects entity ids and world bounds in query order; returns true if the entity list changed
+    bool Gather(World& world, TransformSystem& transforms, Pool<Mesh>& meshes);
+    void Refit();
+    void CollectSubtree(uint32_t nodeIndex, std::vector<Entity>& out) const;
+
+    std::vector<BvhNode> m_Nodes;  // leaves index m_Order
+    std::vector<uint32_t> m_Order; // leaf order -> item
+    std::vector<Entity> m_Entities; // per item
+    std::vector<AABB> m_Bounds;     // per item, world space
+    uint32_t m_Depth = 0;           // of the last build (a refit keeps the shape), sizes the traversal stack
+
+    uint64_t m_WorldVersion = ~0ull;
+    bool m_NeedsRebuild = true;
+};
@@ -0,0 +1,286 @@
+#include "stress_scene.h"
+#include "components.h"
+#include "log.h"
+#include "material.h"
+#include "mesh.h"
+#include "texture.h"
+#include "texture_generator.h"
+#include "transform_system.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+    const float kPi = 3.14159265358979f;
+
+    // SplitMix64: tiny, and the same sequence everywhere
+    struct StressRandom {
+        uint64_t state;
+
+        explicit StressRandom(uint64_t seed) : state(seed) {}
+
+        uint64_t Next() {
+            uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        }
+        float Float() { return static_cast<float>(Next() >> 40) * (1.0f / 16777216.0f); } // [0, 1)
+        float Range(float low, float high) { return low + (high - low) * Float(); }
+        int Int(int low, int high) { return low + static_cast<int>(Next() % static_cast<uint64_t>(high - low + 1)); } // inclusive
+    };
+
+    struct MeshData {
+        std::vector<Vertex> vertices;
+        std::vector<unsigned int> indices;
+
+        void AddVertex(const glm::vec3& position, const glm::vec3& normal, const glm::vec2& uv) {
+            Vertex vertex;
+            vertex.Position = position;
+            vertex.Normal = normal;
+            vertex.TexCoords = uv;
+            vertices.push_back(vertex);
+        }
+        // Two triangles per cell of a (columns + 1) x (rows + 1) vertex grid starting at base
+        void AddGrid(unsigned int base, int columns, int rows) {
+            for (int row = 0; row < rows; ++row) {
+                for (int column = 0; column < columns; ++column) {
+                    unsigned int a = base + row * (columns + 1) + column;
+                    unsigned int b = a + 1;
+                    unsigned int c = a + columns + 1;
+                    unsigned int d = c + 1;
+                    indices.insert(indices.end(), { a, c, b, b, c, d });
+                }
+            }
+        }
+    };
+
+    MeshData MakeBox(const glm::vec3& size) {
+        MeshData mesh;
+        const glm::vec3 normals[6] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+        for (const glm::vec3& normal : normals) {
+            glm::vec3 u = std::abs(normal.y) > 0.5f ? glm::vec3(1, 0, 0) : glm::vec3(0, 1, 0);
+            glm::vec3 v = glm::cross(normal, u);
+            unsigned int base = static_cast<unsigned int>(mesh.vertices.size());
+            for (int j = 0; j <= 1; ++j) {
+                for (int i = 0; i <= 1; ++i) {
+                    glm::vec3 corner = normal * 0.5f + u * (i - 0.5f) + v * (j - 0.5f);
+                    mesh.AddVertex(corner * size, normal, glm::vec2((float)i, (float)j));
+                }
+            }
+            mesh.AddGrid(base, 1, 1);
+        }
+        return mesh;
+    }
+
+    MeshData MakeSphere(int rings, int segments) {
+        MeshData mesh;
+        for (int ring = 0; ring <= rings; ++ring) {
+            float theta = kPi * ring / rings;
+            for (int segment = 0; segment <= segments; ++segment) {
+                float phi = 2.0f * kPi * segment / segments;
+                glm::vec3 normal(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+                mesh.AddVertex(normal * 0.5f, normal, glm::vec2((float)segment / segments, (float)ring / rings));
+            }
+        }
+        mesh.AddGrid(0, segments, rings);
+        return mesh;
+    }
+
+    MeshData MakeCylinder(int segments) {
+        MeshData mesh;
+        for (int side = 0; side <= 1; ++side) {
+            for (int segment = 0; segment <= segments; ++segment) {
+                float phi = 2.0f * kPi * segment / segments;
+                glm::vec3 normal(std::cos(phi), 0.0f, std::sin(phi));
+                mesh.AddVertex(glm::vec3(normal.x * 0.5f, side - 0.5f, normal.z * 0.5f), normal,
+                               glm::vec2((float)segment / segments, (float)side));
+            }
+        }
+        mesh.AddGrid(0, segments, 1);
+
+        // Caps: a center vertex and a ring each
+        for (int side = 0; side <= 1; ++side) {
+            glm::vec3 normal(0.0f, side ? 1.0f : -1.0f, 0.0f);
+            unsigned int center = static_cast<unsigned int>(mesh.vertices.size());
+            mesh.AddVertex(normal * 0.5f, normal, glm::vec2(0.5f));
+            for (int segment = 0; segment < segments; ++segment) {
+                float phi = 2.0f * kPi * segment / segments;
+                mesh.AddVertex(glm::vec3(std::cos(phi) * 0.5f, normal.y * 0.5f, std::sin(phi) * 0.5f), normal,
+                               glm::vec2(0.5f + std::cos(phi) * 0.5f, 0.5f + std::sin(phi) * 0.5f));
+            }
+            for (int segment = 0; segment < segments; ++segment) {
+                unsigned int a = center + 1 + segment;
+                unsigned int b = center + 1 + (segment + 1) % segments;
+                if (side) mesh.indices.insert(mesh.indices.end(), { center, b, a });
+                else mesh.indices.insert(mesh.indices.end(), { center, a, b });
+            }
+        }
+        return mesh;
+    }
+
+    MeshData MakeTorus(int segments, int sides) {
+        const float majorRadius = 0.35f, minorRadius = 0.15f;
+        MeshData mesh;
+        for (int side = 0; side <= sides; ++side) {
+            float v = 2.0f * kPi * side / sides;
+            for (int segment = 0; segment <= segments; ++segment) {
+                float u = 2.0f * kPi * segment / segments;
+                glm::vec3 normal(std::cos(v) * std::cos(u), std::sin(v), std::cos(v) * std::sin(u));
+                glm::vec3 center(std::cos(u) * majorRadius, 0.0f, std::sin(u) * majorRadius);
+                mesh.AddVertex(center + normal * minorRadius, normal, glm::vec2((float)segment / segments, (float)side / sides));
+            }
+        }
+        mesh.AddGrid(0, segments, sides);
+        return mesh;
+    }
+
+    // Shape cycles with the index, tessellation comes from the seed
+    MeshData MakeMesh(int index, StressRandom& random) {
+        switch (index % 4) {
+            case 0: return MakeBox(glm::vec3(random.Range(0.5f, 1.0f), random.Range(0.5f, 1.0f), random.Range(0.5f, 1.0f)));
+            case 1: { int rings = random.Int(6, 32); return MakeSphere(rings, rings * 2); }
+            case 2: return MakeCylinder(random.Int(8, 48));
+            default: return MakeTorus(random.Int(12, 48), random.Int(8, 24));
+        }
+    }
+}
+
+StressScene::Result StressScene::Generate(const StressSceneOptions& options, World& world, TransformSystem& transforms,
+                                          Pool<Mesh>& meshes, Pool<Texture>& textures, Pool<Material>& materials) {
+    StressRandom random(options.seed);
+    Result result;
+
+    std::vector<Handle<Mesh>> meshHandles;
+    size_t triangles = 0;
+    for (int i = 0; i < std::max(options.meshes, 1); ++i) {
+        MeshData data = MakeMesh(i, random);
+        triangles += data.indices.size() / 3;
+        Handle<Mesh> handle = meshes.Create();
+        meshes.Get(handle)->LoadFromData(std::move(data.vertices), std::move(data.indices));
+        meshHandles.push_back(handle);
+    }
+
+    std::vector<Handle<Material>> materialHandles;
+    for (int i = 0; i < std::max(options.materials, 1); ++i) {
+        unsigned char r = (unsigned char)random.Int(40, 230), g = (unsigned char)random.Int(40, 230), b = (unsigned char)random.Int(40, 230);
+        Handle<Texture> texture = textures.Create();
+        textures.Get(texture)->LoadFromData(TextureGenerator::GenerateColorTexture(64, 64, r, g, b), 64, 64, 3);
+
+        char name[32];
+        std::snprintf(name, sizeof(name), "StressMaterial%d", i);
+        Handle<Material> handle = materials.Create(name);
+        Material* material = materials.Get(handle);
+        material->diffuse = glm::vec3(r, g, b) / 255.0f;
+        material->ambient = material->diffuse * 0.1f;
+        material->shininess = random.Range(8.0f, 128.0f);
+        material->SetDiffuseTexture(textures.Get(texture));
+        materialHandles.push_back(handle);
+    }
+
+    // Placement volume grows with the object count so the density stays the same
+    int objects = std::max(options.objects, 0);
+    float halfExtent = std::cbrt((float)std::max(objects, 1)) * options.spacing * 0.5f;
+    int gridSide = std::max(1, (int)std::ceil(std::cbrt((float)objects) - 1e-4f));
+    int clusterCount = std::max(1, objects / 250);
+    float clusterRadius = std::cbrt((float)objects / clusterCount) * options.spacing * 0.5f;
+    std::vector<glm::vec3> clusterCenters;
+    for (int i = 0; i < clusterCount; ++i) {
+        clusterCenters.emplace_back(random.Range(-halfExtent, halfExtent), random.Range(-halfExtent, halfExtent) * 0.5f,
+                                    random.Range(-halfExtent, halfExtent));
+    }
+
+    transforms.Reserve(transforms.GetCount() + objects);
+    for (int i = 0; i < objects; ++i) {
+        glm::vec3 position;
+        switch (options.layout) {
+            case StressLayout::Grid: {
+                glm::vec3 cell((float)(i % gridSide), (float)((i / gridSide) % gridSide), (float)(i / (gridSide * gridSide)));
+                position = (cell - (gridSide - 1) * 0.5f) * options.spacing;
+                break;
+            }
+            case StressLayout::Cluster: {
+                // Sum of three uniforms: roughly normal around the cluster center
+                const glm::vec3& center = clusterCenters[random.Int(0, clusterCount - 1)];
+                glm::vec3 offset;
+                for (int axis = 0; axis < 3; ++axis)
+                    offset[axis] = (random.Range(-1.0f, 1.0f) + random.Range(-1.0f, 1.0f) + random.Range(-1.0f, 1.0f)) / 3.0f;
+                position = center + offset * clusterRadius;
+                break;
+            }
+            default:
+                position = glm::vec3(random.Range(-halfExtent, halfExtent), random.Range(-halfExtent, halfExtent),
+                                     random.Range(-halfExtent, halfExtent));
+                break;
+        }
+
+        Transform local;
+        local.position = position;
+        local.rotation = glm::vec3(random.Range(0.0f, 360.0f), random.Range(0.0f, 360.0f), random.Range(0.0f, 360.0f));
+        local.scale = glm::vec3(random.Range(0.6f, 1.4f));
+        result.radius = std::max(result.radius, glm::length(position) + local.scale.x);
+
+        MeshRenderer renderer{ meshHandles[random.Int(0, (int)meshHandles.size() - 1)],
+                               materialHandles[random.Int(0, (int)materialHandles.size() - 1)] };
+        bool moving = random.Float() < options.movingFraction;
+
+        char name[32];
+        std::snprintf(name, sizeof(name), "Stress%d", i);
+        TransformHandle handle = transforms.Create(local);
+        Entity entity;
+        if (moving) {
+            StressMotion motion;
+            motion.origin = position;
+            motion.baseRotation = local.rotation;
+            motion.spin = glm::vec3(random.Range(-90.0f, 90.0f), random.Range(-90.0f, 90.0f), 0.0f);
+            motion.phase = random.Range(0.0f, 2.0f * kPi);
+            motion.amplitude = random.Range(0.2f, 1.0f) * options.spacing * 0.25f;
+            entity = world.Spawn(NameComponent(name), TransformComponent{ handle }, renderer, motion);
+            result.moving++;
+        } else {
+            entity = world.Spawn(NameComponent(name), TransformComponent{ handle }, renderer);
+        }
+        transforms.SetUserData(handle, entity.ToUint64());
+    }
+
+    LOG_INFO(Scene, "Cena de estresse: %s (%zu triangulos em %d malhas, %d objetos em movimento)",
+             Describe(options).c_str(), triangles, (int)meshHandles.size(), result.moving);
+    return result;
+}
+
+void StressScene::Animate(World& world, TransformSystem& transforms, float timeSeconds) {
+    world.Each<TransformComponent, StressMotion>([&](Entity, TransformComponent& transform, StressMotion& motion) {
+        float bob = std::sin(timeSeconds * 2.0f + motion.phase) * motion.amplitude;
+        transforms.SetPosition(transform.handle, motion.origin + glm::vec3(0.0f, bob, 0.0f));
+        transforms.SetRotation(transform.handle, motion.baseRotation + motion.spin * timeSeconds);
+    });
+}
+
+bool StressScene::ParseLayout(const char* name, StressLayout& layout) {
+    const StressLayout layouts[] = { StressLayout::Grid, StressLayout::Cluster, StressLayout::Random };
+    for (StressLayout candidate : layouts) {
+        if (std::strcmp(name, GetLayoutName(candidate)) == 0) {
+            layout = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* StressScene::GetLayoutName(StressLayout layout) {
+    switch (layout) {
+        case StressLayout::Grid: return "grid";
+        case StressLayout::Cluster: return "cluster";
+        default: return "random";
+    }
+}
+
+std::string StressScene::Describe(const StressSceneOptions& options) {
+    char text[160];
+    std::snprintf(text, sizeof(text), "seed=%u objects=%d meshes=%d materials=%d layout=%s moving=%.2f",
+                  options.seed, options.objects, options.meshes, options.materials, GetLayoutName(options.layout),
+                  options.movingFraction);
+    return text;
+}
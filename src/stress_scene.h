@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <glm/glm.hpp>
+
+#include "ecs.h"
+#include "pool.h"
+
+class Mesh;
+class Texture;
+class Material;
+class TransformSystem;
+
+enum class StressLayout : uint8_t { Grid, Cluster, Random };
+
+struct StressSceneOptions {
+    uint32_t seed = 1;
+    int objects = 1000;
+    int meshes = 8;        // unique procedural meshes (boxes, spheres, cylinders, tori)
+    int materials = 8;     // unique materials, each with its own texture
+    StressLayout layout = StressLayout::Grid;
+    float movingFraction = 0.25f; // share of objects animated by Animate()
+    float spacing = 3.0f;         // average distance between neighbouring objects
+};
+
+// Animation parameters of a moving stress object (see StressScene::Animate)
+struct StressMotion {
+    glm::vec3 origin;
+    glm::vec3 baseRotation;
+    glm::vec3 spin;  // degrees per second
+    float phase;
+    float amplitude; // bob height
+};
+
+// Reproducible benchmark content: the same options (seed included) always give the same
+// meshes, materials, placement and motion with the same build on the same platform.
+// Randomness comes from a local SplitMix64 generator rather than <random> distributions,
+// so the random choices (which mesh, which material, the counts) also match across
+// standard libraries; positions and vertices go through libm (sin, cos, cbrt), whose last
+// bits may differ between platforms, so compare benchmark numbers within one platform.
+class StressScene {
+public:
+    struct Result {
+        float radius = 0.0f; // bounding radius of the content around the origin
+        int moving = 0;
+    };
+
+    static Result Generate(const StressSceneOptions& options, World& world, TransformSystem& transforms,
+                           Pool<Mesh>& meshes, Pool<Texture>& textures, Pool<Material>& materials);
+
+    // Places every StressMotion object for the given scene time. Deterministic in the time,
+    // so benchmarks pass a frame-based time instead of the wall clock.
+    static void Animate(World& world, TransformSystem& transforms, float timeSeconds);
+
+    static bool ParseLayout(const char* name, StressLayout& layout);
+    static const char* GetLayoutName(StressLayout layout);
+    // One line describing the options, for logs and benchmark summaries
+    static std::string Describe(const StressSceneOptions& options);
+};
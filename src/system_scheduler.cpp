@@ -0,0 +1,58 @@
+#include "system_scheduler.h"
+#include "job_system.h"
+#include "profiler.h"
+
+void SystemScheduler::Add(const std::string& name, ComponentMask reads, ComponentMask writes, SystemFn run) {
+    System system;
+    system.name = name;
+    system.profileName = Profiler::InternName(name);
+    system.reads = reads;
+    system.writes = writes;
+    system.run = std::move(run);
+    m_Systems.push_back(std::move(system));
+    m_BatchesDirty = true;
+}
+
+void SystemScheduler::BuildBatches() {
+    m_Batches.clear();
+
+    ComponentMask batchReads = 0;
+    ComponentMask batchWrites = 0;
+    for (size_t i = 0; i < m_Systems.size(); ++i) {
+        const System& system = m_Systems[i];
+        bool conflicts = (system.writes & (batchReads | batchWrites)) != 0 ||
+                         (system.reads & batchWrites) != 0;
+
+        if (m_Batches.empty() || conflicts) {
+            m_Batches.emplace_back();
+            batchReads = 0;
+            batchWrites = 0;
+        }
+        m_Batches.back().push_back(i);
+        batchReads |= system.reads;
+        batchWrites |= system.writes;
+    }
+
+    m_BatchesDirty = false;
+}
+
+void SystemScheduler::Run(World& world) {
+    if (m_BatchesDirty) BuildBatches();
+
+    for (const std::vector<size_t>& batch : m_Batches) {
+        if (batch.size() == 1 || !m_Jobs) {
+            for (size_t index : batch) {
+                PROFILE_SCOPE(m_Systems[index].profileName);
+                m_Systems[index].run(world);
+            }
+            continue;
+        }
+
+        m_Jobs->ParallelFor(batch.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                PROFILE_SCOPE(m_Systems[batch[i]].profileName);
+                m_Systems[batch[i]].run(world);
+            }
+        });
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "ecs.h"
+
+class JobSystem;
+
+// Runs a list of systems once per frame.
+// Each system declares the component types it reads and writes. Systems are taken in
+// registration order and packed into batches; a system joins the current batch only if
+// it doesn't write anything the batch touches and doesn't read anything the batch
+// writes. Systems inside one batch run in parallel on the JobSystem, batches run one
+// after another, so conflicting systems keep their registration order.
+//
+// Systems may use World queries (including ParallelEachChunk) but must not make
+// structural changes (create/destroy entities, add/remove components).
+class SystemScheduler {
+public:
+    using SystemFn = std::function<void(World& world)>;
+
+    struct System {
+        std::string name;
+        const char* profileName = nullptr; // interned copy of name for profiler zones
+        ComponentMask reads = 0;
+        ComponentMask writes = 0;
+        SystemFn run;
+    };
+
+    explicit SystemScheduler(JobSystem* jobs = nullptr) : m_Jobs(jobs) {}
+
+    void Add(const std::string& name, ComponentMask reads, ComponentMask writes, SystemFn run);
+
+    void Run(World& world);
+
+    const std::vector<System>& GetSystems() const { return m_Systems; }
+    size_t GetBatchCount() const { return m_Batches.size(); }
+
+private:
+    void BuildBatches();
+
+    JobSystem* m_Jobs;
+    std::vector<System> m_Systems;
+    std::vector<std::vector<size_t>> m_Batches;
+    bool m_BatchesDirty = true;
+};
@@ -1,5 +1,6 @@
 #include "texture.h"
-#include <iostream>
+#include "log.h"
+#include "frame_stats.h"
 #include <vector>
 
 // Include stb_image for texture loading
@@ -20,7 +21,7 @@ bool Texture::LoadFromFile(const std::string& path) {
     // Load image using stb_image
     unsigned char* data = stbi_load(path.c_str(), &m_Width, &m_Height, &m_Channels, 0);
     if (!data) {
-        std::cerr << "Failed to load texture: " << path << std::endl;
+        LOG_ERROR(Assets, "Failed to load texture: %s", path);
         return false;
     }
 
@@ -37,6 +38,7 @@ bool Texture::LoadFromFile(const std::string& path) {
 
     // Upload texture data
     glTexImage2D(GL_TEXTURE_2D, 0, format, m_Width, m_Height, 0, format, GL_UNSIGNED_BYTE, data);
+    FrameStats::CountUpload(static_cast<uint64_t>(m_Width) * m_Height * m_Channels);
 
     // Generate mipmaps
     glGenerateMipmap(GL_TEXTURE_2D);
@@ -50,7 +52,7 @@ bool Texture::LoadFromFile(const std::string& path) {
     // Free image data
     stbi_image_free(data);
 
-    std::cout << "Loaded texture: " << path << " (" << m_Width << "x" << m_Height << ")" << std::endl;
+    LOG_INFO(Assets, "Loaded texture: %s (%dx%d)", path, m_Width, m_Height);
     return true;
 }
 
@@ -72,6 +74,7 @@ bool Texture::LoadFromData(const std::vector<unsigned char>& data, int width, in
 
     // Upload texture data
     glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data.data());
+    FrameStats::CountUpload(data.size());
 
     // Generate mipmaps
     glGenerateMipmap(GL_TEXTURE_2D);
@@ -82,13 +85,14 @@ bool Texture::LoadFromData(const std::vector<unsigned char>& data, int width, in
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-    std::cout << "Created texture from data (" << width << "x" << height << ")" << std::endl;
+    LOG_DEBUG(Assets, "Created texture from data (%dx%d)", width, height);
     return true;
 }
 
 void Texture::Bind(unsigned int unit) const {
     glActiveTexture(GL_TEXTURE0 + unit);
     glBindTexture(GL_TEXTURE_2D, m_TextureID);
+    FrameStats::CountTextureBind();
 }
 
 void Texture::Unbind() const {
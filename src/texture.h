@@ -26,6 +26,7 @@ public:
     // Get texture dimensions
     int GetWidth() const { return m_Width; }
     int GetHeight() const { return m_Height; }
+    int GetChannels() const { return m_Channels; }
 
 private:
     GLuint m_TextureID = 0;
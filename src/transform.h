@@ -1,12 +1,12 @@
 #pragma once
 
-#include <string>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp> // for glm::translate, rotate, scale
-#include "mesh.h" 
 
 // transform class that points to a mesh and has position, rotation and scale
 // this class is used to transform the mesh in the world space
+// The scene keeps its transforms in TransformSystem (SoA storage); this struct is
+// the value type used to read and write a single transform.
 struct Transform {
     glm::vec3 position = glm::vec3(0.0f);
     glm::vec3 rotation = glm::vec3(0.0f);
@@ -23,23 +23,15 @@ struct Transform {
                 model = glm::scale(model, scale); // Apply scaling
                 return model; 
         }
-};
-
-class GameObject {
-    public: 
-    std::string name;
-    Transform transform;
-
-    Mesh* mesh = nullptr; // Pointer to the mesh object uses 
-    class Material* material = nullptr; // Each GameObject can have its own material
-
-    GameObject(const std::string& name = "GameObject", Mesh* mesh = nullptr)
-        : name(name), mesh(mesh) {}
 
-    // Material management
-    void SetMaterial(class Material* mat) { material = mat; }
-    class Material* GetMaterial() const { return material; }
-
-    // More components will be added later, components such as:
-    // Rigidbody, Collider, Light, Camera, etc. 
-};
\ No newline at end of file
+        // Normal matrix (inverse-transpose of the upper 3x3 of the model matrix).
+        // Computed once per object on the CPU instead of once per vertex in the shader.
+        // With uniform scale s the upper 3x3 is R*s, whose inverse-transpose is R/s,
+        // so we only need to divide by s*s; non-uniform scale falls back to a 3x3 inverse.
+        glm::mat3 GetNormalMatrix(const glm::mat4& model) const {
+            if (scale.x == scale.y && scale.y == scale.z) {
+                return glm::mat3(model) * (1.0f / (scale.x * scale.x));
+            }
+            return glm::transpose(glm::inverse(glm::mat3(model)));
+        }
+};
@@ -0,0 +1,637 @@
+#include "transform_system.h"
+#include "job_system.h"
+#include "profiler.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RAMPAGE_TRANSFORM_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+    const float kDegToRad = 0.017453292519943295f;
+
+    // Builds world (T * Rx * Ry * Rz * S) and normal (R * S^-1) matrices from sines/cosines.
+    // Same result as Transform::GetModelMatrix, expanded in closed form.
+    inline void ComposeScalar(float px, float py, float pz,
+                              float sx, float cx, float sy, float cy, float sz, float cz,
+                              float scx, float scy, float scz,
+                              glm::mat4& world, glm::mat3& normal) {
+        glm::vec3 r0(cy * cz, cx * sz + sx * sy * cz, sx * sz - cx * sy * cz);
+        glm::vec3 r1(-cy * sz, cx * cz - sx * sy * sz, sx * cz + cx * sy * sz);
+        glm::vec3 r2(sy, -sx * cy, cx * cy);
+
+        world[0] = glm::vec4(r0 * scx, 0.0f);
+        world[1] = glm::vec4(r1 * scy, 0.0f);
+        world[2] = glm::vec4(r2 * scz, 0.0f);
+        world[3] = glm::vec4(px, py, pz, 1.0f);
+
+        normal[0] = r0 * (1.0f / scx);
+        normal[1] = r1 * (1.0f / scy);
+        normal[2] = r2 * (1.0f / scz);
+    }
+
+#ifdef RAMPAGE_TRANSFORM_SSE
+    inline __m128 Gather4(const float* base, const uint32_t* idx) {
+        return _mm_set_ps(base[idx[3]], base[idx[2]], base[idx[1]], base[idx[0]]);
+    }
+
+    inline __m128 Select(__m128 mask, __m128 a, __m128 b) {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+
+    // Four-wide sin/cos: reduce to [-pi/4, pi/4] around a multiple of pi/2, evaluate
+    // the Taylor polynomials, then swap/negate by quadrant. Error is ~1e-7 for angles
+    // in the range an editor produces, well below what the matrices need.
+    inline void SinCos4(__m128 x, __m128& outSin, __m128& outCos) {
+        const __m128 twoOverPi = _mm_set1_ps(0.63661977236758134f);
+        __m128i q = _mm_cvtps_epi32(_mm_mul_ps(x, twoOverPi));
+        __m128 qf = _mm_cvtepi32_ps(q);
+
+        // Cody-Waite reduction with pi/2 split in three parts
+        __m128 r = _mm_sub_ps(x, _mm_mul_ps(qf, _mm_set1_ps(1.5703125f)));
+        r = _mm_sub_ps(r, _mm_mul_ps(qf, _mm_set1_ps(4.837512969970703125e-4f)));
+        r = _mm_sub_ps(r, _mm_mul_ps(qf, _mm_set1_ps(7.54978995489188216e-8f)));
+
+        __m128 r2 = _mm_mul_ps(r, r);
+
+        __m128 s = _mm_set1_ps(2.7557319e-6f);
+        s = _mm_add_ps(_mm_mul_ps(s, r2), _mm_set1_ps(-1.9841270e-4f));
+        s = _mm_add_ps(_mm_mul_ps(s, r2), _mm_set1_ps(8.3333333e-3f));
+        s = _mm_add_ps(_mm_mul_ps(s, r2), _mm_set1_ps(-1.6666667e-1f));
+        s = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(s, r2), r), r);
+
+        __m128 c = _mm_set1_ps(2.4801587e-5f);
+        c = _mm_add_ps(_mm_mul_ps(c, r2), _mm_set1_ps(-1.3888889e-3f));
+        c = _mm_add_ps(_mm_mul_ps(c, r2), _mm_set1_ps(4.1666667e-2f));
+        c = _mm_add_ps(_mm_mul_ps(c, r2), _mm_set1_ps(-0.5f));
+        c = _mm_add_ps(_mm_mul_ps(c, r2), _mm_set1_ps(1.0f));
+
+        // Quadrant fix-up: odd quadrants swap sin and cos, bit 1 of q (or q+1) flips the sign
+        const __m128i one = _mm_set1_epi32(1);
+        const __m128i two = _mm_set1_epi32(2);
+        __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, one), one));
+        __m128 sinNeg = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(q, two), 30));
+        __m128 cosNeg = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(q, one), two), 30));
+
+        outSin = _mm_xor_ps(Select(swap, c, s), sinNeg);
+        outCos = _mm_xor_ps(Select(swap, s, c), cosNeg);
+    }
+
+    // Transposes four (x, y, z, w) lanes into four vec4 columns and stores them
+    inline void StoreColumns(__m128 x, __m128 y, __m128 z, __m128 w, float* dst0, float* dst1, float* dst2, float* dst3) {
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+        _mm_storeu_ps(dst0, x);
+        _mm_storeu_ps(dst1, y);
+        _mm_storeu_ps(dst2, z);
+        _mm_storeu_ps(dst3, w);
+    }
+#endif
+}
+
+TransformSystem::TransformSystem(JobSystem* jobs)
+    : m_Jobs(jobs) {
+}
+
+void TransformSystem::Reserve(size_t count) {
+    m_PosX.reserve(count); m_PosY.reserve(count); m_PosZ.reserve(count);
+    m_RotX.reserve(count); m_RotY.reserve(count); m_RotZ.reserve(count);
+    m_ScaleX.reserve(count); m_ScaleY.reserve(count); m_ScaleZ.reserve(count);
+    m_Local.reserve(count);
+    m_LocalNormal.reserve(count);
+    m_World.reserve(count);
+    m_Normal.reserve(count);
+    m_HandleOfSlot.reserve(count);
+    m_ParentSlot.reserve(count);
+    m_FirstChildSlot.reserve(count);
+    m_ChildCount.reserve(count);
+
+    m_Generation.reserve(count);
+    m_Alive.reserve(count);
+    m_Dirty.reserve(count);
+    m_SlotOfHandle.reserve(count);
+    m_ParentHandle.reserve(count);
+    m_FirstChildHandle.reserve(count);
+    m_NextSiblingHandle.reserve(count);
+    m_UserData.reserve(count);
+    m_DirtyList.reserve(count);
+}
+
+// New transforms start as roots. A root with no children can sit in any slot without
+// breaking the breadth-first invariants, so dead slots are reused and new ones appended.
+uint32_t TransformSystem::AllocateSlot(uint32_t handleIndex) {
+    uint32_t slot;
+    if (!m_FreeSlots.empty()) {
+        slot = m_FreeSlots.back();
+        m_FreeSlots.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(m_HandleOfSlot.size());
+        m_PosX.push_back(0.0f); m_PosY.push_back(0.0f); m_PosZ.push_back(0.0f);
+        m_RotX.push_back(0.0f); m_RotY.push_back(0.0f); m_RotZ.push_back(0.0f);
+        m_ScaleX.push_back(1.0f); m_ScaleY.push_back(1.0f); m_ScaleZ.push_back(1.0f);
+        m_Local.push_back(glm::mat4(1.0f));
+        m_LocalNormal.push_back(glm::mat3(1.0f));
+        m_World.push_back(glm::mat4(1.0f));
+        m_Normal.push_back(glm::mat3(1.0f));
+        m_HandleOfSlot.push_back(kNone);
+        m_ParentSlot.push_back(kNone);
+        m_FirstChildSlot.push_back(kNone);
+        m_ChildCount.push_back(0);
+    }
+
+    m_HandleOfSlot[slot] = handleIndex;
+    m_ParentSlot[slot] = kNone;
+    m_FirstChildSlot[slot] = kNone;
+    m_ChildCount[slot] = 0;
+    return slot;
+}
+
+TransformHandle TransformSystem::Create(const Transform& local, TransformHandle parent) {
+    uint32_t index;
+    if (!m_FreeHandles.empty()) {
+        index = m_FreeHandles.back();
+        m_FreeHandles.pop_back();
+    } else {
+        index = static_cast<uint32_t>(m_Generation.size());
+        m_Generation.push_back(0);
+        m_Alive.push_back(0);
+        m_Dirty.push_back(0);
+        m_SlotOfHandle.push_back(kNone);
+        m_ParentHandle.push_back(kNone);
+        m_FirstChildHandle.push_back(kNone);
+        m_NextSiblingHandle.push_back(kNone);
+        m_UserData.push_back(0);
+    }
+
+    m_Alive[index] = 1;
+    m_Dirty[index] = 0;
+    m_ParentHandle[index] = kNone;
+    m_FirstChildHandle[index] = kNone;
+    m_NextSiblingHandle[index] = kNone;
+    m_UserData[index] = 0;
+    m_SlotOfHandle[index] = AllocateSlot(index);
+    ++m_HierarchyVersion;
+
+    TransformHandle handle;
+    handle.index = index;
+    handle.generation = m_Generation[index];
+    SetLocal(handle, local);
+
+    if (IsAlive(parent)) {
+        SetParent(handle, parent);
+    }
+    return handle;
+}
+
+void TransformSystem::Destroy(TransformHandle handle) {
+    if (!IsAlive(handle)) return;
+    uint32_t index = handle.index;
+    ++m_HierarchyVersion;
+
+    // Detach from the parent and turn the children into roots
+    if (m_ParentHandle[index] != kNone) {
+        Unlink(index);
+        m_LayoutDirty = true;
+    }
+    uint32_t child = m_FirstChildHandle[index];
+    while (child != kNone) {
+        uint32_t next = m_NextSiblingHandle[child];
+        m_ParentHandle[child] = kNone;
+        m_NextSiblingHandle[child] = kNone;
+        MarkDirty(child);
+        child = next;
+        m_LayoutDirty = true;
+    }
+    m_FirstChildHandle[index] = kNone;
+
+    uint32_t slot = m_SlotOfHandle[index];
+    m_HandleOfSlot[slot] = kNone;
+    m_FreeSlots.push_back(slot);
+
+    m_SlotOfHandle[index] = kNone;
+    m_Alive[index] = 0;
+    m_Dirty[index] = 0;
+    m_Generation[index]++;
+    m_FreeHandles.push_back(index);
+}
+
+bool TransformSystem::IsAlive(TransformHandle handle) const {
+    return handle.index < m_Generation.size() &&
+           m_Alive[handle.index] &&
+           m_Generation[handle.index] == handle.generation;
+}
+
+Transform TransformSystem::GetLocal(TransformHandle handle) const {
+    Transform local;
+    local.position = GetPosition(handle);
+    local.rotation = GetRotation(handle);
+    local.scale = GetScale(handle);
+    return local;
+}
+
+void TransformSystem::SetLocal(TransformHandle handle, const Transform& local) {
+    SetPosition(handle, local.position);
+    SetRotation(handle, local.rotation);
+    SetScale(handle, local.scale);
+}
+
+glm::vec3 TransformSystem::GetPosition(TransformHandle handle) const {
+    assert(IsAlive(handle));
+    uint32_t i = m_SlotOfHandle[handle.index];
+    return glm::vec3(m_PosX[i], m_PosY[i], m_PosZ[i]);
+}
+
+glm::vec3 TransformSystem::GetRotation(TransformHandle handle) const {
+    assert(IsAlive(handle));
+    uint32_t i = m_SlotOfHandle[handle.index];
+    return glm::vec3(m_RotX[i], m_RotY[i], m_RotZ[i]);
+}
+
+glm::vec3 TransformSystem::GetScale(TransformHandle handle) const {
+    assert(IsAlive(handle));
+    uint32_t i = m_SlotOfHandle[handle.index];
+    return glm::vec3(m_ScaleX[i], m_ScaleY[i], m_ScaleZ[i]);
+}
+
+void TransformSystem::SetPosition(TransformHandle handle, const glm::vec3& position) {
+    assert(IsAlive(handle));
+    uint32_t i = m_SlotOfHandle[handle.index];
+    m_PosX[i] = position.x; m_PosY[i] = position.y; m_PosZ[i] = position.z;
+    MarkDirty(handle.index);
+}
+
+void TransformSystem::SetRotation(TransformHandle handle, const glm::vec3& rotation) {
+    assert(IsAlive(handle));
+    uint32_t i = m_SlotOfHandle[handle.index];
+    m_RotX[i] = rotation.x; m_RotY[i] = rotation.y; m_RotZ[i] = rotation.z;
+    MarkDirty(handle.index);
+}
+
+void TransformSystem::SetScale(TransformHandle handle, const glm::vec3& scale) {
+    assert(IsAlive(handle));
+    uint32_t i = m_SlotOfHandle[handle.index];
+    m_ScaleX[i] = scale.x; m_ScaleY[i] = scale.y; m_ScaleZ[i] = scale.z;
+    MarkDirty(handle.index);
+}
+
+glm::vec3 TransformSystem::GetWorldPosition(TransformHandle handle) const {
+    return glm::vec3(GetWorldMatrix(handle)[3]);
+}
+
+void TransformSystem::SetWorldPosition(TransformHandle handle, const glm::vec3& position) {
+    assert(IsAlive(handle));
+    uint32_t parent = m_ParentHandle[handle.index];
+    if (parent == kNone) {
+        SetPosition(handle, position);
+        return;
+    }
+    const glm::mat4& parentWorld = m_World[m_SlotOfHandle[parent]];
+    SetPosition(handle, glm::vec3(glm::inverse(parentWorld) * glm::vec4(position, 1.0f)));
+}
+
+bool TransformSystem::SetParent(TransformHandle child, TransformHandle parent) {
+    if (!IsAlive(child)) return false;
+
+    uint32_t parentIndex = IsAlive(parent) ? parent.index : kNone;
+    if (parentIndex == child.index) return false;
+    if (parentIndex != kNone && IsDescendantOf(parent, child)) return false;
+    if (m_ParentHandle[child.index] == parentIndex) return true;
+
+    Unlink(child.index);
+    if (parentIndex != kNone) {
+        // Push front: O(1), sibling order is not meaningful
+        m_ParentHandle[child.index] = parentIndex;
+        m_NextSiblingHandle[child.index] = m_FirstChildHandle[parentIndex];
+        m_FirstChildHandle[parentIndex] = child.index;
+    }
+
+    // Roots and children cache different matrices (see UpdateLocalRange), so a
+    // reparented node always goes back through the kernel
+    m_LayoutDirty = true;
+    ++m_HierarchyVersion;
+    MarkDirty(child.index);
+    return true;
+}
+
+TransformHandle TransformSystem::GetParent(TransformHandle handle) const {
+    TransformHandle result;
+    uint32_t parent = m_ParentHandle[handle.index];
+    if (parent != kNone) {
+        result.index = parent;
+        result.generation = m_Generation[parent];
+    }
+    return result;
+}
+
+TransformHandle TransformSystem::GetFirstChild(TransformHandle handle) const {
+    TransformHandle result;
+    uint32_t child = m_FirstChildHandle[handle.index];
+    if (child != kNone) {
+        result.index = child;
+        result.generation = m_Generation[child];
+    }
+    return result;
+}
+
+TransformHandle TransformSystem::GetNextSibling(TransformHandle handle) const {
+    TransformHandle result;
+    uint32_t sibling = m_NextSiblingHandle[handle.index];
+    if (sibling != kNone) {
+        result.index = sibling;
+        result.generation = m_Generation[sibling];
+    }
+    return result;
+}
+
+bool TransformSystem::IsDescendantOf(TransformHandle handle, TransformHandle ancestor) const {
+    if (!IsAlive(handle) || !IsAlive(ancestor)) return false;
+    for (uint32_t p = m_ParentHandle[handle.index]; p != kNone; p = m_ParentHandle[p]) {
+        if (p == ancestor.index) return true;
+    }
+    return false;
+}
+
+void TransformSystem::Unlink(uint32_t handleIndex) {
+    uint32_t parent = m_ParentHandle[handleIndex];
+    if (parent == kNone) return;
+
+    uint32_t* link = &m_FirstChildHandle[parent];
+    while (*link != kNone && *link != handleIndex) {
+        link = &m_NextSiblingHandle[*link];
+    }
+    if (*link == handleIndex) {
+        *link = m_NextSiblingHandle[handleIndex];
+    }
+    m_ParentHandle[handleIndex] = kNone;
+    m_NextSiblingHandle[handleIndex] = kNone;
+}
+
+void TransformSystem::MarkDirty(uint32_t handleIndex) {
+    if (m_Dirty[handleIndex]) return;
+    m_Dirty[handleIndex] = 1;
+    m_DirtyList.push_back(handleIndex);
+}
+
+template <typename T>
+void TransformSystem::Permute(std::vector<T>& data, std::vector<T>& scratch) {
+    scratch.resize(m_NewToOld.size());
+    for (size_t i = 0; i < m_NewToOld.size(); ++i) {
+        scratch[i] = data[m_NewToOld[i]];
+    }
+    data.swap(scratch);
+}
+
+// Re-lays out all slots breadth-first from the handle-side parent/child links.
+// Dead slots are dropped. Every array is permuted through a scratch buffer that is
+// kept between calls, so this does not allocate once the buffers have grown.
+void TransformSystem::RebuildLayout() {
+    m_Order.clear();
+    for (uint32_t slot = 0; slot < static_cast<uint32_t>(m_HandleOfSlot.size()); ++slot) {
+        uint32_t h = m_HandleOfSlot[slot];
+        if (h != kNone && m_ParentHandle[h] == kNone) {
+            m_Order.push_back(h);
+        }
+    }
+    for (size_t head = 0; head < m_Order.size(); ++head) {
+        for (uint32_t c = m_FirstChildHandle[m_Order[head]]; c != kNone; c = m_NextSiblingHandle[c]) {
+            m_Order.push_back(c);
+        }
+    }
+
+    m_NewToOld.resize(m_Order.size());
+    for (size_t i = 0; i < m_Order.size(); ++i) {
+        m_NewToOld[i] = m_SlotOfHandle[m_Order[i]];
+    }
+
+    Permute(m_PosX, m_ScratchFloat); Permute(m_PosY, m_ScratchFloat); Permute(m_PosZ, m_ScratchFloat);
+    Permute(m_RotX, m_ScratchFloat); Permute(m_RotY, m_ScratchFloat); Permute(m_RotZ, m_ScratchFloat);
+    Permute(m_ScaleX, m_ScratchFloat); Permute(m_ScaleY, m_ScratchFloat); Permute(m_ScaleZ, m_ScratchFloat);
+    Permute(m_Local, m_ScratchMat4);
+    Permute(m_World, m_ScratchMat4);
+    Permute(m_LocalNormal, m_ScratchMat3);
+    Permute(m_Normal, m_ScratchMat3);
+
+    // Layout arrays are recomputed rather than permuted
+    size_t count = m_Order.size();
+    m_HandleOfSlot.assign(m_Order.begin(), m_Order.end());
+    m_ParentSlot.resize(count);
+    m_FirstChildSlot.resize(count);
+    m_ChildCount.resize(count);
+    for (uint32_t slot = 0; slot < static_cast<uint32_t>(count); ++slot) {
+        m_SlotOfHandle[m_Order[slot]] = slot;
+    }
+
+    // Roots come first; after them, each node's children were appended (in sibling
+    // order) right after the children of the node before it
+    uint32_t nextChildSlot = 0;
+    while (nextChildSlot < count && m_ParentHandle[m_Order[nextChildSlot]] == kNone) {
+        ++nextChildSlot;
+    }
+    for (uint32_t slot = 0; slot < static_cast<uint32_t>(count); ++slot) {
+        uint32_t h = m_Order[slot];
+        uint32_t parent = m_ParentHandle[h];
+        m_ParentSlot[slot] = parent == kNone ? kNone : m_SlotOfHandle[parent];
+
+        uint32_t childCount = 0;
+        for (uint32_t c = m_FirstChildHandle[h]; c != kNone; c = m_NextSiblingHandle[c]) {
+            ++childCount;
+        }
+        m_FirstChildSlot[slot] = childCount ? nextChildSlot : kNone;
+        m_ChildCount[slot] = childCount;
+        nextChildSlot += childCount;
+    }
+
+    m_FreeSlots.clear();
+    m_LayoutDirty = false;
+}
+
+// Turns the dirty handle list into an ascending slot list
+void TransformSystem::GatherDirtySlots() {
+    m_DirtySlots.clear();
+
+    // For big batches rescanning the slots is cheaper than sorting the list
+    if (m_DirtyList.size() > m_HandleOfSlot.size() / 8) {
+        for (uint32_t slot = 0; slot < static_cast<uint32_t>(m_HandleOfSlot.size()); ++slot) {
+            uint32_t h = m_HandleOfSlot[slot];
+            if (h != kNone && m_Dirty[h]) m_DirtySlots.push_back(slot);
+        }
+    } else {
+        for (uint32_t h : m_DirtyList) {
+            if (m_Alive[h] && m_Dirty[h]) m_DirtySlots.push_back(m_SlotOfHandle[h]);
+        }
+        std::sort(m_DirtySlots.begin(), m_DirtySlots.end());
+        m_DirtySlots.erase(std::unique(m_DirtySlots.begin(), m_DirtySlots.end()), m_DirtySlots.end());
+    }
+}
+
+void TransformSystem::Update() {
+    PROFILE_SCOPE("TransformSystem::Update");
+    if (m_LayoutDirty) {
+        RebuildLayout();
+    }
+
+    m_LastUpdatedCount = 0;
+    if (m_DirtyList.empty()) return;
+
+    GatherDirtySlots();
+
+    // Local matrices: independent per transform, so split across the job system
+    const uint32_t* slots = m_DirtySlots.data();
+    if (m_Jobs) {
+        m_Jobs->ParallelFor(m_DirtySlots.size(), kUpdateChunkSize, [this, slots](size_t begin, size_t end) {
+            UpdateLocalRange(slots + begin, end - begin);
+        });
+    } else {
+        UpdateLocalRange(slots, m_DirtySlots.size());
+    }
+
+    PropagateWorld();
+
+    for (uint32_t h : m_DirtyList) {
+        m_Dirty[h] = 0;
+    }
+    m_DirtyList.clear();
+}
+
+// world = parentWorld * local for every dirty slot and everything below it.
+// Two ascending streams are merged: the dirty slots, and a FIFO of child ranges queued
+// by already-updated nodes. The breadth-first layout keeps both sorted, so parents
+// are always finished before their children and each slot is visited at most once.
+void TransformSystem::PropagateWorld() {
+    m_ChildRanges.clear();
+    size_t dirtyHead = 0;
+    size_t rangeHead = 0;
+    uint32_t rangeCursor = kNone;
+    uint32_t lastSlot = kNone;
+    size_t updated = 0;
+
+    for (;;) {
+        uint32_t fromDirty = dirtyHead < m_DirtySlots.size() ? m_DirtySlots[dirtyHead] : kNone;
+
+        if (rangeCursor == kNone && rangeHead < m_ChildRanges.size()) {
+            rangeCursor = m_ChildRanges[rangeHead];
+        }
+        uint32_t fromRanges = rangeCursor;
+
+        if (fromDirty == kNone && fromRanges == kNone) break;
+
+        uint32_t slot;
+        if (fromRanges == kNone || (fromDirty != kNone && fromDirty <= fromRanges)) {
+            slot = fromDirty;
+            ++dirtyHead;
+        } else {
+            slot = fromRanges;
+            if (++rangeCursor >= m_ChildRanges[rangeHead + 1]) {
+                rangeHead += 2;
+                rangeCursor = kNone;
+            }
+        }
+
+        if (slot == lastSlot) continue; // dirty and also below an updated parent
+        lastSlot = slot;
+
+        // Roots already got their world matrix from the kernel
+        uint32_t parent = m_ParentSlot[slot];
+        if (parent != kNone) {
+            m_World[slot] = m_World[parent] * m_Local[slot];
+            m_Normal[slot] = m_Normal[parent] * m_LocalNormal[slot];
+        }
+        ++updated;
+
+        if (m_ChildCount[slot]) {
+            m_ChildRanges.push_back(m_FirstChildSlot[slot]);
+            m_ChildRanges.push_back(m_FirstChildSlot[slot] + m_ChildCount[slot]);
+        }
+    }
+
+    m_LastUpdatedCount = updated;
+}
+
+// Rebuilds the matrices of the given slots from their TRS values.
+// Roots have nothing to multiply with, so their result goes straight into the world
+// arrays; children get local matrices that PropagateWorld() combines with the parent.
+void TransformSystem::UpdateLocalRange(const uint32_t* slots, size_t count) {
+    size_t n = 0;
+
+#ifdef RAMPAGE_TRANSFORM_SSE
+    const __m128 degToRad = _mm_set1_ps(kDegToRad);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+
+    for (; n + 4 <= count; n += 4) {
+        const uint32_t* idx = slots + n;
+
+        __m128 sx, cx, sy, cy, sz, cz;
+        SinCos4(_mm_mul_ps(Gather4(m_RotX.data(), idx), degToRad), sx, cx);
+        SinCos4(_mm_mul_ps(Gather4(m_RotY.data(), idx), degToRad), sy, cy);
+        SinCos4(_mm_mul_ps(Gather4(m_RotZ.data(), idx), degToRad), sz, cz);
+
+        // Rotation columns (see ComposeScalar)
+        __m128 sxsy = _mm_mul_ps(sx, sy);
+        __m128 cxsy = _mm_mul_ps(cx, sy);
+        __m128 r0x = _mm_mul_ps(cy, cz);
+        __m128 r0y = _mm_add_ps(_mm_mul_ps(cx, sz), _mm_mul_ps(sxsy, cz));
+        __m128 r0z = _mm_sub_ps(_mm_mul_ps(sx, sz), _mm_mul_ps(cxsy, cz));
+        __m128 r1x = _mm_sub_ps(zero, _mm_mul_ps(cy, sz));
+        __m128 r1y = _mm_sub_ps(_mm_mul_ps(cx, cz), _mm_mul_ps(sxsy, sz));
+        __m128 r1z = _mm_add_ps(_mm_mul_ps(sx, cz), _mm_mul_ps(cxsy, sz));
+        __m128 r2x = sy;
+        __m128 r2y = _mm_sub_ps(zero, _mm_mul_ps(sx, cy));
+        __m128 r2z = _mm_mul_ps(cx, cy);
+
+        __m128 scx = Gather4(m_ScaleX.data(), idx);
+        __m128 scy = Gather4(m_ScaleY.data(), idx);
+        __m128 scz = Gather4(m_ScaleZ.data(), idx);
+
+        float* w[4];
+        float* nrm[4];
+        for (int k = 0; k < 4; ++k) {
+            bool root = m_ParentSlot[idx[k]] == kNone;
+            w[k] = root ? &m_World[idx[k]][0][0] : &m_Local[idx[k]][0][0];
+            nrm[k] = root ? &m_Normal[idx[k]][0][0] : &m_LocalNormal[idx[k]][0][0];
+        }
+
+        StoreColumns(_mm_mul_ps(r0x, scx), _mm_mul_ps(r0y, scx), _mm_mul_ps(r0z, scx), zero,
+                     w[0], w[1], w[2], w[3]);
+        StoreColumns(_mm_mul_ps(r1x, scy), _mm_mul_ps(r1y, scy), _mm_mul_ps(r1z, scy), zero,
+                     w[0] + 4, w[1] + 4, w[2] + 4, w[3] + 4);
+        StoreColumns(_mm_mul_ps(r2x, scz), _mm_mul_ps(r2y, scz), _mm_mul_ps(r2z, scz), zero,
+                     w[0] + 8, w[1] + 8, w[2] + 8, w[3] + 8);
+        StoreColumns(Gather4(m_PosX.data(), idx), Gather4(m_PosY.data(), idx), Gather4(m_PosZ.data(), idx), one,
+                     w[0] + 12, w[1] + 12, w[2] + 12, w[3] + 12);
+
+        // Normal matrix = R * S^-1, written column by column (mat3 columns are not 16-byte sized)
+        __m128 invX = _mm_div_ps(one, scx);
+        __m128 invY = _mm_div_ps(one, scy);
+        __m128 invZ = _mm_div_ps(one, scz);
+        alignas(16) float nm[9][4];
+        _mm_store_ps(nm[0], _mm_mul_ps(r0x, invX));
+        _mm_store_ps(nm[1], _mm_mul_ps(r0y, invX));
+        _mm_store_ps(nm[2], _mm_mul_ps(r0z, invX));
+        _mm_store_ps(nm[3], _mm_mul_ps(r1x, invY));
+        _mm_store_ps(nm[4], _mm_mul_ps(r1y, invY));
+        _mm_store_ps(nm[5], _mm_mul_ps(r1z, invY));
+        _mm_store_ps(nm[6], _mm_mul_ps(r2x, invZ));
+        _mm_store_ps(nm[7], _mm_mul_ps(r2y, invZ));
+        _mm_store_ps(nm[8], _mm_mul_ps(r2z, invZ));
+        for (int k = 0; k < 4; ++k) {
+            float* dst = nrm[k];
+            for (int e = 0; e < 9; ++e) dst[e] = nm[e][k];
+        }
+    }
+#endif
+
+    // Scalar tail (or the whole range without SSE)
+    for (; n < count; ++n) {
+        uint32_t i = slots[n];
+        float rx = m_RotX[i] * kDegToRad;
+        float ry = m_RotY[i] * kDegToRad;
+        float rz = m_RotZ[i] * kDegToRad;
+        ComposeScalar(m_PosX[i], m_PosY[i], m_PosZ[i],
+                      std::sin(rx), std::cos(rx), std::sin(ry), std::cos(ry), std::sin(rz), std::cos(rz),
+                      m_ScaleX[i], m_ScaleY[i], m_ScaleZ[i],
+                      m_ParentSlot[i] == kNone ? m_World[i] : m_Local[i],
+                      m_ParentSlot[i] == kNone ? m_Normal[i] : m_LocalNormal[i]);
+    }
+}
@@ -0,0 +1,164 @@
+#pragma once
+#include <cassert>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "transform.h"
+
+class JobSystem;
+
+// Handle to a transform stored in the TransformSystem.
+// The generation makes stale handles (destroyed and reused slots) detectable.
+struct TransformHandle {
+    static constexpr uint32_t kInvalidIndex = 0xFFFFFFFFu;
+
+    uint32_t index = kInvalidIndex;
+    uint32_t generation = 0;
+
+    bool IsValid() const { return index != kInvalidIndex; }
+    bool operator==(const TransformHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const TransformHandle& other) const { return !(*this == other); }
+};
+
+// TransformSystem stores every transform of the scene in structure-of-arrays form:
+// each position/rotation/scale component is its own contiguous float array, and the
+// local/world/normal matrices live in their own arrays.
+//
+// Transforms form a parent/child hierarchy. The SoA arrays are laid out breadth-first
+// ("slots"): roots first, every parent before its children, and the children of a
+// node in one contiguous range. Handles stay stable; a handle -> slot table maps them.
+//
+// Setters only mark the transform dirty. Update() then
+//  1. rebuilds the layout if the hierarchy changed (reusing scratch arrays, so
+//     reparenting does not allocate once capacity is reached),
+//  2. rebuilds the local matrices of dirty transforms in parallel chunks with an SSE
+//     kernel that computes four transforms per iteration (scalar fallback elsewhere),
+//  3. propagates world matrices in one forward pass that visits only the dirty
+//     transforms and their subtrees (no recursion, no full-tree walk).
+class TransformSystem {
+public:
+    explicit TransformSystem(JobSystem* jobs = nullptr);
+
+    void Reserve(size_t count);
+
+    TransformHandle Create(const Transform& local = Transform(), TransformHandle parent = TransformHandle());
+    // Children of a destroyed transform become roots
+    void Destroy(TransformHandle handle);
+    bool IsAlive(TransformHandle handle) const;
+
+    // Local TRS relative to the parent (rotation in degrees, applied X then Y then Z
+    // like Transform::GetModelMatrix). The accessors below take a live handle (asserted);
+    // check IsAlive first when the handle may be stale.
+    Transform GetLocal(TransformHandle handle) const;
+    void SetLocal(TransformHandle handle, const Transform& local);
+
+    glm::vec3 GetPosition(TransformHandle handle) const;
+    glm::vec3 GetRotation(TransformHandle handle) const;
+    glm::vec3 GetScale(TransformHandle handle) const;
+    void SetPosition(TransformHandle handle, const glm::vec3& position);
+    void SetRotation(TransformHandle handle, const glm::vec3& rotation);
+    void SetScale(TransformHandle handle, const glm::vec3& scale);
+
+    // World-space position as of the last Update(); SetWorldPosition converts into parent space
+    glm::vec3 GetWorldPosition(TransformHandle handle) const;
+    void SetWorldPosition(TransformHandle handle, const glm::vec3& position);
+
+    // Hierarchy. Passing an invalid parent makes the transform a root.
+    // Returns false (and changes nothing) if the parent is the node itself or one of its descendants.
+    bool SetParent(TransformHandle child, TransformHandle parent);
+    TransformHandle GetParent(TransformHandle handle) const;
+    TransformHandle GetFirstChild(TransformHandle handle) const;
+    TransformHandle GetNextSibling(TransformHandle handle) const;
+    bool IsDescendantOf(TransformHandle handle, TransformHandle ancestor) const;
+    // Bumped whenever a transform is created, destroyed or reparented (tree views cache on it)
+    uint64_t GetHierarchyVersion() const { return m_HierarchyVersion; }
+
+    // Opaque per-transform value for the owner (e.g. which scene object it belongs to)
+    void SetUserData(TransformHandle handle, uint64_t userData) {
+        assert(IsAlive(handle));
+        m_UserData[handle.index] = userData;
+    }
+    uint64_t GetUserData(TransformHandle handle) const {
+        assert(IsAlive(handle));
+        return m_UserData[handle.index];
+    }
+
+    // Matrices as of the last Update()
+    const glm::mat4& GetWorldMatrix(TransformHandle handle) const {
+        assert(IsAlive(handle));
+        return m_World[m_SlotOfHandle[handle.index]];
+    }
+    const glm::mat3& GetNormalMatrix(TransformHandle handle) const {
+        assert(IsAlive(handle));
+        return m_Normal[m_SlotOfHandle[handle.index]];
+    }
+
+    // Rebuild layout if needed, recompute dirty local matrices and propagate world matrices
+    void Update();
+
+    size_t GetCount() const { return m_Generation.size() - m_FreeHandles.size(); }
+    size_t GetDirtyCount() const { return m_DirtyList.size(); }
+    // Transforms whose world matrix was recomputed by the last Update()
+    size_t GetLastUpdatedCount() const { return m_LastUpdatedCount; }
+
+    // Chunk size used when splitting the local matrix kernel across threads
+    static constexpr size_t kUpdateChunkSize = 4096;
+
+private:
+    static constexpr uint32_t kNone = 0xFFFFFFFFu;
+
+    uint32_t AllocateSlot(uint32_t handleIndex);
+    void MarkDirty(uint32_t handleIndex);
+    void Unlink(uint32_t handleIndex);
+    void RebuildLayout();
+    void GatherDirtySlots();
+    void UpdateLocalRange(const uint32_t* slots, size_t count);
+    void PropagateWorld();
+
+    template <typename T>
+    void Permute(std::vector<T>& data, std::vector<T>& scratch);
+
+    JobSystem* m_Jobs = nullptr;
+
+    // --- Per slot (breadth-first order) ---
+    // SoA local transform data
+    std::vector<float> m_PosX, m_PosY, m_PosZ;
+    std::vector<float> m_RotX, m_RotY, m_RotZ;
+    std::vector<float> m_ScaleX, m_ScaleY, m_ScaleZ;
+    // Cached results (roots skip m_Local/m_LocalNormal: the kernel writes their world matrices directly)
+    std::vector<glm::mat4> m_Local;
+    std::vector<glm::mat3> m_LocalNormal;
+    std::vector<glm::mat4> m_World;
+    std::vector<glm::mat3> m_Normal;
+    // Layout
+    std::vector<uint32_t> m_HandleOfSlot;   // kNone for dead slots
+    std::vector<uint32_t> m_ParentSlot;     // kNone for roots
+    std::vector<uint32_t> m_FirstChildSlot;
+    std::vector<uint32_t> m_ChildCount;
+
+    // --- Per handle index ---
+    std::vector<uint32_t> m_Generation;
+    std::vector<uint8_t> m_Alive;
+    std::vector<uint8_t> m_Dirty;
+    std::vector<uint32_t> m_SlotOfHandle;
+    std::vector<uint32_t> m_ParentHandle;
+    std::vector<uint32_t> m_FirstChildHandle;
+    std::vector<uint32_t> m_NextSiblingHandle;
+    std::vector<uint64_t> m_UserData;
+
+    std::vector<uint32_t> m_FreeHandles;
+    std::vector<uint32_t> m_FreeSlots;
+    std::vector<uint32_t> m_DirtyList;      // handle indices
+    bool m_LayoutDirty = false;
+    uint64_t m_HierarchyVersion = 0;
+
+    // Update() scratch, kept between frames so steady-state updates don't allocate
+    std::vector<uint32_t> m_DirtySlots;     // every dirty slot, ascending
+    std::vector<uint32_t> m_ChildRanges;    // propagation queue of [begin, end) pairs
+    std::vector<uint32_t> m_Order;          // RebuildLayout: handle indices in new slot order
+    std::vector<uint32_t> m_NewToOld;
+    std::vector<float> m_ScratchFloat;
+    std::vector<glm::mat4> m_ScratchMat4;
+    std::vector<glm::mat3> m_ScratchMat3;
+    size_t m_LastUpdatedCount = 0;
+};